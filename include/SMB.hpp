@@ -37,9 +37,18 @@
 
 #include "cfg.hpp"
 #include "timeSim.hpp"
+#include "instrumentation.hpp"
 
 #define BEAM_ID_START 1000
 
+//! relative cost of fields calculation per cell, compared
+//! to push and current deposition of single macroparticle.
+//! Used to estimate load for ``load'' domains partitioning
+#define PARTITION_CELL_COST 0.1
+
+//! minimal domain size (in cells) for ``load'' domains partitioning
+#define PARTITION_MIN_CELLS 4
+
 #ifdef ENABLE_MPI
 #if SIZE_MAX == UCHAR_MAX
    #define MPI_SIZE_T MPI_UNSIGNED_CHAR
@@ -182,6 +191,13 @@ public:
   unsigned int r_domains;
   unsigned int z_domains;
 
+  size_t window_shift; // amount of cells, moving window is shifted by
+
+  //! borders of domains in cells, local for SMB
+  //! (r_domains + 1 and z_domains + 1 values)
+  vector<size_t> r_bounds;
+  vector<size_t> z_bounds;
+
 private:
   Geometry *geometry;
   Cfg *cfg;
@@ -190,11 +206,11 @@ private:
   int world_size;
 
 public:
-  SMB ( void ) {};
+  SMB ( void ) : r_domains(0), z_domains(0), window_shift(0) {};
   SMB ( Cfg* _cfg, Geometry *_geometry, TimeSim *_time,
         int _world_rank, int _world_size);
 
-  ~SMB( void ) {};
+  ~SMB( void );
 
 // private:
   void particles_runaway_collector ();
@@ -207,6 +223,26 @@ public:
   void solve_current();
   void advance_particles();
   void inject_beam();
+  void advance_step();
   void distribute();
+  void move_window();
+  void restore_window();
+  void resample_particles();
+
+private:
+  void field_e_overlay_domain (unsigned int i, unsigned int j);
+  void field_h_overlay_domain (unsigned int i, unsigned int j);
+  void current_overlay_domain (unsigned int i, unsigned int j);
+#ifdef ENABLE_MPI
+  void field_e_overlay_mpi ();
+  void field_h_overlay_mpi ();
+  void current_overlay_mpi ();
+#endif // ENABLE_MPI
+  void advance_particles_domain (unsigned int i, unsigned int j);
+
+  size_t window_target_shift();
+  void partition();
+  unsigned int domain_r_number(int r_cell);
+  unsigned int domain_z_number(int z_cell);
 };
 #endif // end of _SMB_HPP_
@@ -41,18 +41,17 @@
 #include "msg.hpp"
 
 #include "algo/grid.hpp"
+#include "algo/simd.hpp"
 #include "constant.hpp"
 
 using namespace std;
 
 namespace algo::common
 {
-  double sqrt_recip (float x);
   bool to_bool (string str);
   std::string get_simulation_duration ();
   bool directory_exists (const std::string& path);
   bool make_directory (const std::string& path);
-  double sq_rt (double x);
   char *get_cmd_option (char **begin, char **end, const std::string &option);
   bool cmd_option_exists (char **begin, char **end, const std::string &option);
   std::vector<double> read_file_to_double (const char *filename);
@@ -60,6 +59,14 @@ namespace algo::common
                  std::vector<std::string> &out);
   unsigned int nearest_divide (unsigned int number, double what);
   unsigned short hash_from_string(const std::string& str, unsigned short salt);
+  std::vector<size_t> balanced_partition (const std::vector<double> &load, unsigned int parts,
+                                          unsigned int min_size, unsigned int alignment);
+
+  //! inline, so it does not cost function call in particles loops
+  inline double sq_rt (double x)
+  {
+    return algo::simd::sqrt(x);
+  }
 
   // template is workaround, because c++ does not see Grid class template
   // from inside of custom namespace (for unknown reason)
@@ -18,6 +18,9 @@
 #ifndef _GRID_HPP_
 #define _GRID_HPP_
 
+#include <cstring>
+#include <type_traits>
+
 #include "defines.hpp"
 #include "msg.hpp"
 
@@ -25,6 +28,7 @@ template <class T>
 class Grid
 {
   T **grid;
+  T **rows; // allocated rows. Grid rows could be shifted relative to them
 
 private:
   // unsigned int o_s; // overlay shift
@@ -41,6 +45,9 @@ public:
   unsigned int x_size;
   unsigned int y_size;
 
+  unsigned int y_shift; // current shift of grid rows relative to allocated ones
+  unsigned int y_reserve; // extra allocated elements per row for shifting
+
 public:
   Grid() {};
   Grid(unsigned int x_amount, unsigned int y_amount, unsigned int overlay_shift)
@@ -53,8 +60,15 @@ public:
     y_size = y_amount;
 
     grid = new T *[x_real_size];
+    rows = new T *[x_real_size];
     for (unsigned int i = 0; i < x_real_size; i++)
-      grid[i] = new T[y_real_size];
+    {
+      rows[i] = new T[y_real_size];
+      grid[i] = rows[i];
+    }
+
+    y_shift = 0;
+    y_reserve = 0;
   };
 
   void set(unsigned int x, unsigned int y, T value)
@@ -86,21 +100,54 @@ public:
 
   void overlay_set(T value)
   {
-    // unsigned int j = 0;
+    // only overlay elements are visited: whole first and last
+    // rows and edges of the rest of them
     for (unsigned int i = 0; i < x_real_size; ++i)
-      for (unsigned int j = 0; j < y_real_size; ++j)
-        if (i < o_s || j < o_s
-            ||
-            i >= x_real_size - o_s || j >= y_real_size - o_s
-          )
+      if (i < o_s || i >= x_real_size - o_s)
+        for (unsigned int j = 0; j < y_real_size; ++j)
           grid[i][j] = value;
+      else
+        for (unsigned int d = 0; d < o_s; ++d)
+        {
+          grid[i][d] = value;
+          grid[i][y_real_size - 1 - d] = value;
+        }
+  };
+
+  void zero()
+  // set all of the elements, including overlay, to zero
+  // row-by-row with memset
+  {
+    static_assert(std::is_arithmetic<T>::value, "zero: grid of non-arithmetic type");
+
+    for (unsigned int i = 0; i < x_real_size; ++i)
+      memset(grid[i], 0, sizeof(T) * y_real_size);
+  };
+
+  void zero(int x_begin, int x_end, int y_begin, int y_end)
+  // set [x_begin, x_end] x [y_begin, y_end] elements (overlay
+  // elements are negative or not less, than size) to zero
+  {
+    static_assert(std::is_arithmetic<T>::value, "zero: grid of non-arithmetic type");
+
+    for (int i = x_begin; i <= x_end; ++i)
+      memset(&grid[i+o_s][y_begin+o_s], 0, sizeof(T) * (y_end - y_begin + 1));
   };
 
   void overlay_y(Grid<T> rhsgrid)
   {
+    overlay_y(rhsgrid, 0, x_size - 1);
+  };
+
+  void overlay_y(Grid<T> rhsgrid, int x_begin, int x_end)
+  // overlay only [x_begin, x_end] rows (overlay ones are skipped)
+  {
+    unsigned int begin = x_begin > 0 ? x_begin + o_s : o_s;
+    unsigned int end = x_end < (int)x_size - 1 ? x_end + o_s + 1 : x_real_size - o_s;
+
     if (x_real_size == rhsgrid.x_real_size)
       for (unsigned int d = 0; d < o_s; ++d)
-        for (unsigned int i = o_s; i < x_real_size - o_s; ++i)
+        for (unsigned int i = begin; i < end; ++i)
         {
           rhsgrid.grid[i][2*o_s-d-1] += grid[i][y_real_size-1-d];
           grid[i][y_real_size-2*o_s+d] += rhsgrid.grid[i][d];
@@ -116,9 +163,18 @@ public:
 
   void overlay_x(Grid<T> rhsgrid)
   {
+    overlay_x(rhsgrid, 0, y_size - 1);
+  };
+
+  void overlay_x(Grid<T> rhsgrid, int y_begin, int y_end)
+  // overlay only [y_begin, y_end] columns (overlay ones are skipped)
+  {
+    unsigned int begin = y_begin > 0 ? y_begin + o_s : o_s;
+    unsigned int end = y_end < (int)y_size - 1 ? y_end + o_s + 1 : y_real_size - o_s;
+
     if (y_real_size == rhsgrid.y_real_size)
       for (unsigned int d = 0; d < o_s; ++d)
-        for (unsigned int i = o_s; i < y_real_size - o_s; ++i)
+        for (unsigned int i = begin; i < end; ++i)
         {
           rhsgrid.grid[2*o_s-d-1][i] += grid[x_real_size-1-d][i];
           grid[x_real_size-2*o_s+d][i] += rhsgrid.grid[d][i];
@@ -133,21 +189,18 @@ public:
   };
 
   void overlay_xy(Grid<T> rhsgrid)
+  // only corners are overlaid, so diagonal
+  // neighbour could have different size
   {
-    if (x_real_size == rhsgrid.x_real_size && y_real_size == rhsgrid.y_real_size)
-      for (unsigned int d = 0; d < o_s; ++d)
-        for (unsigned int e = 0; e < o_s; ++e)
-        {
-          rhsgrid.grid[2*o_s-d-1][2*o_s-e-1] += grid[x_real_size-1-d][x_real_size-1-e];
-          grid[x_real_size-2*o_s+d][x_real_size-2*o_s+e] += rhsgrid.grid[d][e];
-
-          rhsgrid.grid[d][e] = grid[y_real_size-2*o_s+d][y_real_size-2*o_s+e];
-          grid[x_real_size-1-d][x_real_size-1-e] = rhsgrid.grid[2*o_s-1-d][2*o_s-1-e];
-        }
-    else
-    {
-      LOG_S(FATAL) << "overlay_xy: X or Y sizes of bottom-left and top-right grid are not equal. Can not overlay";
-    }
+    for (unsigned int d = 0; d < o_s; ++d)
+      for (unsigned int e = 0; e < o_s; ++e)
+      {
+        rhsgrid.grid[2*o_s-d-1][2*o_s-e-1] += grid[x_real_size-1-d][y_real_size-1-e];
+        grid[x_real_size-2*o_s+d][y_real_size-2*o_s+e] += rhsgrid.grid[d][e];
+
+        rhsgrid.grid[d][e] = grid[x_real_size-2*o_s+d][y_real_size-2*o_s+e];
+        grid[x_real_size-1-d][y_real_size-1-e] = rhsgrid.grid[2*o_s-1-d][2*o_s-1-e];
+      }
   };
 
   void copy(Grid<T> rhs)
@@ -161,6 +214,77 @@ public:
       LOG_S(FATAL) << "overlay_xy: X or Y sizes of bottom-left and top-right grid are not equal. Can not overlay";
   };
 
+  void reserve_shift_y(unsigned int reserve)
+  // allocate ``reserve'' extra elements per row, so grid could
+  // be shifted by shift_y ``reserve'' times without copying
+  {
+    for (unsigned int i = 0; i < x_real_size; ++i)
+    {
+      T *row = new T[y_real_size + reserve];
+      for (unsigned int j = 0; j < y_real_size; ++j)
+        row[j] = grid[i][j];
+
+      delete[] rows[i];
+      rows[i] = row;
+      grid[i] = row;
+    }
+
+    y_shift = 0;
+    y_reserve = reserve;
+  };
+
+  void shift_y()
+  // shift grid by one cell in y direction: grid(x, y) = grid(x, y + 1).
+  // Rows are shifted by offset, so data is copied back to the begining
+  // of allocated rows only once per ``y_reserve'' shifts.
+  // New last element of rows (in overlay) is zeroed
+  {
+    for (unsigned int i = 0; i < x_real_size; ++i)
+    {
+      if (y_shift < y_reserve)
+        ++grid[i];
+      else
+      {
+        for (unsigned int j = 0; j < y_real_size - 1; ++j)
+          rows[i][j] = grid[i][j + 1];
+        grid[i] = rows[i];
+      }
+      grid[i][y_real_size - 1] = 0;
+    }
+
+    y_shift = y_shift < y_reserve ? y_shift + 1 : 0;
+  };
+
+  void copy_next_y(Grid<T> rhsgrid)
+  // copy first column of next (in y direction) grid
+  // to the right overlay, so it is shifted in by shift_y
+  {
+    if (x_real_size == rhsgrid.x_real_size)
+      for (unsigned int i = 0; i < x_real_size; ++i)
+        grid[i][y_real_size - o_s] = rhsgrid.grid[i][o_s];
+    else
+      LOG_S(FATAL) << "copy_next_y: X sizes of left and right grid are not equal. Can not copy";
+  };
+
+  void clear_next_y()
+  // clear column of right overlay, which is shifted in by shift_y
+  // (there is no next grid in y direction)
+  {
+    for (unsigned int i = 0; i < x_real_size; ++i)
+      grid[i][y_real_size - o_s] = 0;
+  };
+
+  void add(Grid<T> rhs)
+  // add rhs grid to current grid element-by-element, including overlay
+  {
+    if (x_real_size == rhs.x_real_size && y_real_size == rhs.y_real_size)
+      for (unsigned int i = 0; i < x_real_size; ++i)
+        for (unsigned int j = 0; j < y_real_size; ++j)
+          grid[i][j] += rhs.grid[i][j];
+    else
+      LOG_S(FATAL) << "add: X or Y sizes of grids are not equal. Can not add";
+  };
+
   // operators overloading
   T& operator() (unsigned int x, unsigned int y)
   {
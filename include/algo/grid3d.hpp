@@ -47,6 +47,13 @@ public:
     z_component.overlay_x(rgrid.z_component);
   };
 
+  void overlay_x(Grid3D<T> rgrid, int y_begin, int y_end)
+  {
+    r_component.overlay_x(rgrid.r_component, y_begin, y_end);
+    phi_component.overlay_x(rgrid.phi_component, y_begin, y_end);
+    z_component.overlay_x(rgrid.z_component, y_begin, y_end);
+  };
+
   void overlay_y(Grid3D<T> rgrid)
   {
     r_component.overlay_y(rgrid.r_component);
@@ -54,6 +61,13 @@ public:
     z_component.overlay_y(rgrid.z_component);
   };
 
+  void overlay_y(Grid3D<T> rgrid, int x_begin, int x_end)
+  {
+    r_component.overlay_y(rgrid.r_component, x_begin, x_end);
+    phi_component.overlay_y(rgrid.phi_component, x_begin, x_end);
+    z_component.overlay_y(rgrid.z_component, x_begin, x_end);
+  };
+
   void overlay_xy(Grid3D<T> trgrid)
   {
     r_component.overlay_xy(trgrid.r_component);
@@ -68,6 +82,55 @@ public:
     z_component.overlay_set(value);
   };
 
+  void zero()
+  {
+    r_component.zero();
+    phi_component.zero();
+    z_component.zero();
+  };
+
+  void zero(int x_begin, int x_end, int y_begin, int y_end)
+  {
+    r_component.zero(x_begin, x_end, y_begin, y_end);
+    phi_component.zero(x_begin, x_end, y_begin, y_end);
+    z_component.zero(x_begin, x_end, y_begin, y_end);
+  };
+
+  void reserve_shift_y(unsigned int reserve)
+  {
+    r_component.reserve_shift_y(reserve);
+    phi_component.reserve_shift_y(reserve);
+    z_component.reserve_shift_y(reserve);
+  };
+
+  void shift_y()
+  {
+    r_component.shift_y();
+    phi_component.shift_y();
+    z_component.shift_y();
+  };
+
+  void copy_next_y(Grid3D<T> rgrid)
+  {
+    r_component.copy_next_y(rgrid.r_component);
+    phi_component.copy_next_y(rgrid.phi_component);
+    z_component.copy_next_y(rgrid.z_component);
+  };
+
+  void clear_next_y()
+  {
+    r_component.clear_next_y();
+    phi_component.clear_next_y();
+    z_component.clear_next_y();
+  };
+
+  void add(Grid3D<T> rgrid)
+  {
+    r_component.add(rgrid.r_component);
+    phi_component.add(rgrid.phi_component);
+    z_component.add(rgrid.z_component);
+  };
+
   Grid3D<T>& operator= (const T value)
   {
     r_component = value;
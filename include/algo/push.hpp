@@ -0,0 +1,214 @@
+/*
+ * This file is part of the PiCoPiC distribution (https://github.com/cosmonaut-ok/PiCoPiC).
+ * Copyright (c) 2020 Alexander Vynnyk.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _PUSH_HPP_
+#define _PUSH_HPP_
+
+#include <cstddef>
+
+#include "constant.hpp"
+#include "algo/simd.hpp"
+
+//! amount of particles, which are pushed at once
+#define PUSH_BATCH_SIZE 256
+
+//! Relativistic particles push in batches: momentums of particles
+//! and fields at their positions are gathered to SoA buffer, new
+//! momentums of all particles are calculated in single branchless
+//! loop, vectorized with "omp simd", and scattered back after that.
+//! Kernels repeat scalar pushers operation by operation, so results
+//! are the same, as for particle-by-particle push
+namespace algo::push
+{
+  //! momentums per unit mass (gamma * v) of particles and
+  //! electric and magnetic fields at particles positions
+  struct Batch
+  {
+    size_t size = 0;
+
+    double u[3][PUSH_BATCH_SIZE];
+    double e[3][PUSH_BATCH_SIZE];
+    double b[3][PUSH_BATCH_SIZE];
+
+    void add (double u_r, double u_phi, double u_z,
+              double e_r, double e_phi, double e_z,
+              double b_r, double b_phi, double b_z)
+    {
+      u[0][size] = u_r;
+      u[1][size] = u_phi;
+      u[2][size] = u_z;
+      e[0][size] = e_r;
+      e[1][size] = e_phi;
+      e[2][size] = e_z;
+      b[0][size] = b_r;
+      b[1][size] = b_phi;
+      b[2][size] = b_z;
+      ++size;
+    }
+
+    bool full ()
+    {
+      return size == PUSH_BATCH_SIZE;
+    }
+  };
+
+  //! velocities in batch (should be less, than speed
+  //! of light) to momentums per unit mass
+  inline void velocity_to_momentum (Batch &b)
+  {
+#pragma omp simd
+    for (size_t n = 0; n < b.size; ++n)
+    {
+      double sq_vel = b.u[0][n] * b.u[0][n] + b.u[1][n] * b.u[1][n] + b.u[2][n] * b.u[2][n];
+      double gamma = simd::rsqrt(1.0 - sq_vel / constant::LIGHT_VEL_POW_2);
+
+      b.u[0][n] *= gamma;
+      b.u[1][n] *= gamma;
+      b.u[2][n] *= gamma;
+    }
+  }
+
+  //! momentums per unit mass in batch to velocities
+  inline void momentum_to_velocity (Batch &b)
+  {
+#pragma omp simd
+    for (size_t n = 0; n < b.size; ++n)
+    {
+      double sq_mom = b.u[0][n] * b.u[0][n] + b.u[1][n] * b.u[1][n] + b.u[2][n] * b.u[2][n];
+      double gamma_inv = simd::rsqrt(1.0 + sq_mom / constant::LIGHT_VEL_POW_2);
+
+      b.u[0][n] *= gamma_inv;
+      b.u[1][n] *= gamma_inv;
+      b.u[2][n] *= gamma_inv;
+    }
+  }
+
+  //! Vay pusher (see Vay, Phys. Plasmas 15, 2008)
+  inline void vay (Batch &b, double charge_over_2mass_dt)
+  {
+    double e_factor = 2. * charge_over_2mass_dt;
+    double b_factor = charge_over_2mass_dt * constant::MAGN_CONST;
+
+#pragma omp simd
+    for (size_t n = 0; n < b.size; ++n)
+    {
+      double u_0 = b.u[0][n], u_1 = b.u[1][n], u_2 = b.u[2][n];
+      double b_0 = b.b[0][n] * b_factor;
+      double b_1 = b.b[1][n] * b_factor;
+      double b_2 = b.b[2][n] * b_factor;
+
+      //
+      // Part I: Computation of uprime
+      //
+
+      // add electric field
+      double up_0 = u_0 + b.e[0][n] * e_factor;
+      double up_1 = u_1 + b.e[1][n] * e_factor;
+      double up_2 = u_2 + b.e[2][n] * e_factor;
+
+      // add magnetic field
+      double sq_mom = u_0 * u_0 + u_1 * u_1 + u_2 * u_2;
+      double gamma_inv = simd::rsqrt(1.0 + sq_mom / constant::LIGHT_VEL_POW_2);
+
+      up_0 += gamma_inv * (u_1 * b_2 - u_2 * b_1);
+      up_1 += gamma_inv * (u_2 * b_0 - u_0 * b_2);
+      up_2 += gamma_inv * (u_0 * b_1 - u_1 * b_0);
+
+      // alpha is gamma^2
+      double alpha = 1. + (up_0 * up_0 + up_1 * up_1 + up_2 * up_2);
+      double B2 = b_0 * b_0 + b_1 * b_1 + b_2 * b_2;
+
+      //
+      // Part II: Computation of Gamma^{i+1}
+      //
+
+      // s is sigma
+      double s = alpha - B2;
+      double us2 = up_0 * b_0 + up_1 * b_1 + up_2 * b_2;
+      us2 *= us2;
+
+      // alpha becomes 1/gamma^{i+1}
+      alpha = simd::rsqrt(0.5 * (s + simd::sqrt(s * s + 4. * (B2 + us2))));
+
+      b_0 *= alpha;
+      b_1 *= alpha;
+      b_2 *= alpha;
+
+      s = 1. / (1. + (b_0 * b_0 + b_1 * b_1 + b_2 * b_2));
+      alpha = up_0 * b_0 + up_1 * b_1 + up_2 * b_2;
+
+      b.u[0][n] = s * (up_0 + alpha * b_0 + b_2 * up_1 - b_1 * up_2);
+      b.u[1][n] = s * (up_1 + alpha * b_1 + b_0 * up_2 - b_2 * up_0);
+      b.u[2][n] = s * (up_2 + alpha * b_2 + b_1 * up_0 - b_0 * up_1);
+    }
+  }
+
+  //! Higuera-Cary pusher (see Higuera and Cary, Phys. Plasmas 24, 2017)
+  inline void higuera_cary (Batch &b, double charge_over_2mass_dt)
+  {
+    double b_factor = charge_over_2mass_dt * constant::MAGN_CONST;
+
+#pragma omp simd
+    for (size_t n = 0; n < b.size; ++n)
+    {
+      // init half-acceleration in the electric field
+      double psm_0 = b.e[0][n] * charge_over_2mass_dt;
+      double psm_1 = b.e[1][n] * charge_over_2mass_dt;
+      double psm_2 = b.e[2][n] * charge_over_2mass_dt;
+
+      double um_0 = b.u[0][n] + psm_0;
+      double um_1 = b.u[1][n] + psm_1;
+      double um_2 = b.u[2][n] + psm_2;
+
+      // intermediate gamma factor: only this part differs from the Boris scheme.
+      // Square gamma factor from um
+      double gfm2 = 1. + (um_0 * um_0 + um_1 * um_1 + um_2 * um_2);
+
+      double b_0 = b.b[0][n] * b_factor;
+      double b_1 = b.b[1][n] * b_factor;
+      double b_2 = b.b[2][n] * b_factor;
+      double B2 = b_0 * b_0 + b_1 * b_1 + b_2 * b_2;
+
+      // equivalent of 1/\gamma_{new} in the paper
+      double s = gfm2 - B2;
+      double bu = b_0 * um_0 + b_1 * um_1 + b_2 * um_2;
+      double gamma = simd::rsqrt(0.5 * (s + simd::sqrt(s * s + 4.0 * (B2 + bu * bu))));
+
+      b_0 *= gamma;
+      b_1 *= gamma;
+      b_2 *= gamma;
+
+      double b2_0 = b_0 * b_0, b2_1 = b_1 * b_1, b2_2 = b_2 * b_2;
+      double b_cross_0 = b_0 * b_1, b_cross_1 = b_1 * b_2, b_cross_2 = b_2 * b_0;
+      double inv_det_B = 1.0 / (1.0 + b2_0 + b2_1 + b2_0);
+
+      double up_0 = ((1.0 + b2_0 - b2_1 - b2_2) * um_0 + 2. * (b_cross_0 + b_2)
+                     * um_1 + 2. * (b_cross_2 - b_2) * um_2) * inv_det_B;
+      double up_1 = (2. * (b_cross_0 - b_2) * um_0 + (1. - b2_0 + b2_1 - b2_2)
+                     * um_1 + 2. * (b_cross_1 + b_0) * um_2) * inv_det_B;
+      double up_2 = (2. * (b_cross_2 + b_1) * um_0 + 2. * (b_cross_1 - b_0)
+                     * um_1 + (1. - b2_0 - b2_1 + b2_2) * um_2) * inv_det_B;
+
+      // finalize half-acceleration in the electric field
+      b.u[0][n] = psm_0 + up_0;
+      b.u[1][n] = psm_1 + up_1;
+      b.u[2][n] = psm_2 + up_2;
+    }
+  }
+}
+
+#endif // end of _PUSH_HPP_
@@ -0,0 +1,284 @@
+/*
+ * This file is part of the PiCoPiC distribution (https://github.com/cosmonaut-ok/PiCoPiC).
+ * Copyright (c) 2020 Alexander Vynnyk.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _RESAMPLER_HPP_
+#define _RESAMPLER_HPP_
+
+#include <math.h>
+#include <vector>
+#include <algorithm>
+
+#include "defines.hpp"
+#include "constant.hpp"
+
+//! macroparticles resampling inside single cell.
+//! Particles are given as vector of pointers to particles
+//! of the same specie, placed in the same cell.
+//! Vector is updated with result of resampling: merged
+//! particles are deleted, split ones are allocated with new
+namespace algo::resampler
+{
+  //! velocity space octant of particle: groups of particles to
+  //! merge are taken from the same octant, so merged particles
+  //! have close directions of velocity
+  template <class P>
+  unsigned int velocity_octant(P *p)
+  {
+    return (p->vel_r < 0 ? 1 : 0)
+      + (p->vel_phi < 0 ? 2 : 0)
+      + (p->vel_z < 0 ? 4 : 0);
+  }
+
+  template <class P>
+  double velocity_sq(P *p)
+  {
+    double v_r = p->vel_r;
+    double v_phi = p->vel_phi;
+    double v_z = p->vel_z;
+
+    return v_r * v_r + v_phi * v_phi + v_z * v_z;
+  }
+
+  //! Lorentz factor of particle. Also returns factor, converting
+  //! stored velocity components of particle to momentum per unit
+  //! mass (gamma * v). Momentum is stored as is with ENABLE_MOMENTUM
+  template <class P>
+  double lorenz_factor(P *p, double &to_momentum)
+  {
+#ifdef ENABLE_MOMENTUM
+    to_momentum = 1.;
+    return sqrt(1. + velocity_sq(p) / constant::LIGHT_VEL_POW_2);
+#else
+    to_momentum = 1. / sqrt(1. - velocity_sq(p) / constant::LIGHT_VEL_POW_2);
+    return to_momentum;
+#endif
+  }
+
+  //! merge group of particles to two particles of equal weights,
+  //! conserving total weight (charge), relativistic momentum and
+  //! kinetic energy of the group (see Vranic et al, CPC 191, 2015).
+  //! Merged particles are placed to the weight center of the group
+  //! and written to group[0] and group[1]. Other particles of the
+  //! group are not changed and should be removed by caller
+  template <class P>
+  void merge_group(P **group, size_t size)
+  {
+    double weight = 0;
+    double pos_r = 0, pos_z = 0;
+    double u[3] = {0, 0, 0}; // total momentum (gamma * v)
+    double kinetic = 0; // total kinetic energy, (gamma - 1)
+
+    for (size_t n = 0; n < size; ++n)
+    {
+      P *p = group[n];
+      double w = p->weight;
+      double v_sq = velocity_sq(p);
+      double to_u;
+      double gamma = lorenz_factor(p, to_u);
+
+      weight += w;
+      pos_r += w * (double)p->pos_r;
+      pos_z += w * (double)p->pos_z;
+      u[0] += w * to_u * p->vel_r;
+      u[1] += w * to_u * p->vel_phi;
+      u[2] += w * to_u * p->vel_z;
+      // (gamma - 1) without cancellation for slow particles
+      kinetic += w * to_u * to_u * v_sq / constant::LIGHT_VEL_POW_2 / (gamma + 1);
+    }
+
+    if (weight <= 0)
+      return;
+
+    pos_r /= weight;
+    pos_z /= weight;
+    kinetic /= weight;
+
+    double u_mean[3] = {u[0] / weight, u[1] / weight, u[2] / weight};
+    double u_mean_sq = u_mean[0] * u_mean[0] + u_mean[1] * u_mean[1] + u_mean[2] * u_mean[2];
+
+    // both of new particles have mean energy of the group,
+    // so their momentums have the same absolute value
+    double u_sq = constant::LIGHT_VEL_POW_2 * kinetic * (kinetic + 2);
+    double delta = sqrt(fmax(u_sq - u_mean_sq, 0));
+
+    // factor, converting momentum to stored velocity components
+#ifdef ENABLE_MOMENTUM
+    double from_u = 1.;
+#else
+    double from_u = kinetic + 1; // gamma
+#endif
+
+    // momentums of new particles are deflected from mean momentum
+    // in opposite directions. Deflection direction is taken from
+    // momentum of first particle, to keep spread of the group
+    double e[3];
+    {
+      double to_u;
+      lorenz_factor(group[0], to_u);
+      e[0] = to_u * group[0]->vel_r - u_mean[0];
+      e[1] = to_u * group[0]->vel_phi - u_mean[1];
+      e[2] = to_u * group[0]->vel_z - u_mean[2];
+    }
+
+    for (unsigned int attempt = 0; attempt < 2; ++attempt)
+    {
+      // exclude component, parallel to mean momentum
+      if (u_mean_sq > 0)
+      {
+        double proj = (e[0] * u_mean[0] + e[1] * u_mean[1] + e[2] * u_mean[2]) / u_mean_sq;
+        for (unsigned int c = 0; c < 3; ++c)
+          e[c] -= proj * u_mean[c];
+      }
+
+      double e_len = sqrt(e[0] * e[0] + e[1] * e[1] + e[2] * e[2]);
+
+      if (e_len > 0 && e_len > 1e-12 * sqrt(u_mean_sq))
+      {
+        for (unsigned int c = 0; c < 3; ++c)
+          e[c] /= e_len;
+        break;
+      }
+
+      // first particle moves along mean momentum: take axis,
+      // the most perpendicular to mean momentum
+      unsigned int axis = 0;
+      for (unsigned int c = 1; c < 3; ++c)
+        if (fabs(u_mean[c]) < fabs(u_mean[axis]))
+          axis = c;
+
+      e[0] = e[1] = e[2] = 0;
+      e[axis] = 1;
+    }
+
+    for (unsigned int n = 0; n < 2; ++n)
+    {
+      P *p = group[n];
+      double sign = n == 0 ? 1 : -1;
+
+      p->pos_r = pos_r;
+      p->pos_phi = 0;
+      p->pos_z = pos_z;
+      p->pos_old_r = pos_r;
+      p->pos_old_phi = 0;
+      p->pos_old_z = pos_z;
+
+      p->vel_r = (u_mean[0] + sign * delta * e[0]) / from_u;
+      p->vel_phi = (u_mean[1] + sign * delta * e[1]) / from_u;
+      p->vel_z = (u_mean[2] + sign * delta * e[2]) / from_u;
+
+      p->weight = weight / 2;
+      p->sin = 0;
+    }
+  }
+
+  //! merge particles of the cell to about ``target'' particles.
+  //! Particles are sorted by velocity octant and absolute value
+  //! of velocity, and each run of particles with close velocities
+  //! is merged to pairs
+  template <class P>
+  void merge_cell(std::vector<P*> &cell, unsigned int target)
+  {
+    size_t groups_amount = target / 2 > 0 ? target / 2 : 1;
+    size_t group_size = (cell.size() + groups_amount - 1) / groups_amount;
+
+    // merging of less, than 3 particles does not reduce their amount
+    if (group_size < 3)
+      return;
+
+    std::sort(cell.begin(), cell.end(),
+              [](P *a, P *b)
+              {
+                unsigned int o_a = velocity_octant(a);
+                unsigned int o_b = velocity_octant(b);
+                return o_a < o_b || (o_a == o_b && velocity_sq(a) < velocity_sq(b));
+              });
+
+    std::vector<P*> merged;
+    merged.reserve(target + 16);
+
+    size_t run_begin = 0;
+    while (run_begin < cell.size())
+    {
+      size_t run_end = run_begin + 1;
+      unsigned int octant = velocity_octant(cell[run_begin]);
+
+      while (run_end < cell.size() && velocity_octant(cell[run_end]) == octant)
+        ++run_end;
+
+      for (size_t begin = run_begin; begin < run_end; begin += group_size)
+      {
+        size_t end = std::min(begin + group_size, run_end);
+
+        if (end - begin < 3)
+        {
+          for (size_t n = begin; n < end; ++n)
+            merged.push_back(cell[n]);
+          continue;
+        }
+
+        merge_group(&cell[begin], end - begin);
+
+        merged.push_back(cell[begin]);
+        merged.push_back(cell[begin + 1]);
+
+        for (size_t n = begin + 2; n < end; ++n)
+          delete cell[n];
+      }
+
+      run_begin = run_end;
+    }
+
+    cell.swap(merged);
+  }
+
+  //! split the heaviest particles of the cell to pairs of halved
+  //! weight, until amount of particles reaches ``target''. Pair is
+  //! displaced symmetrically along z, inside the cell [z_left, z_right),
+  //! so charge, momentum, energy and weight center are conserved
+  template <class P>
+  void split_cell(std::vector<P*> &cell, unsigned int target,
+                  double z_left, double z_right)
+  {
+    double max_shift = (z_right - z_left) / 8;
+
+    while (cell.size() < target && ! cell.empty())
+    {
+      P *p = *std::max_element(cell.begin(), cell.end(),
+                               [](P *a, P *b) { return a->weight < b->weight; });
+
+      double pos_z = p->pos_z;
+      double shift = std::min({max_shift, (pos_z - z_left) / 2, (z_right - pos_z) / 2});
+
+      // particle is on the cell border, can not split it inside the cell
+      if (shift <= 0)
+        break;
+
+      P *clone = new P(*p);
+
+      p->weight = p->weight / 2;
+      clone->weight = p->weight;
+
+      p->pos_z = pos_z - shift;
+      p->pos_old_z = pos_z - shift;
+      clone->pos_z = pos_z + shift;
+      clone->pos_old_z = pos_z + shift;
+
+      cell.push_back(clone);
+    }
+  }
+}
+#endif // end of _RESAMPLER_HPP_
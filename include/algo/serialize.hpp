@@ -0,0 +1,142 @@
+/*
+ * This file is part of the PiCoPiC distribution (https://github.com/cosmonaut-ok/PiCoPiC).
+ * Copyright (c) 2020 Alexander Vynnyk.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _SERIALIZE_HPP_
+#define _SERIALIZE_HPP_
+
+#include <vector>
+#include <cstring>
+
+#include "algo/grid.hpp"
+
+//! binary serialization of simulation state to/from raw buffer
+//! (used by checkpoint). Every ``put'' function writes value to
+//! buffer and moves buffer pointer after it, ``get'' reads value
+//! and moves pointer the same way. ``*_size'' functions return
+//! amount of bytes, required to store value
+namespace algo::serialize
+{
+  template <class T>
+  void put(char *&_buffer, const T &_value)
+  {
+    memcpy(_buffer, &_value, sizeof(T));
+    _buffer += sizeof(T);
+  }
+
+  template <class T>
+  void get(const char *&_buffer, T &_value)
+  {
+    memcpy(&_value, _buffer, sizeof(T));
+    _buffer += sizeof(T);
+  }
+
+  //! vector is stored as it's length, followed by elements
+  template <class T>
+  size_t vector_size(const std::vector<T> &_vector)
+  {
+    return sizeof(size_t) + sizeof(T) * _vector.size();
+  }
+
+  template <class T>
+  void put_vector(char *&_buffer, const std::vector<T> &_vector)
+  {
+    put(_buffer, _vector.size());
+    if (! _vector.empty())
+      memcpy(_buffer, _vector.data(), sizeof(T) * _vector.size());
+    _buffer += sizeof(T) * _vector.size();
+  }
+
+  template <class T>
+  void get_vector(const char *&_buffer, std::vector<T> &_vector)
+  {
+    size_t length;
+    get(_buffer, length);
+    _vector.resize(length);
+    if (length > 0)
+      memcpy(_vector.data(), _buffer, sizeof(T) * length);
+    _buffer += sizeof(T) * length;
+  }
+
+  //! grid is stored as rows of real (including overlay) size.
+  //! Rows are copied by grid pointers, so grid, shifted by
+  //! moving window, is stored in it's current (shifted) state
+  template <class T>
+  size_t grid_size(Grid<T> &_grid)
+  {
+    return sizeof(T) * _grid.x_real_size * _grid.y_real_size;
+  }
+
+  template <class T>
+  void put_grid(char *&_buffer, Grid<T> &_grid)
+  {
+    T **grid = _grid.get_grid();
+    for (size_t i = 0; i < _grid.x_real_size; ++i)
+    {
+      memcpy(_buffer, grid[i], sizeof(T) * _grid.y_real_size);
+      _buffer += sizeof(T) * _grid.y_real_size;
+    }
+  }
+
+  template <class T>
+  void get_grid(const char *&_buffer, Grid<T> &_grid)
+  {
+    T **grid = _grid.get_grid();
+    for (size_t i = 0; i < _grid.x_real_size; ++i)
+    {
+      memcpy(grid[i], _buffer, sizeof(T) * _grid.y_real_size);
+      _buffer += sizeof(T) * _grid.y_real_size;
+    }
+  }
+
+  //! particles are stored as contiguous array of structures
+  //! (without amount, it is stored by caller)
+  template <class P>
+  size_t particles_size(const std::vector<P*> &_particles)
+  {
+    return sizeof(P) * _particles.size();
+  }
+
+  template <class P>
+  void put_particles(char *&_buffer, const std::vector<P*> &_particles)
+  {
+    for (auto p = _particles.begin(); p != _particles.end(); ++p)
+    {
+      memcpy(_buffer, (*p), sizeof(P));
+      _buffer += sizeof(P);
+    }
+  }
+
+  //! replace particles of vector with ``_amount'' particles from buffer
+  template <class P>
+  void get_particles(const char *&_buffer, std::vector<P*> &_particles, size_t _amount)
+  {
+    for (auto p = _particles.begin(); p != _particles.end(); ++p)
+      delete (*p);
+    _particles.clear();
+    _particles.reserve(_amount);
+
+    for (size_t n = 0; n < _amount; ++n)
+    {
+      P *p = new P();
+      memcpy(p, _buffer, sizeof(P));
+      _buffer += sizeof(P);
+      _particles.push_back(p);
+    }
+  }
+}
+
+#endif // end of _SERIALIZE_HPP_
@@ -0,0 +1,202 @@
+/*
+ * This file is part of the PiCoPiC distribution (https://github.com/cosmonaut-ok/PiCoPiC).
+ * Copyright (c) 2020 Alexander Vynnyk.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _SIMD_HPP_
+#define _SIMD_HPP_
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+//! Small math layer for hot kernels. Every function has inline
+//! scalar fast path, which compiler can inline into particles loops,
+//! and batch variant over arrays, which is vectorized with "omp simd".
+//! Kernels are branchless and use only arithmetic and integer bit
+//! operations, so batch loops vectorize without libm vector calls.
+//!
+//! log and exp are accurate up to 1-2 ulp in their domains:
+//! log - positive normal numbers, exp - [-708, 709] (argument
+//! is clamped to this range). With -ffast-math on CPU without FMA
+//! relative error of exp grows up to |x| * 1e-16.
+
+namespace algo::simd
+{
+  namespace detail
+  {
+    inline double as_double (uint64_t i)
+    {
+      double d;
+      std::memcpy(&d, &i, sizeof(d));
+      return d;
+    }
+
+    inline uint64_t as_uint (double d)
+    {
+      uint64_t i;
+      std::memcpy(&i, &d, sizeof(i));
+      return i;
+    }
+
+    //! initial approximation of 1/sqrt(x) with relative error
+    //! less, than 3.5% and 4 newton steps, each squares error
+    inline double rsqrt_kernel (double x)
+    {
+      double y = as_double(0x5fe6eb50c7b537a9ULL - (as_uint(x) >> 1));
+      double h = 0.5 * x;
+
+      y = y * (1.5 - h * y * y);
+      y = y * (1.5 - h * y * y);
+      y = y * (1.5 - h * y * y);
+      y = y * (1.5 - h * y * y);
+
+      return y;
+    }
+
+    //! fdlibm algorithm: x = 2^k * (1 + f), sqrt(2)/2 <= 1 + f < sqrt(2),
+    //! log(1 + f) = 2s + s * R(s^2), s = f / (2 + f)
+    inline double log_kernel (double x)
+    {
+      const uint64_t off = 0x3fe6a09e667f3bcdULL;
+      const double ln2_hi = 6.93147180369123816490e-01;
+      const double ln2_lo = 1.90821492927058770002e-10;
+
+      uint64_t ix = as_uint(x);
+      uint64_t tmp = ix - off;
+
+      // mantissa, normalized to [sqrt(2)/2, sqrt(2))
+      double z = as_double(ix - (tmp & (0xfffULL << 52)));
+      // exponent as double without int64->double conversion,
+      // which is not vectorized without AVX-512
+      uint64_t k_biased = ((tmp >> 52) + 2048) & 0xfff;
+      double k = as_double(0x4330000000000000ULL | k_biased) - (4503599627370496. + 2048.);
+
+      double f = z - 1.;
+      double s = f / (2. + f);
+      double s2 = s * s;
+      double s4 = s2 * s2;
+      double t1 = s4 * (3.999999999940941908e-01
+                        + s4 * (2.222219843214978396e-01
+                                + s4 * 1.531383769920937332e-01));
+      double t2 = s2 * (6.666666666666735130e-01
+                        + s4 * (2.857142874366239149e-01
+                                + s4 * (1.818357216161805012e-01
+                                        + s4 * 1.479819860511658591e-01)));
+      double r = t1 + t2;
+      double hfsq = 0.5 * f * f;
+
+      return k * ln2_hi - ((hfsq - (s * (hfsq + r) + k * ln2_lo)) - f);
+    }
+
+    //! fdlibm algorithm: x = k * ln2 + r, |r| <= ln2 / 2,
+    //! exp(r) by rational approximation, scaled by 2^k
+    inline double exp_kernel (double x)
+    {
+      const double log2e = 1.44269504088896338700e+00;
+      const double ln2_hi = 6.93147180369123816490e-01;
+      const double ln2_lo = 1.90821492927058770002e-10;
+      // 1.5 * 2^52: adding it rounds to integer in low bits of mantissa
+      const double shift = 6755399441055744.;
+
+      x = x < -708. ? -708. : x;
+      x = x > 709. ? 709. : x;
+
+      double t = x * log2e + shift;
+      // k as two's complement integer, extracted from bits, and as
+      // double, built from bits the same way, as exponent in log_kernel
+      uint64_t k_bits = as_uint(t) - as_uint(shift);
+      double k = as_double(0x4330000000000000ULL | ((k_bits + 2048) & 0xfff))
+        - (4503599627370496. + 2048.);
+
+      // two-step reduction. With -ffast-math compiler may merge both
+      // steps to single multiplication by rounded ln2, so fma is used
+      // when available to keep it
+#ifdef __FMA__
+      double hi = std::fma(-k, ln2_hi, x);
+#else
+      double hi = x - k * ln2_hi;
+#endif
+      double lo = k * ln2_lo;
+      double r = hi - lo;
+      double r2 = r * r;
+      double c = r - r2 * (1.66666666666666019037e-01
+                           + r2 * (-2.77777777770155933842e-03
+                                   + r2 * (6.61375632143793436117e-05
+                                           + r2 * (-1.65339022054652515390e-06
+                                                   + r2 * 4.13813679705723846039e-08))));
+      double y = 1. - ((lo - (r * c) / (2. - c)) - hi);
+
+      // k + 1023 never overflows exponent field because of clamping
+      return as_double(as_uint(y) + (k_bits << 52));
+    }
+  }
+
+  //! scalar fast paths
+  inline double sqrt (double x)
+  {
+    return std::sqrt(x);
+  }
+
+  inline double rsqrt (double x)
+  {
+    // for single value hardware division is shorter,
+    // than dependent chain of newton steps
+    return 1. / std::sqrt(x);
+  }
+
+  inline double log (double x)
+  {
+    return detail::log_kernel(x);
+  }
+
+  inline double exp (double x)
+  {
+    return detail::exp_kernel(x);
+  }
+
+  //! batch variants: y[i] = f(x[i]), i in [0, n).
+  //! x and y may be the same array
+  inline void sqrt (const double *x, double *y, size_t n)
+  {
+#pragma omp simd
+    for (size_t i = 0; i < n; ++i)
+      y[i] = std::sqrt(x[i]);
+  }
+
+  inline void rsqrt (const double *x, double *y, size_t n)
+  {
+#pragma omp simd
+    for (size_t i = 0; i < n; ++i)
+      y[i] = detail::rsqrt_kernel(x[i]);
+  }
+
+  inline void log (const double *x, double *y, size_t n)
+  {
+#pragma omp simd
+    for (size_t i = 0; i < n; ++i)
+      y[i] = detail::log_kernel(x[i]);
+  }
+
+  inline void exp (const double *x, double *y, size_t n)
+  {
+#pragma omp simd
+    for (size_t i = 0; i < n; ++i)
+      y[i] = detail::exp_kernel(x[i]);
+  }
+}
+
+#endif // end of _SIMD_HPP_
@@ -0,0 +1,144 @@
+/*
+ * This file is part of the PiCoPiC distribution (https://github.com/cosmonaut-ok/PiCoPiC).
+ * Copyright (c) 2020 Alexander Vynnyk.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TILE_MAP_HPP_
+#define _TILE_MAP_HPP_
+
+#include <vector>
+
+//! size of square tile side in grid elements
+#define TILE_SIZE 16
+
+//! map of touched (could contain non-zero elements) square tiles
+//! of grid with overlay. Is used to process only touched parts of
+//! sparse grids. Tiles cover all of the real (including overlay)
+//! grid elements. Coordinates are the same, as in Grid (overlay
+//! elements are negative or not less, than grid size), ranges of
+//! elements are inclusive
+class TileMap
+{
+  std::vector<unsigned char> tiles;
+  bool any; // at least one tile is touched
+
+public:
+  unsigned int o_s; // overlay shift
+
+  unsigned int x_real_size;
+  unsigned int y_real_size;
+
+  unsigned int x_tiles;
+  unsigned int y_tiles;
+
+public:
+  TileMap() {};
+  TileMap(unsigned int x_amount, unsigned int y_amount, unsigned int overlay_shift)
+  {
+    o_s = overlay_shift;
+    x_real_size = x_amount + o_s * 2;
+    y_real_size = y_amount + o_s * 2;
+
+    x_tiles = (x_real_size + TILE_SIZE - 1) / TILE_SIZE;
+    y_tiles = (y_real_size + TILE_SIZE - 1) / TILE_SIZE;
+
+    tiles.assign(x_tiles * y_tiles, 0);
+    any = false;
+  };
+
+  void touch(int x_begin, int x_end, int y_begin, int y_end)
+  // mark tiles, which contain [x_begin, x_end] x [y_begin, y_end]
+  // elements. Range should not be longer, than tile, so it covers
+  // not more, than 2x2 tiles, which are marked without branches
+  // (is called for every weighted particle)
+  {
+    unsigned int tx_begin = (x_begin + o_s) / TILE_SIZE * y_tiles;
+    unsigned int tx_end = (x_end + o_s) / TILE_SIZE * y_tiles;
+    unsigned int ty_begin = (y_begin + o_s) / TILE_SIZE;
+    unsigned int ty_end = (y_end + o_s) / TILE_SIZE;
+
+    tiles[tx_begin + ty_begin] = 1;
+    tiles[tx_begin + ty_end] = 1;
+    tiles[tx_end + ty_begin] = 1;
+    tiles[tx_end + ty_end] = 1;
+
+    any = true;
+  };
+
+  void touch_all()
+  {
+    tiles.assign(tiles.size(), 1);
+    any = true;
+  };
+
+  void clear()
+  {
+    if (any)
+      tiles.assign(tiles.size(), 0);
+    any = false;
+  };
+
+  bool touched()
+  // at least one tile is touched
+  {
+    return any;
+  };
+
+  bool touched(unsigned int tx, unsigned int ty)
+  {
+    return tiles[tx * y_tiles + ty];
+  };
+
+  bool touched(int x_begin, int x_end, int y_begin, int y_end)
+  // at least one tile, containing [x_begin, x_end] x [y_begin, y_end]
+  // elements, is touched
+  {
+    if (! any)
+      return false;
+
+    unsigned int tx_end = (x_end + o_s) / TILE_SIZE;
+    unsigned int ty_end = (y_end + o_s) / TILE_SIZE;
+
+    for (unsigned int tx = (x_begin + o_s) / TILE_SIZE; tx <= tx_end; ++tx)
+      for (unsigned int ty = (y_begin + o_s) / TILE_SIZE; ty <= ty_end; ++ty)
+        if (tiles[tx * y_tiles + ty])
+          return true;
+
+    return false;
+  };
+
+  // first and last elements of tile
+  int x_begin(unsigned int tx)
+  {
+    return tx * TILE_SIZE - o_s;
+  };
+
+  int x_end(unsigned int tx)
+  {
+    return ((tx + 1) * TILE_SIZE < x_real_size ? (tx + 1) * TILE_SIZE : x_real_size) - o_s - 1;
+  };
+
+  int y_begin(unsigned int ty)
+  {
+    return ty * TILE_SIZE - o_s;
+  };
+
+  int y_end(unsigned int ty)
+  {
+    return ((ty + 1) * TILE_SIZE < y_real_size ? (ty + 1) * TILE_SIZE : y_real_size) - o_s - 1;
+  };
+};
+
+#endif // end of _TILE_MAP_HPP_
@@ -0,0 +1,362 @@
+/*
+ * This file is part of the PiCoPiC distribution (https://github.com/cosmonaut-ok/PiCoPiC).
+ * Copyright (c) 2020 Alexander Vynnyk.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _VB_HPP_
+#define _VB_HPP_
+
+#include <math.h>
+#include <cstddef>
+
+#include "defines.hpp"
+#include "constant.hpp"
+#include "algo/simd.hpp"
+
+//! amount of particles, which trajectories are split to segments
+//! and weighted at once. Every particle gives up to 3 segments
+#define VB_BATCH_SIZE 256
+#define VB_SEGMENTS_MAX (3 * VB_BATCH_SIZE)
+
+//! Villasenor-Buneman current weighting in batches:
+//! particles trajectories are split to segments, which lay
+//! inside single cells (branchy part, done per particle),
+//! currents of all segments are calculated in single
+//! branchless loop, vectorized with "omp simd".
+//! Arithmetic is the same, as in per-particle weighting,
+//! so results are the same bit-for-bit (unless -ffast-math
+//! lets compiler reorder vectorized operations)
+namespace algo::vb
+{
+  //! trajectory segments in SoA layout
+  struct Segments
+  {
+    size_t size = 0;
+
+    double r_new[VB_SEGMENTS_MAX];
+    double z_new[VB_SEGMENTS_MAX];
+    double r_old[VB_SEGMENTS_MAX];
+    double z_old[VB_SEGMENTS_MAX];
+    double charge[VB_SEGMENTS_MAX];
+    int i[VB_SEGMENTS_MAX];
+    int k[VB_SEGMENTS_MAX];
+
+    //! segments with zero projection to any axis do not
+    //! produce current and are not stored
+    void add (double radius_new, double longitude_new,
+              double radius_old, double longitude_old,
+              int i_n, int k_n, double p_charge)
+    {
+      if ((fabs(radius_new - radius_old) < constant::MNZL)
+          || (fabs(longitude_new - longitude_old) < constant::MNZL))
+        return;
+
+      r_new[size] = radius_new;
+      z_new[size] = longitude_new;
+      r_old[size] = radius_old;
+      z_old[size] = longitude_old;
+      i[size] = i_n;
+      k[size] = k_n;
+      charge[size] = p_charge;
+      ++size;
+    }
+
+    bool full ()
+    {
+      return size + 3 > VB_SEGMENTS_MAX;
+    }
+  };
+
+  //! weighted currents of segments:
+  //! j_z in [i][k] and [i+1][k], j_r in [i][k] and [i][k+1] cells
+  struct Currents
+  {
+    double j_z_0[VB_SEGMENTS_MAX];
+    double j_z_1[VB_SEGMENTS_MAX];
+    double j_r_0[VB_SEGMENTS_MAX];
+    double j_r_1[VB_SEGMENTS_MAX];
+  };
+
+  //! split trajectory of particle, which moved not more, than for one
+  //! cell on each axis, to segments inside single cells. i_n, k_n,
+  //! i_o, k_o - numbers of new and old cells
+  inline void split (double pos_r, double pos_z,
+                     double pos_old_r, double pos_old_z,
+                     int i_n, int k_n, int i_o, int k_o,
+                     double dr, double dz, double p_charge,
+                     Segments &s)
+  {
+    int res_cell = abs(i_n - i_o) + abs(k_n - k_o);
+
+    switch (res_cell)
+    {
+      // 1) charge in four nodes
+    case 0:
+      s.add(pos_r, pos_z, pos_old_r, pos_old_z, i_n, k_n, p_charge);
+      break;
+      // 2) charge in 7 nodes
+    case 1:
+      // moving on r-axis
+      if ((i_n != i_o) && (k_n == k_o))
+      {
+        // moving to center from outer to inner cell
+        if (pos_old_r > (i_n + 1) * dr)
+        {
+          double a = (pos_old_r - pos_r) / (pos_old_z - pos_z);
+          double r_boundary = (i_n + 1) * dr;
+          double delta_r = r_boundary - pos_r;
+          double z_boundary = pos_z + delta_r / a;
+
+          s.add(r_boundary, z_boundary, pos_old_r, pos_old_z, i_n + 1, k_n, p_charge);
+          s.add(pos_r, pos_z, r_boundary, z_boundary, i_n, k_n, p_charge);
+        }
+        // moving to wall
+        else
+        {
+          double a = (pos_r - pos_old_r) / (pos_z - pos_old_z);
+          double r_boundary = (i_n) * dr;
+          double delta_r = r_boundary - pos_old_r;
+          double z_boundary = pos_old_z + delta_r / a;
+
+          s.add(r_boundary, z_boundary, pos_old_r, pos_old_z, i_n - 1, k_n, p_charge);
+          s.add(pos_r, pos_z, r_boundary, z_boundary, i_n, k_n, p_charge);
+        }
+      }
+      // moving on z-axis
+      else if ((i_n == i_o) && (k_n != k_o))
+      {
+        // moving forward from N to N + 1 cell
+        if (pos_old_z < k_n * dz)
+        {
+          double z_boundary = k_n * dz;
+          double delta_z = z_boundary - pos_old_z;
+          double a = (pos_r - pos_old_r) / (pos_z - pos_old_z);
+          double r_boundary = pos_old_r + a * delta_z;
+
+          s.add(r_boundary, z_boundary, pos_old_r, pos_old_z, i_n, k_n - 1, p_charge);
+          s.add(pos_r, pos_z, r_boundary, z_boundary, i_n, k_n, p_charge);
+        }
+        // moving backward
+        else
+        {
+          double z_boundary = (k_n + 1) * dz;
+          double delta_z = z_boundary - pos_z;
+          double a = (pos_old_r - pos_r) / (pos_old_z - pos_z);
+          double r_boundary = pos_r + a * delta_z;
+
+          s.add(r_boundary, z_boundary, pos_old_r, pos_old_z, i_n, k_n + 1, p_charge);
+          s.add(pos_r, pos_z, r_boundary, z_boundary, i_n, k_n, p_charge);
+        }
+      }
+      break;
+      // 3) charge in 10 nodes
+    case 2:
+      // moving forward
+      if (i_o < i_n)
+      {
+        // [i-1][k-1] -> [i][k]
+        if (k_o < k_n)
+        {
+          double a = (pos_r - pos_old_r) / (pos_z - pos_old_z);
+          double r1 = i_n * dr;
+          double delta_z1 = (r1 - pos_old_r) / a;
+          double z1 = pos_old_z + delta_z1;
+          double z2 = k_n * dz;
+          double delta_r2 = (z2 - pos_old_z) * a;
+          double r2 = pos_old_r + delta_r2;
+
+          if (z1 < k_n * dz)
+          {
+            s.add(r1, z1, pos_old_r, pos_old_z, i_n - 1, k_n - 1, p_charge);
+            s.add(r2, z2, r1, z1, i_n, k_n - 1, p_charge);
+            s.add(pos_r, pos_z, r2, z2, i_n, k_n, p_charge);
+          }
+          else if (z1 > k_n * dz)
+          {
+            s.add(r2, z2, pos_old_r, pos_old_z, i_n - 1, k_n - 1, p_charge);
+            s.add(r1, z1, r2, z2, i_n - 1, k_n, p_charge);
+            s.add(pos_r, pos_z, r1, z1, i_n, k_n, p_charge);
+          }
+        }
+        // [i-1][k+1] -> [i][k]
+        else
+        {
+          double a = (pos_r - pos_old_r) / (pos_z - pos_old_z);
+          double r1 = i_n * dr;
+          double delta_z1 = (r1 - pos_old_r) / a;
+          double z1 = pos_old_z + delta_z1;
+          double z2 = (k_n + 1) * dz;
+          double delta_r2 = -(pos_old_z - z2) * a;
+          double r2 = pos_old_r + delta_r2;
+
+          if (z1 > (k_n + 1) * dz)
+          {
+            s.add(r1, z1, pos_old_r, pos_old_z, i_n - 1, k_n + 1, p_charge);
+            s.add(r2, z2, r1, z1, i_n, k_n + 1, p_charge);
+            s.add(pos_r, pos_z, r2, z2, i_n, k_n, p_charge);
+          }
+          else if (z1 < (k_n + 1) * dz)
+          {
+            s.add(r2, z2, pos_old_r, pos_old_z, i_n - 1, k_n + 1, p_charge);
+            s.add(r1, z1, r2, z2, i_n - 1, k_n, p_charge);
+            s.add(pos_r, pos_z, r1, z1, i_n, k_n, p_charge);
+          }
+        }
+      }
+      // moving backward
+      else if (i_o > i_n)
+      {
+        // [i+1][k-1] -> [i][k]
+        if (k_o < k_n)
+        {
+          double a = (pos_r - pos_old_r) / (pos_z - pos_old_z);
+          double r1 = (i_n + 1) * dr;
+          double delta_z1 = -(pos_old_r - r1) / a;
+          double z1 = pos_old_z + delta_z1;
+          double z2 = k_n * dz;
+          double delta_r2 = -(z2 - pos_old_z) * a;
+          double r2 = pos_old_r - delta_r2;
+
+          if (z1 < (k_n) * dz)
+          {
+            s.add(r1, z1, pos_old_r, pos_old_z, i_n + 1, k_n - 1, p_charge);
+            s.add(r2, z2, r1, z1, i_n, k_n - 1, p_charge);
+            s.add(pos_r, pos_z, r2, z2, i_n, k_n, p_charge);
+          }
+          else if (z1 > (k_n) * dz)
+          {
+            s.add(r2, z2, pos_old_r, pos_old_z, i_n + 1, k_n - 1, p_charge);
+            s.add(r1, z1, r2, z2, i_n + 1, k_n, p_charge);
+            s.add(pos_r, pos_z, r1, z1, i_n, k_n, p_charge);
+          }
+        }
+        // [i+1][k+1] -> [i][k]
+        else if (k_o > k_n)
+        {
+          double a = (pos_old_r - pos_r) / (pos_old_z - pos_z);
+          double r1 = (i_n + 1) * dr;
+          double delta_z1 = (r1 - pos_r) / a;
+          double z1 = pos_z + delta_z1;
+          double z2 = (k_n + 1) * dz;
+          double delta_r2 = (z2 - pos_z) * a;
+          double r2 = pos_r + delta_r2;
+
+          if (z1 > (k_n + 1) * dz)
+          {
+            s.add(r1, z1, pos_old_r, pos_old_z, i_n + 1, k_n + 1, p_charge);
+            s.add(r2, z2, r1, z1, i_n, k_n + 1, p_charge);
+            s.add(pos_r, pos_z, r2, z2, i_n, k_n, p_charge);
+          }
+          else if (z1 < (k_n + 1) * dz)
+          {
+            s.add(r2, z2, pos_old_r, pos_old_z, i_n + 1, k_n + 1, p_charge);
+            s.add(r1, z1, r2, z2, i_n + 1, k_n, p_charge);
+            s.add(pos_r, pos_z, r1, z1, i_n, k_n, p_charge);
+          }
+        }
+      }
+      break;
+    }
+  }
+
+  //! currents of single segment inside [i_n][k_n] cell.
+  //! Branchless: both variants for axis cell and for other
+  //! cells are calculated and one of them is selected
+  inline void segment_currents (double radius_new, double longitude_new,
+                                double radius_old, double longitude_old,
+                                int i_n, int k_n, double p_charge,
+                                double dr, double dz, double delta_t,
+                                double &j_z_0, double &j_z_1,
+                                double &j_r_0, double &j_r_1)
+  {
+    const double PI = constant::PI;
+
+    // distance of particle moving
+    double delta_r = radius_new - radius_old;
+    double delta_z = longitude_new - longitude_old;
+
+    // j_z. Equation of trajectory r = k * z + b
+    double k = delta_r / delta_z;
+    double b = radius_old;
+    double log_z = algo::simd::log((k * delta_z + b) / b);
+
+    double density_0 = p_charge / (2. * PI * (i_n * dr) * (dr) * (dz)
+                                   * (delta_t) * 2. * (dr));
+    double density_1 = p_charge / (2. * PI * ((i_n + 1) * dr) * (dr) * (dz)
+                                   * (delta_t) * 2. * (dr));
+
+    double j_z_0_cell = density_0
+      * (dr * delta_z - k * delta_z * delta_z / 2. - delta_z * b + dr * dr / k
+         * ((i_n + 0.5) * (i_n + 0.5) - 0.25) * log_z);
+    double j_z_1_cell = density_1
+      * (k * delta_z * delta_z / 2. + delta_z * b + delta_z * dr + dr * dr / k *
+         (0.25-(i_n + 0.5) * (i_n + 0.5)) * log_z);
+
+    // axis cell
+    double density_0_axis = p_charge
+      / (2. * PI * dr / 4. * dr * dz
+         * delta_t
+         * dr);
+    double density_1_axis = p_charge / (2. * PI * (dr) * (dr) * (dz)
+                                        * (delta_t) * 2. * (dr));
+
+    double j_z_0_axis = density_0_axis
+      * (dr * delta_z - k * delta_z * delta_z / 2. - delta_z * b );
+    double j_z_1_axis = density_1_axis
+      * (k * delta_z * delta_z / 2. + delta_z * dr + delta_z * b);
+
+    j_z_0 = i_n >= 1 ? j_z_0_cell : j_z_0_axis;
+    j_z_1 = i_n >= 1 ? j_z_1_cell : j_z_1_axis;
+
+    // j_r. Equation of trajectory z = k * r + b
+    k = -delta_z / delta_r;
+    double r0 = (i_n + 0.5) * dr;
+    double r1 = radius_old;
+    double log_r = algo::simd::log((radius_old + delta_r) / radius_old);
+    double density_r = p_charge / (2. * PI * (r0) * (dr) * (dz)
+                                   * (delta_t) * (dz));
+
+    b = (k_n + 1.) * dz - longitude_old;
+    j_r_0 = density_r
+      * (r0 * k * delta_r + k / 2. * delta_r * (radius_old + delta_r / 2.)
+         + 0.5 * delta_r * (b - k * (2 * r0 + r1))
+         + delta_r * (b - k * r1) * (4 * r0 * r0 - dr * dr)
+         / (8 * radius_old * (radius_old + delta_r))
+         + (k * (r0 * r0 / 2. - dr * dr / 8.))
+         * log_r);
+
+    b = longitude_old - k_n * dz;
+    j_r_1 = density_r
+      * (-r0 * k * delta_r - k / 2. * delta_r * (radius_old + delta_r / 2.)
+         + 0.5 * delta_r * (b + k * (2 * r0 + r1))
+         + delta_r * (b + k * r1) * (4 * r0 * r0 - dr * dr)
+         / (8 * radius_old * (radius_old + delta_r))
+         - (k * (r0 * r0 / 2. - dr * dr / 8.))
+         * log_r);
+  }
+
+  //! currents of all segments, vectorized
+  inline void currents (const Segments &s, double dr, double dz, double delta_t,
+                        Currents &c)
+  {
+#pragma omp simd
+    for (size_t n = 0; n < s.size; ++n)
+      segment_currents(s.r_new[n], s.z_new[n], s.r_old[n], s.z_old[n],
+                       s.i[n], s.k[n], s.charge[n], dr, dz, delta_t,
+                       c.j_z_0[n], c.j_z_1[n], c.j_r_0[n], c.j_r_1[n]);
+  }
+}
+
+#endif // end of _VB_HPP_
@@ -24,8 +24,14 @@
 #include "algo/grid.hpp"
 #include "specieP.hpp"
 
+//! calculate factors of the particle shape function for cells
+//! [i][k], [i+1][k], [i][k+1] and [i+1][k+1] (in this order),
+//! normalized to particle and cells volumes, so weighting of
+//! some value to the grid node is just value * factor
 template <typename T>
-void weight_cylindrical(Geometry *geometry, Grid<T> *grid, double pos_r, double pos_z, T weight_value)
+void weight_cylindrical_factors(Geometry *geometry, double pos_r, double pos_z,
+                                unsigned int &r_i_shift, unsigned int &z_k_shift,
+                                T *factors)
 {
   T dr = (T)geometry->cell_size[0];
   T dz = (T)geometry->cell_size[1];
@@ -34,100 +40,109 @@ void weight_cylindrical(Geometry *geometry, Grid<T> *grid, double pos_r, double
   T r1, r2, r3; // radiuses
   T dz1, dz2; // longitudes
 
-  T rho_w_value, v_0, value;
+  T v_0, v_0_inv;
 
   // finding number of i and k cell. example: dr = 0.5; r = 0.4; i =0
   unsigned int r_i = CELL_NUMBER(pos_r, dr);
   unsigned int z_k = CELL_NUMBER(pos_z, dz);
-  unsigned int r_i_shift = r_i - bottom_shift;
-  unsigned int z_k_shift = z_k - left_shift;
+  r_i_shift = r_i - bottom_shift;
+  z_k_shift = z_k - left_shift;
 
   // volumes
   T v_1 = CELL_VOLUME(r_i, dr, dz);
   T v_2 = CELL_VOLUME(r_i + 1, dr, dz);
 
+  dz1 = (z_k + 0.5) * dz - (pos_z - 0.5 * dz);
+  dz2 = (pos_z + 0.5 * dz) - (z_k + 0.5) * dz;
+
   if (pos_r > dr)
   {
     r1 =  pos_r - 0.5 * dr;
     r2 = (r_i + 0.5) * dr;
     r3 = pos_r + 0.5 * dr;
     v_0 = 2. * constant::PI * dz * dr * pos_r;
-    dz1 = (z_k + 0.5) * dz - (pos_z - 0.5 * dz);
-    dz2 = (pos_z + 0.5 * dz) - (z_k + 0.5) * dz;
-    rho_w_value = weight_value / v_0;
-
-    // weighting in ro[i][k] cell
-    value = CYL_RNG_VOL(dz1, r1, r2) / v_1;
-    grid->inc(r_i_shift, z_k_shift, rho_w_value * value);
-
-    // weighting in ro[i + 1][k] cell
-    value = CYL_RNG_VOL(dz1, r2, r3) / v_2;
-    grid->inc(r_i_shift + 1, z_k_shift, rho_w_value * value);
-
-    // weighting in ro[i][k + 1] cell
-    value = CYL_RNG_VOL(dz2, r1, r2) / v_1;
-    grid->inc(r_i_shift, z_k_shift+1, rho_w_value * value);
+    v_0_inv = 1. / v_0;
 
-    // weighting in ro[i + 1][k + 1] cell
-    value = CYL_RNG_VOL(dz2, r2, r3) / v_2;
-    grid->inc(r_i_shift + 1, z_k_shift + 1, rho_w_value * value);
+    factors[0] = CYL_RNG_VOL(dz1, r1, r2) / v_1 * v_0_inv;
+    factors[1] = CYL_RNG_VOL(dz1, r2, r3) / v_2 * v_0_inv;
+    factors[2] = CYL_RNG_VOL(dz2, r1, r2) / v_1 * v_0_inv;
+    factors[3] = CYL_RNG_VOL(dz2, r2, r3) / v_2 * v_0_inv;
   }
   else if (pos_r <= dr / 2.)
   {
     r_i = 0;
-    r1 =  0.;
     r2 = (r_i + 0.5) * dr;
     r3 = pos_r + 0.5 * dr;
-    dz1 = (z_k + 0.5) * dz - (pos_z - 0.5 * dz);
-    dz2 = (pos_z + 0.5 * dz) - (z_k + 0.5) * dz;
     v_0 = constant::PI * dz * (2. * pos_r * pos_r + dr * dr / 2.);
-    rho_w_value = weight_value / v_0;
-
-    // weighting in ro[i][k] cell
-    value = constant::PI * dz1 * (dr * dr / 2. - pos_r * dr + pos_r * pos_r) / v_1;
-
-    grid->inc(r_i_shift, z_k_shift, rho_w_value * value);
-
-    // weighting in ro[i + 1][k] cell
-    value = CYL_RNG_VOL(dz1, r2, r3) / v_2;
-    grid->inc(r_i_shift + 1, z_k_shift, rho_w_value * value);
-
-    // weighting in ro[i][k + 1] cell
-    value = constant::PI * dz2 * (dr * dr / 2. - pos_r * dr + pos_r * pos_r) / v_1;
-    grid->inc(r_i_shift, z_k_shift + 1, rho_w_value * value);
+    v_0_inv = 1. / v_0;
 
-    // weighting in ro[i + 1][k + 1] cell
-    value = CYL_RNG_VOL(dz2, r2, r3) / v_2;
-    grid->inc(r_i_shift + 1, z_k_shift + 1, rho_w_value * value);
+    factors[0] = constant::PI * dz1 * (dr * dr / 2. - pos_r * dr + pos_r * pos_r) / v_1 * v_0_inv;
+    factors[1] = CYL_RNG_VOL(dz1, r2, r3) / v_2 * v_0_inv;
+    factors[2] = constant::PI * dz2 * (dr * dr / 2. - pos_r * dr + pos_r * pos_r) / v_1 * v_0_inv;
+    factors[3] = CYL_RNG_VOL(dz2, r2, r3) / v_2 * v_0_inv;
   }
   else
   {
     r1 = pos_r - 0.5 * dr;
     r2 = (r_i + 0.5) * dr;
     r3 = pos_r + 0.5 * dr;
-    dz1 = (z_k + 0.5) * dz - (pos_z - 0.5 * dz);
-    dz2 = (pos_z + 0.5 * dz) - (z_k + 0.5) * dz;
     v_0 = 2. * constant::PI * dz * dr * pos_r;
+    v_0_inv = 1. / v_0;
     v_1 = CYL_VOL(dz, dr);
     v_2 = CELL_VOLUME(r_i + 1, dr, dz);
 
-    rho_w_value = weight_value / v_0;
+    factors[0] = CYL_RNG_VOL(dz1, r1, r2) / v_1 * v_0_inv;
+    factors[1] = CYL_RNG_VOL(dz1, r2, r3) / v_2 * v_0_inv;
+    factors[2] = CYL_RNG_VOL(dz2, r1, r2) / v_1 * v_0_inv;
+    factors[3] = CYL_RNG_VOL(dz2, r2, r3) / v_2 * v_0_inv;
+  }
+}
 
-    // weighting in ro[i][k] cell
-    value = CYL_RNG_VOL(dz1, r1, r2) / v_1;
-    grid->inc(r_i_shift, z_k_shift, rho_w_value * value);
+template <typename T>
+void weight_cylindrical(Geometry *geometry, Grid<T> *grid, double pos_r, double pos_z, T weight_value)
+{
+  unsigned int r_i_shift, z_k_shift;
+  T factors[4];
+
+  weight_cylindrical_factors<T>(geometry, pos_r, pos_z, r_i_shift, z_k_shift, factors);
+
+  // weighting in ro[i][k] cell
+  grid->inc(r_i_shift, z_k_shift, weight_value * factors[0]);
+  // weighting in ro[i + 1][k] cell
+  grid->inc(r_i_shift + 1, z_k_shift, weight_value * factors[1]);
+  // weighting in ro[i][k + 1] cell
+  grid->inc(r_i_shift, z_k_shift + 1, weight_value * factors[2]);
+  // weighting in ro[i + 1][k + 1] cell
+  grid->inc(r_i_shift + 1, z_k_shift + 1, weight_value * factors[3]);
+}
+
+//! weight N values of the particle (moments) at once.
+//! Shape function factors are calculated only once and values
+//! are scattered to interleaved array of moments with
+//! [x_real_size][y_real_size][N] layout, where overlay shift
+//! o_s is the same, as for Grid
+template <typename T, unsigned int N>
+void weight_cylindrical_moments(Geometry *geometry, T *moments,
+                                unsigned int y_real_size, unsigned int o_s,
+                                double pos_r, double pos_z, const T *values)
+{
+  unsigned int r_i_shift, z_k_shift;
+  T factors[4];
 
-    // weighting in ro[i + 1][k] cell
-    value = CYL_RNG_VOL(dz1, r2, r3) / v_2;
-    grid->inc(r_i_shift + 1, z_k_shift, rho_w_value * value);
+  weight_cylindrical_factors<T>(geometry, pos_r, pos_z, r_i_shift, z_k_shift, factors);
 
-    // weighting in ro[i][k + 1] cell
-    value = CYL_RNG_VOL(dz2, r1, r2) / v_1;
-    grid->inc(r_i_shift, z_k_shift + 1, rho_w_value * value);
+  size_t c_00 = ((size_t)(r_i_shift + o_s) * y_real_size + z_k_shift + o_s) * N;
+  size_t c_10 = c_00 + (size_t)y_real_size * N;
+  size_t c_01 = c_00 + N;
+  size_t c_11 = c_10 + N;
 
-    // weighting in ro[i + 1][k + 1] cell
-    value = CYL_RNG_VOL(dz2, r2, r3) / v_2;
-    grid->inc(r_i_shift + 1, z_k_shift + 1, rho_w_value * value);
+#pragma omp simd
+  for (unsigned int n = 0; n < N; ++n)
+  {
+    moments[c_00 + n] += values[n] * factors[0];
+    moments[c_10 + n] += values[n] * factors[1];
+    moments[c_01 + n] += values[n] * factors[2];
+    moments[c_11 + n] += values[n] * factors[3];
   }
 }
 
@@ -0,0 +1,181 @@
+/*
+ * This file is part of the PiCoPiC distribution (https://github.com/cosmonaut-ok/PiCoPiC).
+ * Copyright (c) 2020 Alexander Vynnyk.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _ZIGZAG_HPP_
+#define _ZIGZAG_HPP_
+
+#include <math.h>
+#include <cstddef>
+
+#include "defines.hpp"
+#include "constant.hpp"
+#include "geometry.hpp"
+
+//! amount of particles, which currents are weighted at once
+#define ZIGZAG_BATCH_SIZE 256
+
+//! ZigZag current weighting in batches: particles data is
+//! gathered to SoA buffer, currents of all particles are
+//! calculated in single branchless loop, vectorized with
+//! "omp simd", and scattered to grids after that
+namespace algo::zigzag
+{
+  //! particles data and their currents in SoA layout.
+  //! j_r - to [i_o][k_o], [i_o][k_o+1], [i_n][k_n], [i_n][k_n+1] nodes,
+  //! j_phi - to [i_n][k_n], [i_n][k_n+1], [i_n+1][k_n], [i_n+1][k_n+1],
+  //! j_z - to [i_o][k_o], [i_o+1][k_o], [i_n][k_n], [i_n+1][k_n]
+  struct Batch
+  {
+    size_t size = 0;
+
+    double r_old[ZIGZAG_BATCH_SIZE];
+    double z_old[ZIGZAG_BATCH_SIZE];
+    double r_new[ZIGZAG_BATCH_SIZE];
+    double z_new[ZIGZAG_BATCH_SIZE];
+    double charge[ZIGZAG_BATCH_SIZE];
+    double vel_phi[ZIGZAG_BATCH_SIZE];
+    int i_n[ZIGZAG_BATCH_SIZE];
+    int k_n[ZIGZAG_BATCH_SIZE];
+
+    int i_o[ZIGZAG_BATCH_SIZE];
+    int k_o[ZIGZAG_BATCH_SIZE];
+    double j_r[4][ZIGZAG_BATCH_SIZE];
+    double j_phi[4][ZIGZAG_BATCH_SIZE];
+    double j_z[4][ZIGZAG_BATCH_SIZE];
+
+    //! i_n and k_n are numbers of new particle's cell, which are
+    //! already known, so are not calculated again
+    void add (double pos_old_r, double pos_old_z,
+              double pos_r, double pos_z,
+              int cell_r, int cell_z,
+              double p_charge, double p_vel_phi)
+    {
+      r_old[size] = pos_old_r;
+      z_old[size] = pos_old_z;
+      r_new[size] = pos_r;
+      z_new[size] = pos_z;
+      i_n[size] = cell_r;
+      k_n[size] = cell_z;
+      charge[size] = p_charge;
+      vel_phi[size] = p_vel_phi;
+      ++size;
+    }
+
+    bool full ()
+    {
+      return size == ZIGZAG_BATCH_SIZE;
+    }
+  };
+
+  //! relay point of the zigzag trajectory
+  inline double relay_point (int i1, int i2, double x1, double x2, double dx)
+  {
+    double lower = (i1 < i2 ? i1 : i2) * dx;
+    double upper = (i1 < i2 ? i2 : i1) * dx;
+    double middle = (x1 + x2) / 2.;
+
+    middle = upper > middle ? upper : middle;
+
+    return lower + dx < middle ? lower + dx : middle;
+  }
+
+  //! currents of particles in batch.
+  //! inv_volume - 1 / volume of cells, starting from
+  //! radial cell number inv_volume_first.
+  //! If ``rz_current'' is false, only azimuthal current is weighted
+  //! (j_r and j_z are zero): sub-cycled particles are not moved between
+  //! their push steps, but they carry azimuthal current every step
+  inline void currents (Batch &b, double dr, double dz, double dt,
+                        const double *inv_volume, int inv_volume_first,
+                        bool rz_current = true)
+  {
+    const double PI = constant::PI;
+    double rz_factor = rz_current ? 1. : 0.;
+
+#pragma omp simd
+    for (size_t n = 0; n < b.size; ++n)
+    {
+      double r_pos_old = b.r_old[n];
+      double z_pos_old = b.z_old[n];
+      double r_pos_new = b.r_new[n];
+      double z_pos_new = b.z_new[n];
+      int i_n = b.i_n[n];
+      int k_n = b.k_n[n];
+
+      double charge_over_dt = b.charge[n] * rz_factor / dt;
+
+      int i_o = CELL_NUMBER(r_pos_old, dr);
+      int k_o = CELL_NUMBER(z_pos_old, dz);
+
+      // cell of middle point between old and new positions
+      int i_middle = CELL_NUMBER((r_pos_new + r_pos_old) / 2., dr);
+      double one_over_volume = inv_volume[i_middle - inv_volume_first];
+
+      double F_phi = b.charge[n] * b.vel_phi[n];
+      double W_phi = b.vel_phi[n] * dt / (2. * PI * (r_pos_old + r_pos_new));
+
+      double r_relay_pos = relay_point(i_o, i_n, r_pos_old, r_pos_new, dr);
+      double z_relay_pos = relay_point(k_o, k_n, z_pos_old, z_pos_new, dz);
+
+      double F_r1 = charge_over_dt * (r_relay_pos - r_pos_old);
+      double F_r2 = charge_over_dt * (r_pos_new - r_relay_pos);
+      double F_z1 = charge_over_dt * (z_relay_pos - z_pos_old);
+      double F_z2 = charge_over_dt * (z_pos_new - z_relay_pos);
+
+      double W_r1 = (r_pos_old + r_relay_pos) / 2 - i_o * dr;
+      double W_r2 = (r_pos_new + r_relay_pos) / 2 - i_n * dr;
+      double W_z1 = (z_pos_old + z_relay_pos) / 2 - k_o * dz;
+      double W_z2 = (z_pos_new + z_relay_pos) / 2 - k_n * dz;
+
+      double one_minus_Wr1 = 1 - W_r1;
+      double one_minus_Wr2 = 1 - W_r2;
+      double one_minus_Wz1 = 1 - W_z1;
+      double one_minus_Wz2 = 1 - W_z2;
+      double one_minus_Wphi = 1 - W_phi;
+
+      b.i_o[n] = i_o;
+      b.k_o[n] = k_o;
+
+      b.j_r[0][n] = one_over_volume * F_r1 * one_minus_Wphi * one_minus_Wz1
+        + one_over_volume * F_r1 * W_phi * one_minus_Wz1;
+      b.j_r[1][n] = one_over_volume * F_r1 * one_minus_Wphi * W_z1
+        + one_over_volume * F_r1 * W_phi * W_z1;
+      b.j_r[2][n] = one_over_volume * F_r2 * one_minus_Wphi * one_minus_Wz2
+        + one_over_volume * F_r2 * W_phi * one_minus_Wz2;
+      b.j_r[3][n] = one_over_volume * F_r2 * one_minus_Wphi * W_z2
+        + one_over_volume * F_r2 * W_phi * W_z2;
+
+      // Let \f$ \phi_{relay} = \phi_{1} = 0
+      // because geometry is axisymmetric
+      b.j_phi[0][n] = one_over_volume * F_phi * one_minus_Wr2 * one_minus_Wz2;
+      b.j_phi[1][n] = one_over_volume * F_phi * one_minus_Wr2 * W_z1;
+      b.j_phi[2][n] = one_over_volume * F_phi * W_r2 * one_minus_Wz2;
+      b.j_phi[3][n] = one_over_volume * F_phi * W_r2 * W_z2;
+
+      b.j_z[0][n] = one_over_volume * F_z1 * one_minus_Wr1 * one_minus_Wphi
+        + one_over_volume * F_z1 * one_minus_Wr1 * W_phi;
+      b.j_z[1][n] = one_over_volume * F_z1 * W_r1 * one_minus_Wphi
+        + one_over_volume * F_z1 * W_r1 * W_phi;
+      b.j_z[2][n] = one_over_volume * F_z2 * one_minus_Wr2 * one_minus_Wphi
+        + one_over_volume * F_z2 * one_minus_Wr2 * W_phi;
+      b.j_z[3][n] = one_over_volume * F_z2 * W_r2 * one_minus_Wphi
+        + one_over_volume * F_z2 * W_r2 * W_phi;
+    }
+  }
+}
+
+#endif // end of _ZIGZAG_HPP_
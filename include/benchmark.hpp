@@ -0,0 +1,86 @@
+/*
+ * This file is part of the PiCoPiC distribution (https://github.com/cosmonaut-ok/PiCoPiC).
+ * Copyright (c) 2020 Alexander Vynnyk.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _BENCHMARK_HPP_
+#define _BENCHMARK_HPP_
+
+#include <string>
+#include <vector>
+#include <iostream>
+
+#include "defines.hpp"
+#include "msg.hpp"
+
+//! default amount of steps per single run
+#define BENCHMARK_STEPS 100
+//! default domain decompositions (r x z)
+#define BENCHMARK_DOMAINS "2x2,2x4,2x8,4x8"
+//! seed of random generator, same for every run
+#define BENCHMARK_SEED 1394
+
+struct benchmark_result
+{
+  unsigned int threads;
+  unsigned int r_domains;
+  unsigned int z_domains;
+  double seconds; // time of main loop (without initial distribution)
+  double particles_pushed; // sum of particles amounts for all of the steps
+  double cell_updates; // cells amount multiplied to steps amount
+  std::string solvers; // pusher:current:maxwell_solver:collisions, used in run
+};
+
+//! End-to-end throughput benchmark of the main loop.
+//!
+//! Runs one of the canonical built-in scenarios (``uniform''
+//! plasma, ``beam''-plasma or ``collisions''-on uniform plasma)
+//! for a fixed amount of steps with output disabled. Scenario
+//! is repeated for every given domain decomposition and OpenMP
+//! threads amount (and solvers combination, if given). Report, containing particles pushed per second,
+//! cell updates per second and parallel efficiency (related to
+//! single-thread run with the same decomposition), is written as JSON
+class Benchmark
+{
+public:
+  std::string profile;
+  unsigned int steps;
+  std::vector<unsigned int> threads;
+  std::vector< std::vector<unsigned int> > domains; // [[r, z], ...]
+  std::vector< std::vector<std::string> > solvers; // [[pusher, current(, collisions)], ...]
+
+public:
+  Benchmark () {};
+  Benchmark (std::string _profile, unsigned int _steps,
+             std::vector<unsigned int> _threads,
+             std::vector< std::vector<unsigned int> > _domains,
+             std::vector< std::vector<std::string> > _solvers);
+  ~Benchmark () {};
+
+  void operator()(std::ostream &out);
+
+  static std::vector<unsigned int> parse_threads(std::string str);
+  static std::vector< std::vector<unsigned int> > parse_domains(std::string str);
+  static std::vector< std::vector<std::string> > parse_solvers(std::string str);
+
+private:
+  std::string scenario(std::vector<std::string> &run_solvers,
+                       unsigned int r_domains, unsigned int z_domains);
+  benchmark_result run(std::vector<std::string> &run_solvers,
+                       unsigned int r_domains, unsigned int z_domains,
+                       unsigned int threads_amount);
+};
+
+#endif // _BENCHMARK_HPP_
@@ -27,6 +27,7 @@
 #include "defines.hpp"
 #include "msg.hpp"
 #include "phys/plasma.hpp"
+#include "math/fft.hpp"
 
 #include "geometry.hpp"
 #include "timeSim.hpp"
@@ -48,6 +49,11 @@ struct probe
   unsigned int shape;
   std::vector<size_t> dims;
   unsigned int schedule;
+  unsigned int time_reduce; // 0 - none; 1 - average; 2 - min; 3 - max; 4 - rms; 5 - spectrum
+  unsigned int sample; // accumulate time-reduced values every ``sample'' steps
+  unsigned int space_reduce; // 0 - none; 1 - pick; 2 - block
+  unsigned int factor; // space reduction factor (in cells)
+  unsigned int window; // amount of samples in spectral probe window
 };
 
 struct particle_specie
@@ -60,6 +66,7 @@ struct particle_specie
   double left_density;
   double right_density;
   double temperature;
+  unsigned int push_every; // sub-cycling: push specie every N time steps
 };
 
 struct particle_beam : particle_specie
@@ -83,11 +90,53 @@ struct save_data
   int compress_level;
 };
 
+struct checkpoint_data
+{
+  bool use; // checkpoints are enabled
+  std::string path;
+  unsigned int schedule; // save checkpoint every ``schedule'' steps (0 for signal-triggered only)
+  bool restart; // restart from existing checkpoint
+};
+
+struct instrumentation_data
+{
+  bool use; // instrumentation output is enabled
+  std::string path;
+  unsigned int schedule; // dump instrumentation every ``schedule'' steps (0 for the end of run only)
+  std::string format; // ``json'' or ``csv''
+};
+
+struct moving_window_data
+{
+  bool use; // moving window is enabled
+  double velocity; // velocity of window in z direction
+  double start_time; // time, when window begins to move
+};
+
+struct resampling_data
+{
+  bool use; // macroparticles resampling is enabled
+  unsigned int schedule; // resample every ``schedule'' steps
+  unsigned int min_per_cell; // split particles in cells with less particles (0 to disable)
+  unsigned int max_per_cell; // merge particles in cells with more particles (0 to disable)
+};
+
+//! names of solvers, composed into simulation domain
+//! (see Domain::create)
+struct solvers_data
+{
+  std::string pusher; // ``boris'', ``boris_adaptive'', ``boris_relativistic'', ``vay'' or ``hc''
+  std::string current; // ``vb'' or ``zigzag''
+  std::string maxwell_solver; // ``yee''
+  std::string collisions; // ``none'', ``ta77s'', ``sk98'' or ``p12''
+};
+
 class Cfg
 {
 public:
   // Cfg(void);
   Cfg(const std::string json_file_name);
+  Cfg(std::istream &json_stream);
   ~Cfg(void);
 
   std::string cfg2str();
@@ -103,12 +152,30 @@ public:
 
   Geometry *geometry;
 
+  //! domains partitioning: ``uniform'' or ``load''
+  std::string partitioning;
+
   /* <time> */
   TimeSim *time;
 
   /* output data params structure */
   save_data *output_data;
 
+  /* checkpoint/restart params structure */
+  checkpoint_data *checkpoint_params;
+
+  /* per-phase timers and counters params structure */
+  instrumentation_data *instrumentation_params;
+
+  /* moving window params structure */
+  moving_window_data *moving_window_params;
+
+  /* macroparticles merging/splitting params structure */
+  resampling_data *resampling_params;
+
+  /* particles pusher, current deposition, field solver and collisions */
+  solvers_data *solvers;
+
   vector<particle_specie> particle_species;
   vector<particle_beam> particle_beams;
 
@@ -175,6 +242,7 @@ public:
 private:
   picojson::value json_data;
 
+  void init(std::istream &json_stream);
   void init_particles();
   void init_probes();
   void init_beam();
@@ -183,6 +251,11 @@ private:
   void init_time();
   void init_boundary();
   void init_output_data();
+  void init_checkpoint();
+  void init_instrumentation();
+  void init_moving_window();
+  void init_resampling();
+  void init_solvers();
   void weight_macro_amount();
   bool method_limitations_check();
 };
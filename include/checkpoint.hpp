@@ -0,0 +1,97 @@
+/*
+ * This file is part of the PiCoPiC distribution (https://github.com/cosmonaut-ok/PiCoPiC).
+ * Copyright (c) 2020 Alexander Vynnyk.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _CHECKPOINT_HPP_
+#define _CHECKPOINT_HPP_
+
+#include <string>
+#include <vector>
+#include <cstring>
+
+#include "defines.hpp"
+#include "msg.hpp"
+
+#include "math/rand.hpp"
+#include "algo/common.hpp"
+#include "algo/grid.hpp"
+#include "algo/grid3d.hpp"
+#include "algo/serialize.hpp"
+
+#include "timeSim.hpp"
+#include "SMB.hpp"
+
+#define CHECKPOINT_MAGIC "PICOPIC"
+#define CHECKPOINT_VERSION 5
+
+#ifdef ENABLE_MOMENTUM
+#define CHECKPOINT_MOMENTUM 1
+#else
+#define CHECKPOINT_MOMENTUM 0
+#endif // ENABLE_MOMENTUM
+
+//! checkpoint file header. It followed by table of
+//! domains blocks offsets, RNG state and domains blocks
+struct checkpoint_header
+{
+  char magic[8];
+  unsigned int version;
+  unsigned int domains_amount;
+  double time_current;
+  unsigned int print_header_counter;
+  size_t rng_state_size;
+  unsigned int particle_size; // differs for double and mixed precision builds
+  unsigned int momentum; // particles store momentum per unit mass, instead of velocity
+};
+
+//! Binary checkpoint/restart of full simulation state of SMB:
+//! fields, currents, particles of every specie, beam bunch
+//! counters, time reduction state of probes (accumulated and
+//! spectral window values), simulation time and RNG state.
+//!
+//! Every SMB (MPI rank) writes it's own file. Domains are
+//! stored as contiguous blocks with precalculated offsets, so
+//! they are serialized and restored in parallel. Checkpoint is
+//! written to temporary file, which is renamed after successfull
+//! write, so previous checkpoint is not lost if job is killed.
+//! Checkpoint is reloaded with mmap
+class Checkpoint
+{
+public:
+  std::string path;
+
+private:
+  SMB *smb;
+  TimeSim *time;
+  std::string file_name;
+
+public:
+  Checkpoint () {};
+  Checkpoint (std::string _path, SMB *_smb, TimeSim *_time, int _world_rank);
+  ~Checkpoint () {};
+
+  bool exists();
+  void save();
+  void load();
+
+private:
+  size_t domain_size(Domain *_domain);
+  void domain_serialize(Domain *_domain, char *_buffer);
+  void domain_deserialize(Domain *_domain, const char *_buffer, size_t _size);
+  vector< Grid<double>* > domain_grids(Domain *_domain);
+};
+
+#endif // end of _CHECKPOINT_HPP_
@@ -39,7 +39,7 @@ public:
 
   Collisions(void) {};
   Collisions(Geometry* _geometry, TimeSim *_time, vector <SpecieP *> _species_p);
-  ~Collisions(void) {};
+  virtual ~Collisions(void) {};
 
   void sort_to_cells();
   void random_sort();
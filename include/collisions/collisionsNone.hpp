@@ -0,0 +1,36 @@
+/*
+ * This file is part of the PiCoPiC distribution (https://github.com/cosmonaut-ok/PiCoPiC).
+ * Copyright (c) 2020 Alexander Vynnyk.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _COLLISIONS_NONE_HPP_
+#define _COLLISIONS_NONE_HPP_
+
+#include "collisions.hpp"
+
+//! Collisions policy for domains without coulomb collisions.
+//! Does nothing and is inlined away
+class CollisionsNone
+{
+public:
+  CollisionsNone(__attribute__((unused)) Geometry* _geometry,
+                 __attribute__((unused)) TimeSim *_time,
+                 __attribute__((unused)) vector <SpecieP *> _species_p) {};
+  ~CollisionsNone(void) {};
+
+  void operator()() {};
+};
+
+#endif // end of _COLLISIONS_NONE_HPP_
@@ -24,6 +24,7 @@
 #include "msg.hpp"
 
 #include "algo/grid3d.hpp"
+#include "algo/tileMap.hpp"
 #include "timeSim.hpp"
 #include "geometry.hpp"
 #include "specieP.hpp"
@@ -39,15 +40,104 @@ public:
   TimeSim *time;
   vector<SpecieP *> species_p;
   Grid3D<double> current;
-  
+  //! tiles of current grid, which could contain non-zero values
+  //! (weighted or overlaid with neighbour). Other tiles are zero,
+  //! so are not reset and overlaid. Should be touched by everyone,
+  //! who writes to grid
+  TileMap tiles;
+
   Current() {};
   Current(Geometry *geom, TimeSim *t, vector<SpecieP *> species) : geometry(geom), time(t)
   {
     current = Grid3D<double> (geometry->cell_amount[0], geometry->cell_amount[1], 2);
+    tiles = TileMap(geometry->cell_amount[0], geometry->cell_amount[1], 2);
     species_p = species;
 
-    current = 0;
-    current.overlay_set(0);
+    current.zero();
+  };
+
+  virtual ~Current() {};
+
+  void reset()
+  // zero touched tiles
+  {
+    if (! tiles.touched())
+      return;
+
+    for (unsigned int tx = 0; tx < tiles.x_tiles; ++tx)
+      for (unsigned int ty = 0; ty < tiles.y_tiles; ++ty)
+        if (tiles.touched(tx, ty))
+          current.zero(tiles.x_begin(tx), tiles.x_end(tx),
+                       tiles.y_begin(ty), tiles.y_end(ty));
+
+    tiles.clear();
+  };
+
+  void overlay_x(Current *rhs)
+  // overlay with next in x direction neighbour. Only columns
+  // of tiles, touched near common border in any of grids, are
+  // overlaid, as overlaying of zeros does nothing
+  {
+    int x_size = current[0].x_size;
+    int o_s = current[0].o_s;
+
+    if (! tiles.touched() && ! rhs->tiles.touched())
+      return;
+
+    for (unsigned int ty = 0; ty < tiles.y_tiles; ++ty)
+    {
+      int y_begin = tiles.y_begin(ty);
+      int y_end = tiles.y_end(ty);
+
+      if (tiles.touched(x_size - o_s, x_size + o_s - 1, y_begin, y_end)
+          || rhs->tiles.touched(-o_s, o_s - 1, y_begin, y_end))
+      {
+        current.overlay_x(rhs->current, y_begin, y_end);
+        tiles.touch(x_size - o_s, x_size + o_s - 1, y_begin, y_end);
+        rhs->tiles.touch(-o_s, o_s - 1, y_begin, y_end);
+      }
+    }
+  };
+
+  void overlay_y(Current *rhs)
+  // overlay with next in y direction neighbour. Only rows
+  // of tiles, touched near common border, are overlaid
+  {
+    int y_size = current[0].y_size;
+    int o_s = current[0].o_s;
+
+    if (! tiles.touched() && ! rhs->tiles.touched())
+      return;
+
+    for (unsigned int tx = 0; tx < tiles.x_tiles; ++tx)
+    {
+      int x_begin = tiles.x_begin(tx);
+      int x_end = tiles.x_end(tx);
+
+      if (tiles.touched(x_begin, x_end, y_size - o_s, y_size + o_s - 1)
+          || rhs->tiles.touched(x_begin, x_end, -o_s, o_s - 1))
+      {
+        current.overlay_y(rhs->current, x_begin, x_end);
+        tiles.touch(x_begin, x_end, y_size - o_s, y_size + o_s - 1);
+        rhs->tiles.touch(x_begin, x_end, -o_s, o_s - 1);
+      }
+    }
+  };
+
+  void overlay_xy(Current *rhs)
+  // overlay corner with next in x and y directions neighbour
+  {
+    int x_size = current[0].x_size;
+    int y_size = current[0].y_size;
+    int o_s = current[0].o_s;
+
+    if (tiles.touched(x_size - o_s, x_size + o_s - 1, y_size - o_s, y_size + o_s - 1)
+        || rhs->tiles.touched(-o_s, o_s - 1, -o_s, o_s - 1))
+    {
+      current.overlay_xy(rhs->current);
+      tiles.touch(x_size - o_s, x_size + o_s - 1, y_size - o_s, y_size + o_s - 1);
+      rhs->tiles.touch(-o_s, o_s - 1, -o_s, o_s - 1);
+    }
   };
 
   virtual void current_distribution() = 0;
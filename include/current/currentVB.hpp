@@ -19,6 +19,7 @@
 #define _CURRENT_VB_HPP_
 
 #include "current.hpp"
+#include "algo/vb.hpp"
 
 #define SOME_SHIT_DENSITY_STRICT(q, r, dr, dz, delta_t) \
   (q) / (constant::PI * 4. * (r) * (dz) * (dz) * (dr) * (delta_t));
@@ -45,16 +46,15 @@ public:
   void current_distribution();
 
 private:
+  //! trajectories segments of particles batch and their currents
+  algo::vb::Segments segments;
+  algo::vb::Currents segments_currents;
+
   void rz_current_distribution();
   void azimuthal_current_distribution();
 
-  void simple_current_distribution (double radius_new,
-                                    double longitude_new,
-                                    double radius_old,
-                                    double longitude_old,
-                                    int i_n,
-                                    int k_n,
-                                    double p_charge);
+  //! weight currents of collected segments to grid
+  void segments_distribution ();
 
   void strict_motion_distribution (double radius_new,
                                    double longitude_new,
@@ -19,26 +19,34 @@
 #define _CURRENT_ZIGZAG_
 
 #include "current.hpp"
+#include "algo/zigzag.hpp"
 
 using namespace std;
 
 class SpecieP;
 class Geometry;
 
-#define RELAY_POINT(i1, i2, x1, x2, dx)                           \
-  min( min((i1) * (dx), (i2) * (dx)) + (dx),                      \
-       max( max((i1) * (dx), (i2) * (dx)), ((x1) + (x2)) / 2.));
-
 class CurrentZigZag : public Current
 {
 public:
   CurrentZigZag() {};
-  CurrentZigZag(Geometry *geom, TimeSim *t, vector<SpecieP *> species) : Current(geom, t, species) {};
+  CurrentZigZag(Geometry *geom, TimeSim *t, vector<SpecieP *> species);
   ~CurrentZigZag() {};
 
   void current_distribution();
 
 private:
-
+  //! particles batch and their currents
+  algo::zigzag::Batch batch;
+
+  //! 1 / volume of cells for all radial cells numbers, which
+  //! particles of domain can have (including overlay),
+  //! starting from inv_volume_first
+  vector<double> inv_volume;
+  int inv_volume_first;
+
+  //! weight currents of particles batch to grid. Radial and
+  //! longitudinal currents are weighted only if ``rz_current'' is set
+  void batch_distribution (bool rz_current);
 };
 #endif // end of _CURRENT_ZIGZAG_
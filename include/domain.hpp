@@ -24,25 +24,11 @@
 #include "specieP.hpp"
 #include "beamP.hpp"
 
-#if defined(SWITCH_PUSHER_BORIS_ADAPTIVE) || defined(SWITCH_PUSHER_BORIS) || defined(SWITCH_PUSHER_BORIS_RELATIVISTIC)
-#include "pusher/pusherBoris.hpp"
-#elif defined(SWITCH_PUSHER_VAY)
-#include "pusher/pusherVay.hpp"
-#elif defined(SWITCH_PUSHER_HC)
-#include "pusher/pusherHC.hpp"
-#endif
-
-#ifdef SWITCH_MAXWELL_SOLVER_YEE
-#include "maxwellSolver/maxwellSolverYee.hpp"
-#endif
-
-#ifdef SWITCH_CCS_VB
-#include "current/currentVB.hpp"
-#elif defined(SWITCH_CCS_ZIGZAG)
-#include "current/currentZigZag.hpp"
-#endif
+#include "maxwellSolver.hpp"
+#include "current.hpp"
 
 #include "outWriter.hpp"
+#include "cfg.hpp"
 
 // #ifdef SWITCH_DENSITY_CALC_COUNTING
 // #include "density/densityCounted.hpp"
@@ -56,20 +42,21 @@
 // #include "temperature/temperatureWeighted.hpp"
 // #endif
 
-#ifdef ENABLE_COULOMB_COLLISIONS
-#ifdef SWITCH_COULOMB_COLLISIONS_TA77S
-#include "collisions/collisionsTA77S.hpp"
-#elif defined(SWITCH_COULOMB_COLLISIONS_SK98)
-#include "collisions/collisionsSK98.hpp"
-#elif defined(SWITCH_COULOMB_COLLISIONS_P12
-#include "collisions/collisionsP12.hpp"
-#endif
-#endif
-
 // #include "density/densityCharge.hpp"
 
 using namespace std;
 
+//! amount of extra cells, allocated for field grids
+//! in moving window mode, so grids are shifted without
+//! copying (see Grid::shift_y)
+#define WINDOW_SHIFT_RESERVE 64
+
+//! Simulation domain interface.
+//!
+//! Solvers are composed into domain at compile time by DomainT
+//! template (see domainT.hpp), so their kernels are called without
+//! virtual dispatch. Concrete domain is picked at runtime
+//! with Domain::create() from table of all available combinations.
 class Domain
 {
 public:
@@ -77,24 +64,11 @@ public:
   Current *current;
   vector<OutWriter> out_writers;
 
-#if defined(SWITCH_PUSHER_BORIS_ADAPTIVE) || defined(SWITCH_PUSHER_BORIS) || defined(SWITCH_PUSHER_BORIS_RELATIVISTIC)
-  PusherBoris *pusher;
-#elif defined(SWITCH_PUSHER_VAY)
-  PusherVay *pusher;
-#elif defined(SWITCH_PUSHER_HC)
-  PusherHC *pusher;
-#endif
-
-#ifdef SWITCH_MAXWELL_SOLVER_YEE
-  MaxwellSolverYee *maxwell_solver;
-#endif
+  MaxwellSolver *maxwell_solver;
 
   // Temperature *temperature;
   // Density *density;
   // DensityCharge *charge;
-#ifdef ENABLE_COULOMB_COLLISIONS
-  Collisions *collisions;
-#endif
 
   Geometry geometry;
 
@@ -103,28 +77,49 @@ public:
 public:
   Domain() {};
   Domain(Geometry _geometry, vector<SpecieP *> species_p, TimeSim* _time);
+  virtual ~Domain();
+
+  //! create domain with solvers, given by names
+  static Domain* create(const solvers_data &solvers, Geometry _geometry,
+                        vector<SpecieP *> _species_p, TimeSim* _time);
+  //! check if solvers combination is available
+  static bool available(const solvers_data &solvers);
+
+  // solver-dependent methods
+  virtual void push_particles() = 0;
+  virtual void weight_current() = 0;
+  virtual void weight_field_h() = 0;
+  virtual void weight_field_e() = 0;
+  virtual void weight_field_e_edge() = 0;
+  virtual void collide() = 0;
 
   // wrapper methods
   void distribute();
   void weight_density(string specie);
   void weight_temperature(string specie);
   void weight_charge(string specie);
-  void push_particles();
-  void weight_current();
   void update_particles_coords();
   // void weight_current_azimuthal();
   void reset_current();
   void reset_charge();
   void reset_field_e() {};
   void reset_field_h() {};
-  void weight_field_h();
-  void weight_field_e();
   void particles_back_velocity_to_rz();
   void particles_back_position_to_rz();
   void reflect();
   void manage_beam();
   void dump_particle_positions_to_old();
-  void collide();
   void bind_cell_numbers();
+  void resample_particles(unsigned int min_per_cell, unsigned int max_per_cell);
+  size_t particles_amount();
+
+  // moving window
+  vector< Grid3D<double> * > window_grids();
+  void reserve_window();
+  void prepare_window_shift(Domain *next_domain);
+  void shift_window();
+  void shift_window_geometry(size_t cells);
+  void load_window_edge();
+  void drop_window_tail();
 };
 #endif // end of _DOMAIN_HPP_
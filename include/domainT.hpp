@@ -0,0 +1,115 @@
+/*
+ * This file is part of the PiCoPiC distribution (https://github.com/cosmonaut-ok/PiCoPiC).
+ * Copyright (c) 2020 Alexander Vynnyk.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _DOMAIN_T_HPP_
+#define _DOMAIN_T_HPP_
+
+#include "domain.hpp"
+
+//! Simulation domain, composed from solver policies:
+//!
+//! * PusherT      - particles pusher (PusherBoris, PusherVay, PusherHC),
+//!                  parametrized with the same FieldSolverT
+//! * DepositT     - charge conservation current deposition (CurrentVB, CurrentZigZag)
+//! * FieldSolverT - maxwell solver (MaxwellSolverYee)
+//! * CollisionsT  - coulomb collisions (CollisionsNone, CollisionsTA77S,
+//!                  CollisionsSK98, CollisionsP12)
+//!
+//! Solvers are stored with concrete types, so calls to them
+//! are resolved at compile time. Only the per-step wrappers
+//! of Domain interface are virtual.
+template <class PusherT, class DepositT, class FieldSolverT, class CollisionsT>
+class DomainT : public Domain
+{
+public:
+  PusherT *pusher;
+  DepositT *deposit;
+  FieldSolverT *field_solver;
+  CollisionsT *collisions;
+
+public:
+  DomainT(Geometry _geometry, vector<SpecieP *> _species_p, TimeSim* _time)
+    : Domain(_geometry, _species_p, _time)
+  {
+    deposit = new DepositT(&geometry, time, species_p);
+    field_solver = new FieldSolverT(&geometry, time, species_p, deposit);
+    collisions = new CollisionsT(&geometry, time, species_p);
+
+    // generic pointers, used by SMB and output
+    current = deposit;
+    maxwell_solver = field_solver;
+
+    // ! Linking classes:
+    // ! * insert field pointers to each particles specie
+    for (auto sp = species_p.begin(); sp != species_p.end(); ++sp)
+      (**sp).maxwell_solver = maxwell_solver;
+
+    pusher = new PusherT(field_solver, species_p, time);
+  };
+
+  ~DomainT()
+  {
+    delete pusher;
+    delete collisions;
+    delete field_solver;
+    delete deposit;
+  };
+
+  void push_particles()
+  {
+    // collect fields for sub-cycled species
+    for (auto sp = species_p.begin(); sp != species_p.end(); ++sp)
+      (**sp).accumulate_fields();
+
+    pusher->PusherT::operator()();
+
+    for (auto sp = species_p.begin(); sp != species_p.end(); ++sp)
+      if ((**sp).push_every > 1 && (**sp).is_push_step())
+        (**sp).reset_fields();
+  };
+
+  void weight_current()
+  {
+    // there is nothing to weight in particles-free domain
+    if (particles_amount() == 0)
+      return;
+
+    deposit->DepositT::current_distribution();
+  };
+
+  void weight_field_h()
+  {
+    field_solver->FieldSolverT::calc_field_h();
+  };
+
+  void weight_field_e()
+  {
+    field_solver->FieldSolverT::calc_field_e();
+  };
+
+  void weight_field_e_edge()
+  {
+    field_solver->FieldSolverT::calc_field_e_edge();
+  };
+
+  void collide()
+  {
+    collisions->CollisionsT::operator()();
+  };
+};
+
+#endif // end of _DOMAIN_T_HPP_
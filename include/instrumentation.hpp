@@ -0,0 +1,133 @@
+/*
+ * This file is part of the PiCoPiC distribution (https://github.com/cosmonaut-ok/PiCoPiC).
+ * Copyright (c) 2020 Alexander Vynnyk.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _INSTRUMENTATION_HPP_
+#define _INSTRUMENTATION_HPP_
+
+#include "defines.hpp"
+
+#ifdef ENABLE_INSTRUMENTATION
+
+#include <string>
+#include <vector>
+#include <chrono>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif // _OPENMP
+
+#ifdef ENABLE_MPI
+#include <mpi.h>
+#endif // ENABLE_MPI
+
+//! Lightweight per-phase profiling layer of the main loop.
+//!
+//! Time of every phase and counters are accumulated per thread
+//! and per domain (domain ``-1'' means whole SMB, e.g. overlays
+//! and output). Every thread writes only to it's own records,
+//! so no locks/atomics are required. Accumulated (cumulative)
+//! values are dumped to JSON-lines or CSV file with ``dump''.
+//!
+//! Use INSTR_* macros in the code: they expand to nothing,
+//! when application is built without ENABLE_INSTRUMENTATION
+namespace instrumentation
+{
+  enum phase
+  {
+    INJECT_BEAM = 0,
+    SOLVE_E,
+    OVERLAY_E,
+    SOLVE_H,
+    OVERLAY_H,
+    PUSH,
+    COLLIDE,
+    MOVE,
+    REFLECT,
+    RUNAWAY_COLLECTOR,
+    SOLVE_CURRENT,
+    OVERLAY_CURRENT,
+    RESAMPLE,
+    OUT_CONTROLLER,
+    PHASES_AMOUNT
+  };
+
+  enum counter
+  {
+    PARTICLES_PUSHED = 0,
+    PARTICLES_MIGRATED,
+    BYTES_WRITTEN,
+    MPI_BYTES,
+    COUNTERS_AMOUNT
+  };
+
+  //! initialize records for ``domains_amount'' domains and
+  //! all available threads. Should be called outside of parallel region.
+  //! Without ``init'' (e.g. in benchmark mode) measurements are dropped
+  void init(unsigned int domains_amount, std::string path, std::string format, int world_rank);
+
+  void add_time(phase p, int domain, double seconds);
+  void count(counter c, int domain, unsigned long value);
+
+#ifdef ENABLE_MPI
+  //! count bytes of ``amount'' elements of MPI datatype
+  void count_mpi(int domain, MPI_Datatype dtype, int amount);
+#endif // ENABLE_MPI
+
+  //! write accumulated values to instrumentation file
+  void dump(int step);
+
+  class ScopedTimer
+  {
+  public:
+    ScopedTimer(phase _p, int _domain)
+      : p(_p), domain(_domain), start(std::chrono::steady_clock::now()) {};
+
+    ~ScopedTimer()
+    {
+      std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      add_time(p, domain, elapsed.count());
+    };
+
+  private:
+    phase p;
+    int domain;
+    std::chrono::steady_clock::time_point start;
+  };
+}
+
+#define INSTR_CONCAT_(a, b) a##b
+#define INSTR_CONCAT(a, b) INSTR_CONCAT_(a, b)
+
+#define INSTR_SCOPE(p, domain)                                          \
+  instrumentation::ScopedTimer INSTR_CONCAT(instr_timer_, __LINE__) (instrumentation::p, domain)
+#define INSTR_COUNT(c, domain, value)                                   \
+  instrumentation::count(instrumentation::c, domain, value)
+
+#ifdef ENABLE_MPI
+#define INSTR_COUNT_MPI(domain, dtype, amount)  \
+  instrumentation::count_mpi(domain, dtype, amount)
+#endif // ENABLE_MPI
+
+#else
+
+#define INSTR_SCOPE(p, domain)
+#define INSTR_COUNT(c, domain, value)
+#define INSTR_COUNT_MPI(domain, dtype, amount)
+
+#endif // ENABLE_INSTRUMENTATION
+
+#endif // _INSTRUMENTATION_HPP_
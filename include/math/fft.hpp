@@ -0,0 +1,104 @@
+/*
+ * This file is part of the PiCoPiC distribution (https://github.com/cosmonaut-ok/PiCoPiC).
+ * Copyright (c) 2020 Alexander Vynnyk.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _FFT_HPP_
+#define _FFT_HPP_
+
+#include <math.h>
+#include <complex>
+#include <vector>
+
+#include "defines.hpp"
+#include "msg.hpp"
+
+#include "constant.hpp"
+
+namespace math::fft
+{
+  inline bool is_power_of_2(size_t n)
+  {
+    return n > 0 && (n & (n - 1)) == 0;
+  }
+
+  // in-place iterative radix-2 Cooley-Tukey FFT.
+  // Size of data should be power of 2
+  inline void fft(std::vector< std::complex<double> > &data)
+  {
+    size_t n = data.size();
+
+    if (! is_power_of_2(n))
+      LOG_S(FATAL) << "FFT size should be power of 2, but it is " << n;
+
+    // bit-reversal permutation
+    for (size_t i = 1, j = 0; i < n; ++i)
+    {
+      size_t bit = n >> 1;
+      for (; j & bit; bit >>= 1)
+        j ^= bit;
+      j ^= bit;
+
+      if (i < j)
+        std::swap(data[i], data[j]);
+    }
+
+    // butterflies
+    for (size_t len = 2; len <= n; len <<= 1)
+    {
+      double angle = -2. * constant::PI / len;
+      std::complex<double> w_len (cos(angle), sin(angle));
+
+      for (size_t i = 0; i < n; i += len)
+      {
+        std::complex<double> w (1., 0.);
+        for (size_t k = 0; k < len / 2; ++k)
+        {
+          std::complex<double> u = data[i + k];
+          std::complex<double> v = data[i + k + len / 2] * w;
+          data[i + k] = u + v;
+          data[i + k + len / 2] = u - v;
+          w *= w_len;
+        }
+      }
+    }
+  }
+
+  // one-sided power spectrum of Hann-windowed real signal:
+  // |X_k|^2 / N^2 for k = 0..N/2
+  inline std::vector<double> power_spectrum(const std::vector<double> &signal)
+  {
+    size_t n = signal.size();
+    std::vector< std::complex<double> > data (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+      double hann = 0.5 * (1. - cos(2. * constant::PI * i / (n - 1)));
+      data[i] = std::complex<double> (signal[i] * hann, 0.);
+    }
+
+    fft(data);
+
+    std::vector<double> spectrum (n / 2 + 1);
+    double n_2_inv = 1. / ((double)n * n);
+
+    for (size_t k = 0; k <= n / 2; ++k)
+      spectrum[k] = std::norm(data[k]) * n_2_inv;
+
+    return spectrum;
+  }
+}
+
+#endif // end of _FFT_HPP_
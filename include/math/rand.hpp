@@ -19,6 +19,8 @@
 #define _RAND_HPP_
 
 #include <random>
+#include <string>
+#include <sstream>
 
 #include "defines.hpp"
 #include "constant.hpp"
@@ -34,6 +36,13 @@ namespace math::random
   double uniform_angle();
   double normal(double stddev);
   double random_reverse(double vel, int power);
+
+  // set fixed seed (e.g. for reproducible benchmarks)
+  void seed(unsigned int value);
+
+  // serialize/restore generator state (e.g. for checkpoints)
+  string get_state();
+  void set_state(string state);
 }
 
 #endif // end of _RAND_HPP_
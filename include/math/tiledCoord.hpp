@@ -0,0 +1,104 @@
+/*
+ * This file is part of the PiCoPiC distribution (https://github.com/cosmonaut-ok/PiCoPiC).
+ * Copyright (c) 2020 Alexander Vynnyk.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TILED_COORD_HPP_
+#define _TILED_COORD_HPP_
+
+#include <math.h>
+#include <stdint.h>
+
+#include "defines.hpp"
+
+//! size of tile in meters (~1 um; range of int32 tiles is ~2 km).
+//! Power of 2, so tile origins are exact
+#define TILED_COORD_TILE (1. / 1048576.)
+#define TILED_COORD_TILE_INV 1048576.
+
+//! Coordinate, stored as integer tile number and single-precision
+//! offset inside the tile (in tile units, [0, 1)).
+//!
+//! Absolute precision is the same for every point of the domain
+//! (~1e-13 m), so small particle displacements are not lost,
+//! as it happens with plain float coordinates far from the origin.
+//! All of the arithmetic is done in double: value is converted to
+//! double on read and split back into tile and offset on write.
+class tiled_coord
+{
+  int32_t tile;
+  float offset;
+
+public:
+  tiled_coord() : tile(0), offset(0) {};
+  tiled_coord(double value)
+  {
+    set(value);
+  };
+
+  operator double() const
+  {
+    return ((double)tile + (double)offset) * TILED_COORD_TILE;
+  };
+
+  tiled_coord& operator= (double value)
+  {
+    set(value);
+    return *this;
+  };
+
+  tiled_coord& operator+= (double value)
+  {
+    set((double)(*this) + value);
+    return *this;
+  };
+
+  tiled_coord& operator-= (double value)
+  {
+    set((double)(*this) - value);
+    return *this;
+  };
+
+  tiled_coord& operator*= (double value)
+  {
+    set((double)(*this) * value);
+    return *this;
+  };
+
+  tiled_coord& operator/= (double value)
+  {
+    set((double)(*this) / value);
+    return *this;
+  };
+
+private:
+  void set(double value)
+  {
+    double t = value * TILED_COORD_TILE_INV;
+    double t_floor = floor(t);
+
+    tile = (int32_t)t_floor;
+    offset = (float)(t - t_floor);
+
+    // offset could be rounded up to the next tile
+    if (offset >= 1.f)
+    {
+      ++tile;
+      offset = 0;
+    }
+  };
+};
+
+#endif // end of _TILED_COORD_HPP_
@@ -36,7 +36,7 @@ class MaxwellSolver
 
 public:
   Grid3D<double> field_e;
-  Grid3D<double> field_h;
+  Grid3D<double> field_h; // magnetic field, synchronized in time with electric one
 
 protected:
   Geometry *geometry;
@@ -74,7 +74,7 @@ public:
     sigma.overlay_set(0.);
   };
 
-  ~MaxwellSolver(void) {};
+  virtual ~MaxwellSolver(void) {};
 
   vector3d<double> get_field_dummy(__attribute__((unused)) double radius, __attribute__((unused)) double longitude)
   {
@@ -86,6 +86,9 @@ public:
   virtual void set_pml() = 0;
   virtual void calc_field_h() = 0;
   virtual void calc_field_e() = 0;
+  //! electric field, which depends on magnetic field of
+  //! neighbour domains. Called after magnetic field overlay
+  virtual void calc_field_e_edge() = 0;
   virtual vector3d<double> get_field_h(double radius, double longitude) = 0;
   virtual vector3d<double> get_field_e(double radius, double longitude) = 0;
 };
@@ -23,9 +23,6 @@
 class MaxwellSolverYee : public MaxwellSolver
 {
 
-public:
-  Grid3D<double> field_h_at_et;
-
 private:
   // internal variables to calculation for dielectric walls
   unsigned int r_begin;
@@ -33,6 +30,9 @@ private:
   unsigned int r_end;
   unsigned int z_end;
 
+  void half_step_field_h(int i, int k_begin, int k_end);
+  void calc_field_e_row(unsigned int i, unsigned int k_begin, unsigned int k_end);
+
 public:
   MaxwellSolverYee ( void ) {};
   MaxwellSolverYee ( Geometry *_geometry, TimeSim *_time,
@@ -43,8 +43,20 @@ public:
   void set_pml();
   void calc_field_h();
   void calc_field_e();
-  vector3d<double> get_field_h(double radius, double longitude);
-  vector3d<double> get_field_e(double radius, double longitude);
+  void calc_field_e_edge();
+  vector3d<double> get_field_h(double radius, double longitude)
+  {
+    return get_field_h(field_h, radius, longitude);
+  };
+  vector3d<double> get_field_e(double radius, double longitude)
+  {
+    return get_field_e(field_e, radius, longitude);
+  };
+
+  //! interpolate custom field grid (e.g. averaged over sub-cycle)
+  //! at particle position
+  vector3d<double> get_field_h(Grid3D<double> &field, double radius, double longitude);
+  vector3d<double> get_field_e(Grid3D<double> &field, double radius, double longitude);
 };
 
 #endif // end of _MAXWELLSOLVERYEE_HPP_
@@ -19,6 +19,8 @@
 #define _OUT_CONTROLLER_HPP_
 
 #include <string>
+#include <algorithm>
+#include <utility>
 #include <highfive/H5File.hpp>
 
 #include "picojson.h"
@@ -54,11 +56,11 @@ public:
 #ifdef ENABLE_HDF5
   OutController(HighFive::File *_file, Geometry *_geometry, TimeSim *_time,
                 vector<probe> &_probes, SMB *_smb, picojson::value _metadata,
-		bool _print_progress_table);
+		bool _print_progress_table, bool _restart = false);
 #else
   OutController(Geometry *_geometry, TimeSim *_time,
                 vector<probe> &_probes, SMB *_smb, picojson::value _metadata,
-		bool _print_progress_table);
+		bool _print_progress_table, bool _restart = false);
 #endif
   ~OutController() {};
 
@@ -66,6 +68,8 @@ public:
 
 private:
   void init_datasets();
+  SpecieP* find_specie(Domain *_domain, string _name);
+  vector<size_t> dataset_size(probe &_probe);
   bool print_progress_table;
 };
 
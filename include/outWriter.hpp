@@ -20,10 +20,15 @@
 
 #include <string>
 #include <vector>
+#include <math.h>
+#include <algorithm>
 
 #include "algo/grid.hpp"
 #include "algo/grid3d.hpp"
 #include "timeSim.hpp"
+#include "math/fft.hpp"
+#include "algo/serialize.hpp"
+#include "instrumentation.hpp"
 
 #ifdef ENABLE_HDF5
 #include "outEngine/outEngineHDF5.hpp"
@@ -43,22 +48,59 @@ private:
   Grid<double> *values;
   std::string path;
 
+  // time reduction: 0 - none (instant values); 1 - average; 2 - min; 3 - max; 4 - rms;
+  // 5 - spectrum (power spectrum of last ``window'' samples)
+  unsigned short time_reduce;
+  unsigned int sample; // accumulate values every ``sample'' steps
+  // space reduction: 0 - none; 1 - pick every ``factor''-th cell; 2 - average blocks of ``factor'' cells
+  unsigned short space_reduce;
+  unsigned int factor;
+
+  // accumulated (time-reduced) values and amount of samples in it
+  std::vector<double> accumulator;
+  unsigned int samples_amount;
+
+  // rolling window of samples for spectral probe: [point][sample]
+  unsigned int window;
+  std::vector< std::vector<double> > window_data;
+  size_t window_head;
+
+  std::vector<size_t> slice_size(); // size of values slice, before space reduction
+  std::vector<double> get_slice(); // get values slice, as flat array
+  std::vector<double> reduce_space(std::vector<double> data, std::vector<size_t> &data_size);
+  void accumulate(std::vector<double> &data);
+  void accumulate_window(std::vector<double> &data);
+  void write_spectrum(size_t slice, size_t points);
+  void write(size_t slice, std::vector<double> &data, std::vector<size_t> &data_size);
+
 public:
   OutWriter () {};
   OutWriter ( std::string _path, unsigned short _shape,
               std::vector<short> _position, std::vector<size_t> _engine_offset,
               unsigned short _schedule, bool _append, unsigned short _compress,
-              TimeSim *_time, Grid<double> *_values );
+              TimeSim *_time, Grid<double> *_values,
+              unsigned short _time_reduce = 0, unsigned int _sample = 1,
+              unsigned short _space_reduce = 0, unsigned int _factor = 1,
+              unsigned int _window = 0 );
 
 #ifdef ENABLE_HDF5
   OutWriter ( HighFive::File* _file, std::string _path, unsigned short _shape,
               std::vector<short> _position, std::vector<size_t> _engine_offset,
               unsigned short _schedule, bool _append, unsigned short _compress,
-              TimeSim *_time, Grid<double> *_values );
+              TimeSim *_time, Grid<double> *_values,
+              unsigned short _time_reduce = 0, unsigned int _sample = 1,
+              unsigned short _space_reduce = 0, unsigned int _factor = 1,
+              unsigned int _window = 0 );
 #endif // ENABLE_HDF5
 
   void operator()();
 
+  //! time reduction state (accumulated values and spectral
+  //! window), which is saved to checkpoint
+  size_t state_size();
+  void state_serialize(char *&_buffer);
+  void state_deserialize(const char *&_buffer);
+
 #ifdef ENABLE_HDF5
   HighFive::File *hdf5_file;
 #endif
@@ -25,11 +25,27 @@
 #include "msg.hpp"
 
 #include "math/vector3d.hpp"
+#include "algo/simd.hpp"
 
 namespace phys::rel
 {
   double lorenz_factor (double sq_velocity);
-  double lorenz_factor_inv (double sq_velocity);
+
+  //! lorenz factor without checks of velocity, so it is
+  //! branchless and inlined. Velocity should be validated
+  //! before (beta < 1), e.g. by pusher
+  inline double lorenz_factor_unchecked (double sq_velocity)
+  {
+    return algo::simd::rsqrt(1.0 - sq_velocity / constant::LIGHT_VEL_POW_2);
+  }
+
+  //! takes squared momentum per unit mass (u = gamma * v)
+  //! and returns 1 / gamma, which is always real
+  inline double lorenz_factor_inv (double sq_momentum)
+  {
+    return algo::simd::rsqrt(1.0 + sq_momentum / constant::LIGHT_VEL_POW_2);
+  }
+
   double energy (double mass, double velocity_2); // mass and velocity powered to 2
   double energy_m (double mass, double momentum_2);  // mass and momentum powered to 2
 
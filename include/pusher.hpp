@@ -22,13 +22,18 @@
 #include "msg.hpp"
 #include "specieP.hpp"
 
-#ifdef SWITCH_MAXWELL_SOLVER_YEE
 #include "maxwellSolver/maxwellSolverYee.hpp"
-#endif
 
 // class MaxwellSolver;
 // class SpecieP;
 
+//! particles store momentum per unit mass instead of velocity
+#ifdef ENABLE_MOMENTUM
+constexpr bool momentum_representation = true;
+#else
+constexpr bool momentum_representation = false;
+#endif // ENABLE_MOMENTUM
+
 class Pusher
 {
 protected:
@@ -45,7 +50,42 @@ public:
     species_p = _species_p;
   };
 
+  virtual ~Pusher() {};
+
   virtual void operator()() = 0;
+
+protected:
+  //! particles are checked in push loop without branches: validity
+  //! flags are accumulated and reported after push of specie.
+  //! Positions should be valid numbers and velocities should be
+  //! less, than speed of light (if check_velocity)
+  bool valid_particle(Particle &p, bool check_velocity)
+  {
+    double pos_r = P_POS_R(p);
+    double pos_z = P_POS_Z(p);
+
+    return isfinite(pos_r) && isfinite(pos_z)
+      && (! check_velocity || particle_velocity(p).length2() < constant::LIGHT_VEL_POW_2);
+  };
+
+  //! find invalid particle of specie and report it
+  void report_invalid(SpecieP *specie, bool check_velocity)
+  {
+    for (auto p = specie->particles.begin(); p != specie->particles.end(); ++p)
+      if (! valid_particle(**p, check_velocity))
+      {
+        double pos_r = P_POS_R((**p));
+        double pos_z = P_POS_Z((**p));
+
+        if (! isfinite(pos_r) || ! isfinite(pos_z))
+          LOG_S(FATAL) << "(pusher): radius[" << pos_r
+                       << "] or longitude[" << pos_z
+                       << "] is not valid number. Can not continue.";
+        else
+          LOG_S(FATAL) << "(pusher): Lorentz factor aka gamma is complex. Velocity is: "
+                       << particle_velocity(**p).length();
+      }
+  };
 };
 
 #endif // end of _PUSHER_HPP_
@@ -0,0 +1,52 @@
+/*
+ * This file is part of the PiCoPiC distribution (https://github.com/cosmonaut-ok/PiCoPiC).
+ * Copyright (c) 2020 Alexander Vynnyk.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _PUSHERBATCH_HPP_
+#define _PUSHERBATCH_HPP_
+
+#include "pusher.hpp"
+#include "algo/push.hpp"
+
+//! base of relativistic pushers, which push particles in batches.
+//! Gather stage (momentums and fields at particles positions) and
+//! scatter stage are shared, pusher provides only batch kernel.
+//! FieldSolver is a concrete maxwell solver class,
+//! so fields are interpolated without virtual calls
+template <class FieldSolver>
+class PusherBatch : public Pusher
+{
+protected:
+  FieldSolver *field_solver;
+
+public:
+  PusherBatch (FieldSolver *_maxwell_solver, vector<SpecieP *> _species_p, TimeSim *_time)
+    : Pusher(_maxwell_solver, _species_p, _time), field_solver(_maxwell_solver) {};
+
+protected:
+  //! push particles of all species with kernel
+  void push (void (*kernel)(algo::push::Batch &, double));
+
+  //! gather momentums of particles and fields at their positions
+  //! to batch. Returns true, if all of the particles are valid
+  bool gather (algo::push::Batch &batch, Particle **particles, size_t size,
+               Grid3D<double> &field_e, Grid3D<double> &field_h, bool check_velocity);
+
+  //! store new momentums of particles
+  void scatter (algo::push::Batch &batch, Particle **particles);
+};
+
+#endif // end of _PUSHERBATCH_HPP_
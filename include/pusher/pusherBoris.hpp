@@ -20,11 +20,24 @@
 
 #include "pusher.hpp"
 
+//! Boris pusher variants
+#define BORIS_CLASSIC 0 // non-relativistic
+#define BORIS_ADAPTIVE 1 // relativistic only for velocities over REL_LIMIT
+#define BORIS_RELATIVISTIC 2 // always relativistic
+// in momentum representation push is always relativistic,
+// as it costs single inverse square root: variant is ignored
+
+//! FieldSolver is a concrete maxwell solver class,
+//! so fields are interpolated without virtual calls
+template <class FieldSolver, int variant>
 class PusherBoris : public Pusher
 {
+protected:
+  FieldSolver *field_solver;
+
 public:
-  PusherBoris (MaxwellSolver *_maxwell_solver, vector<SpecieP *> _species_p, TimeSim *_time)
-    : Pusher(_maxwell_solver, _species_p, _time) {};
+  PusherBoris (FieldSolver *_maxwell_solver, vector<SpecieP *> _species_p, TimeSim *_time)
+    : Pusher(_maxwell_solver, _species_p, _time), field_solver(_maxwell_solver) {};
 
   void operator()();
 };
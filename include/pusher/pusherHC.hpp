@@ -18,13 +18,16 @@
 #ifndef _PUSHERHC_HPP_
 #define _PUSHERHC_HPP_
 
-#include "pusher.hpp"
+#include "pusher/pusherBatch.hpp"
 
-class PusherHC : public Pusher
+//! Higuera-Cary pusher. Particles are pushed in batches
+//! (see PusherBatch and algo::push)
+template <class FieldSolver>
+class PusherHC : public PusherBatch<FieldSolver>
 {
 public:
-  PusherHC (MaxwellSolver *_maxwell_solver, vector<SpecieP *> _species_p, TimeSim *_time)
-    : Pusher(_maxwell_solver, _species_p, _time) {};
+  PusherHC (FieldSolver *_maxwell_solver, vector<SpecieP *> _species_p, TimeSim *_time)
+    : PusherBatch<FieldSolver>(_maxwell_solver, _species_p, _time) {};
 
   void operator()();
 };
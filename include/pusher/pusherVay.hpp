@@ -18,13 +18,16 @@
 #ifndef _PUSHERVAY_HPP_
 #define _PUSHERVAY_HPP_
 
-#include "pusher.hpp"
+#include "pusher/pusherBatch.hpp"
 
-class PusherVay : public Pusher
+//! Vay pusher. Particles are pushed in batches
+//! (see PusherBatch and algo::push)
+template <class FieldSolver>
+class PusherVay : public PusherBatch<FieldSolver>
 {
 public:
-  PusherVay (MaxwellSolver *_maxwell_solver, vector<SpecieP *> _species_p, TimeSim *_time)
-    : Pusher(_maxwell_solver, _species_p, _time) {};
+  PusherVay (FieldSolver *_maxwell_solver, vector<SpecieP *> _species_p, TimeSim *_time)
+    : PusherBatch<FieldSolver>(_maxwell_solver, _species_p, _time) {};
 
   void operator()();
 };
@@ -28,8 +28,10 @@
 #include "math/vector3d.hpp"
 #include "math/rand.hpp"
 #include "math/maxwellJuettner.hpp"
+#include "math/tiledCoord.hpp"
 #include "phys/rel.hpp"
 #include "algo/weighter.hpp"
+#include "algo/grid3d.hpp"
 
 #ifdef SWITCH_MAXWELL_SOLVER_YEE
 #include "maxwellSolver/maxwellSolverYee.hpp"
@@ -43,6 +45,18 @@ using namespace std;
 //! define service constant "particle`s vector size"
 #define P_BLOCK_AMOUNT 15
 
+//! amount of moments (density, p_r, p_phi, p_z, p_abs),
+//! weighted at once to calculate temperature
+#define TEMP_CALC_MOMENTS_AMOUNT 5
+
+//! amount of particles, which absolute velocities and lorenz
+//! factors are calculated at once with batch math to calculate temperature
+#define TEMP_CALC_BLOCK_SIZE 256
+
+//! amount of particles, processed by single task, when particles
+//! of domain are pushed, moved and reflected in parallel
+#define PARTICLES_CHUNK_SIZE 2048
+
 // getters from particle directly
 #define P_POS_R(var) var.pos_r
 #define P_POS_PHI(var) var.pos_phi
@@ -68,23 +82,35 @@ using namespace std;
 #define P_MARK(var) var.mark
 #define P_SPECIE_ID(var) var.specie_id
 
+//! particle storage types. In mixed precision mode r and z
+//! coordinates are stored tile-relative (see tiled_coord),
+//! velocities, weight and angles are stored in single precision.
+//! All of the calculations and grids accumulation are done in double
+#ifdef ENABLE_MIXED_PRECISION
+typedef tiled_coord particle_coord;
+typedef float particle_real;
+#else
+typedef double particle_coord;
+typedef double particle_real;
+#endif // ENABLE_MIXED_PRECISION
+
 typedef struct Particle_struct
 {
 // getters from particle directly
-  double pos_r;
-  double pos_phi;
-  double pos_z;
+  particle_coord pos_r;
+  particle_real pos_phi;
+  particle_coord pos_z;
 
-  double pos_old_r;
-  double pos_old_phi;
-  double pos_old_z;
+  particle_coord pos_old_r;
+  particle_real pos_old_phi;
+  particle_coord pos_old_z;
 
-  double vel_r;
-  double vel_phi;
-  double vel_z;
+  particle_real vel_r;
+  particle_real vel_phi;
+  particle_real vel_z;
 
-  double weight;
-  double sin;
+  particle_real weight;
+  particle_real sin;
 
   size_t cell_r;
   size_t cell_z;
@@ -115,6 +141,54 @@ typedef struct Particle_struct
   }
 } Particle;
 
+//! In momentum representation (ENABLE_MOMENTUM) particle's velocity
+//! components store momentum per unit mass u = gamma * v, so
+//! relativistic push needs single inverse square root and has no
+//! checks. Physical velocity is u / gamma. P_GAMMA_INV converts
+//! stored components to velocity, VEL_TO_STORED - back
+//! (velocity should be validated by caller, to be less, than speed of light)
+#ifdef ENABLE_MOMENTUM
+#define P_GAMMA_INV(var) phys::rel::lorenz_factor_inv(P_VEL_R(var) * P_VEL_R(var) \
+                                                      + P_VEL_PHI(var) * P_VEL_PHI(var) \
+                                                      + P_VEL_Z(var) * P_VEL_Z(var))
+#define VEL_TO_STORED(sq_velocity) phys::rel::lorenz_factor_unchecked(sq_velocity)
+#else
+#define P_GAMMA_INV(var) 1.
+#define VEL_TO_STORED(sq_velocity) 1.
+#endif // ENABLE_MOMENTUM
+
+//! physical velocity of particle and its setters
+inline void particle_velocity (Particle &p, double &vel_r, double &vel_phi, double &vel_z)
+{
+  double gamma_inv = P_GAMMA_INV(p);
+
+  vel_r = P_VEL_R(p) * gamma_inv;
+  vel_phi = P_VEL_PHI(p) * gamma_inv;
+  vel_z = P_VEL_Z(p) * gamma_inv;
+}
+
+inline vector3d<double> particle_velocity (Particle &p)
+{
+  vector3d<double> velocity;
+  particle_velocity(p, velocity[0], velocity[1], velocity[2]);
+
+  return velocity;
+}
+
+inline void set_particle_velocity (Particle &p, double vel_r, double vel_phi, double vel_z)
+{
+  double stored = VEL_TO_STORED(vel_r * vel_r + vel_phi * vel_phi + vel_z * vel_z);
+
+  P_VEL_R(p) = vel_r * stored;
+  P_VEL_PHI(p) = vel_phi * stored;
+  P_VEL_Z(p) = vel_z * stored;
+}
+
+inline void set_particle_velocity (Particle &p, vector3d<double> velocity)
+{
+  set_particle_velocity(p, velocity[0], velocity[1], velocity[2]);
+}
+
 class FieldE;
 class FieldH;
 class MaxwellSolver;
@@ -173,6 +247,18 @@ public:
   Grid<double> p_z;
   Grid<double> count;
 
+  //! diagnostics cache: density_map and temperature_map
+  //! are valid until particles are moved next time
+  bool density_map_valid;
+  bool temperature_map_valid;
+
+  //! sub-cycling: specie is pushed once per push_every time
+  //! steps with fields, accumulated over the sub-cycle
+  unsigned int push_every;
+  unsigned int field_samples;
+  Grid3D<double> field_e_sum;
+  Grid3D<double> field_h_sum;
+
   double start_time;
   double bunch_length;
   double bunches_distance;
@@ -194,7 +280,7 @@ public:
           TimeSim *t
     );
 
-  ~SpecieP();
+  virtual ~SpecieP();
 
   MaxwellSolver* maxwell_solver;
 
@@ -210,6 +296,9 @@ public:
                                         unsigned int left_cell_number,
                                         unsigned int right_cell_number);
 
+  void load_plasma (unsigned int left_cell_number,
+                    unsigned int right_cell_number);
+
   virtual void velocity_distribution ();
   virtual void inject();
   void inject_bunch();
@@ -222,9 +311,17 @@ public:
   void back_velocity_to_rz();
   void dump_position_to_old();
   void bind_cell_numbers ();
+  void resample (unsigned int min_per_cell, unsigned int max_per_cell);
+
+  void set_push_every (unsigned int steps);
+  bool is_push_step ();
+  double push_step ();
+  void accumulate_fields ();
+  void reset_fields ();
 
   void calc_density ();
   void calc_temperature ();
+  void invalidate_diagnostics ();
 
 protected:
   void rectangular_random_placement (unsigned int int_cell_number,
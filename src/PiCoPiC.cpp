@@ -20,6 +20,7 @@
 #include <unistd.h>
 #include <vector>
 #include <string>
+#include <fstream>
 #include <atomic>         // std::atomic, std::memory_order_relaxed
 
 #include "defines.hpp"
@@ -38,9 +39,18 @@ using namespace MPI;
 #include "outController.hpp"
 #include "specieP.hpp"
 #include "beamP.hpp"
+#include "checkpoint.hpp"
+#include "instrumentation.hpp"
+#include "benchmark.hpp"
 
 using namespace std;
 
+// checkpoint on termination is requested (signals TERM/INT).
+// Keeps number of received signal. Only flag is set in handler,
+// because logging is not async-signal-safe
+volatile sig_atomic_t checkpoint_requested_ = 0;
+volatile sig_atomic_t checkpoint_enabled = 0;
+
 #ifdef ENABLE_HDF5
 #include <highfive/H5File.hpp>
 
@@ -76,6 +86,15 @@ void signal_handler( int signum )
   }
 #endif // ENABLE_HDF5
 
+  // save checkpoint at the end of current step and exit,
+  // instead of immediate exit (repeated signal exits immediately)
+  if (checkpoint_enabled && !checkpoint_requested_
+      && (signum == SIGTERM || signum == SIGINT))
+  {
+    checkpoint_requested_ = signum;
+    return;
+  }
+
   // exit
   if ( signum == SIGINT
        || signum == SIGQUIT
@@ -104,7 +123,11 @@ string parse_argv_get_config(int argc, char **argv)
 
   if (algo::common::cmd_option_exists(argv, argv+argc, "-h"))
   {
-    cerr << "USAGE:" << endl << "  picopic [ --version | -f path/to/PiCoPiC.json ]" << endl;
+    cerr << "USAGE:" << endl << "  picopic [ --version | -f path/to/PiCoPiC.json ]" << endl
+         << "  picopic --benchmark uniform|beam|collisions [ --benchmark-steps N ]" << endl
+         << "          [ --benchmark-threads 1,2,4 ] [ --benchmark-domains 2x4,4x8 ]" << endl
+         << "          [ --benchmark-solvers boris:vb,vay:zigzag ]" << endl
+         << "          [ --benchmark-output path/to/report.json ]" << endl;
     exit(1);
   }
 
@@ -128,6 +151,61 @@ string parse_argv_get_config(int argc, char **argv)
   return filename;
 }
 
+//! run built-in benchmark if ``--benchmark'' option given
+//! returns false otherwise
+bool run_benchmark(int argc, char **argv)
+{
+  if (!algo::common::cmd_option_exists(argv, argv+argc, "--benchmark"))
+    return false;
+
+#ifdef ENABLE_MPI
+  LOG_S(FATAL) << "Benchmark mode is not supported with MPI";
+#endif // ENABLE_MPI
+
+  // value of given option, should not be empty
+  auto option_value = [argc, argv](const string &option) -> string
+  {
+    char *value = algo::common::get_cmd_option(argv, argv + argc, option);
+    if (!value)
+      LOG_S(FATAL) << "Option ``" << option << "'' requires value";
+    return string(value);
+  };
+
+  string profile = option_value("--benchmark");
+  unsigned int steps = BENCHMARK_STEPS;
+  vector<unsigned int> threads;
+  vector< vector<unsigned int> > domains;
+  vector< vector<string> > solvers;
+
+  if (algo::common::cmd_option_exists(argv, argv+argc, "--benchmark-steps"))
+    steps = atoi(option_value("--benchmark-steps").c_str());
+
+  if (algo::common::cmd_option_exists(argv, argv+argc, "--benchmark-threads"))
+    threads = Benchmark::parse_threads(option_value("--benchmark-threads"));
+
+  if (algo::common::cmd_option_exists(argv, argv+argc, "--benchmark-domains"))
+    domains = Benchmark::parse_domains(option_value("--benchmark-domains"));
+
+  if (algo::common::cmd_option_exists(argv, argv+argc, "--benchmark-solvers"))
+    solvers = Benchmark::parse_solvers(option_value("--benchmark-solvers"));
+
+  Benchmark benchmark (profile, steps, threads, domains, solvers);
+
+  if (algo::common::cmd_option_exists(argv, argv+argc, "--benchmark-output"))
+  {
+    string report_name = option_value("--benchmark-output");
+    ofstream report (report_name);
+    if (!report.is_open())
+      LOG_S(FATAL) << "Can not open benchmark report file ``" << report_name << "''";
+    benchmark(report);
+    report.close();
+  }
+  else
+    benchmark(cout);
+
+  return true;
+}
+
 int main(int argc, char **argv)
 {
 #ifdef ENABLE_HDF5
@@ -178,6 +256,9 @@ int main(int argc, char **argv)
   ////!
   LOG_S(INFO) << "Initialization";
 
+  if (run_benchmark(argc, argv))
+    return 0;
+
   // string cfgname;
   string cfgname = parse_argv_get_config(argc, argv);
 
@@ -235,11 +316,20 @@ int main(int argc, char **argv)
 
     // define a shared memory block
     SMB shared_mem_blk ( &cfg, geometry_smb, sim_time_clock, ID, NPROCS);
+
+    Checkpoint checkpoint ( cfg.checkpoint_params->path, &shared_mem_blk, sim_time_clock, ID );
 #else
     // define a shared memory block
     SMB shared_mem_blk ( &cfg, geometry_global, sim_time_clock, 0, 1);
+
+    Checkpoint checkpoint ( cfg.checkpoint_params->path, &shared_mem_blk, sim_time_clock, 0 );
 #endif // ENABLE_MPI
 
+    checkpoint_enabled = cfg.checkpoint_params->use;
+    bool restart = checkpoint_enabled
+      && cfg.checkpoint_params->restart
+      && checkpoint.exists();
+
     LOG_S(MAX) << "Initializing Data Paths";
 
 #ifdef ENABLE_HDF5
@@ -256,16 +346,20 @@ int main(int argc, char **argv)
 
     try
     {
+      // continue writing to existing data file at restart
+      unsigned int file_mode = restart
+        ? HighFive::File::ReadWrite
+        : HighFive::File::Create | HighFive::File::Excl;
 #ifdef ENABLE_MPI
       file = new HighFive::File (
         hdf5_filepath.c_str(),
-        HighFive::File::ReadWrite | HighFive::File::Create | HighFive::File::Excl,
+        HighFive::File::ReadWrite | file_mode,
         HighFive::MPIOFileDriver(COMM_WORLD, MPI_INFO_NULL)
         );
 #else
       file = new HighFive::File (
         hdf5_filepath.c_str(),
-        HighFive::File::Create | HighFive::File::Excl
+        file_mode
         );
 #endif // ENABLE_MPI
     }
@@ -280,18 +374,37 @@ int main(int argc, char **argv)
 #ifdef ENABLE_HDF5
     OutController out_controller ( file, geometry_global, sim_time_clock,
                                    cfg.probes, &shared_mem_blk, cfg.cfg2value(),
-                                   print_progress_table );
+                                   print_progress_table, restart );
 
     out_controller.hdf5_file = file;
 #else
     OutController out_controller ( geometry_global, sim_time_clock,
                                    cfg.probes, &shared_mem_blk, cfg.cfg2value(),
-                                   print_progress_table );
+                                   print_progress_table, restart );
 #endif
 
     LOG_S(INFO) << "Preparation to calculation";
 
-    shared_mem_blk.distribute();
+    if (restart)
+    {
+      checkpoint.load();
+      shared_mem_blk.restore_window();
+    }
+    else
+      shared_mem_blk.distribute();
+
+#ifdef ENABLE_INSTRUMENTATION
+    if (cfg.instrumentation_params->use)
+#ifdef ENABLE_MPI
+      instrumentation::init(shared_mem_blk.r_domains * shared_mem_blk.z_domains,
+                            cfg.instrumentation_params->path,
+                            cfg.instrumentation_params->format, ID);
+#else
+      instrumentation::init(shared_mem_blk.r_domains * shared_mem_blk.z_domains,
+                            cfg.instrumentation_params->path,
+                            cfg.instrumentation_params->format, 0);
+#endif // ENABLE_MPI
+#endif // ENABLE_INSTRUMENTATION
 
     //! Main calculation loop
     LOG_S(INFO) << "Launching calculation";
@@ -322,17 +435,15 @@ int main(int argc, char **argv)
 
       LOG_S(MAX) << "Run calculation loop for timestamp: " << sim_time_clock->current;
 
-//// inject beam
-      shared_mem_blk.inject_beam();
-
-//// solve maxwell equations
-      shared_mem_blk.solve_maxvell();
+//// inject beam, solve maxwell equations, advance particles
+//// and solve currents as graph of per-domain tasks
+      shared_mem_blk.advance_step();
 
-//// advance particles
-      shared_mem_blk.advance_particles();
+//// shift moving window
+      shared_mem_blk.move_window();
 
-//// solve currents
-      shared_mem_blk.solve_current();
+//// merge and split macroparticles
+      shared_mem_blk.resample_particles();
 
 //// output data
 #ifdef ENABLE_MPI
@@ -342,10 +453,48 @@ int main(int argc, char **argv)
       LOG_S(MAX) << "Launching writers for SMB at ``"
                  << sim_time_clock->current << "''";
 #endif // ENABLE_MPI
-      out_controller();
+      {
+        INSTR_SCOPE(OUT_CONTROLLER, -1);
+        out_controller();
+      }
 
       sim_time_clock->current += sim_time_clock->step;
 
+//// dump per-phase timers and counters
+#ifdef ENABLE_INSTRUMENTATION
+      if (cfg.instrumentation_params->use
+          && cfg.instrumentation_params->schedule > 0)
+      {
+        int current_time_step = ceil(sim_time_clock->current / sim_time_clock->step);
+
+        if (current_time_step % cfg.instrumentation_params->schedule == 0)
+          instrumentation::dump(current_time_step);
+      }
+#endif // ENABLE_INSTRUMENTATION
+
+//// save checkpoint periodically, or before exit, if requested by signal
+      if (checkpoint_enabled)
+      {
+        int current_time_step = ceil(sim_time_clock->current / sim_time_clock->step);
+        // read flag once, as signal can arrive in any moment
+        int requested_by = checkpoint_requested_;
+
+        if (requested_by != 0)
+          LOG_S(INFO) << "Signal ``" << strsignal(requested_by)
+                      << "'' received. Saving checkpoint before exit";
+
+        if (requested_by != 0
+            || (cfg.checkpoint_params->schedule > 0
+                && current_time_step % cfg.checkpoint_params->schedule == 0))
+          checkpoint.save();
+
+        if (requested_by != 0)
+        {
+          LOG_S(INFO) << "Exiting after checkpoint";
+          break;
+        }
+      }
+
 //// check if the simulation pause/unpause requested
       // (signals USR1 for pause and USR2 for unpause
 #ifdef ENABLE_HDF5
@@ -394,6 +543,12 @@ int main(int argc, char **argv)
 #endif
     }
 
+#ifdef ENABLE_INSTRUMENTATION
+    // final dump of timers and counters
+    if (cfg.instrumentation_params->use)
+      instrumentation::dump(ceil(sim_time_clock->current / sim_time_clock->step));
+#endif // ENABLE_INSTRUMENTATION
+
 #ifdef ENABLE_HDF5
     delete file;
 #endif
@@ -15,6 +15,10 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <numeric>   // std::lcm
+#include <sstream>
+#include <algorithm> // std::upper_bound
+
 #include "SMB.hpp"
 
 #ifdef ENABLE_MPI
@@ -40,9 +44,13 @@ SMB::SMB ( Cfg* _cfg, Geometry *_geometry, TimeSim *_time,
   world_rank = _world_rank;
   world_size = _world_size;
 
+  window_shift = 0;
+
   Grid<Domain*> _domains (r_domains, z_domains, 0);
   domains = _domains;
 
+  partition();
+
   //
   // initialize geometry
   //
@@ -70,15 +78,15 @@ SMB::SMB ( Cfg* _cfg, Geometry *_geometry, TimeSim *_time,
         wall_zz = geometry->walls[3];
 
       // cell dimensions for domain
-      size_t bot_r = (size_t)(geometry->cell_amount[0] * i / r_domains
-                              + geometry->cell_dims[0]);
-      size_t top_r = (size_t)(geometry->cell_amount[0] * (i + 1) / r_domains
-                              + geometry->cell_dims[0]);
+      size_t bot_r = r_bounds[i] + geometry->cell_dims[0];
+      size_t top_r = r_bounds[i + 1] + geometry->cell_dims[0];
 
-      size_t left_z = (size_t)(geometry->cell_amount[1] * j / z_domains
-                               + geometry->cell_dims[1]);
-      size_t right_z = (size_t)(geometry->cell_amount[1] * (j + 1) / z_domains
-                                + geometry->cell_dims[1]);
+      size_t left_z = z_bounds[j] + geometry->cell_dims[1];
+      size_t right_z = z_bounds[j + 1] + geometry->cell_dims[1];
+
+      // domains could have different sizes, but cell size is the same
+      double domain_r_size = (top_r - bot_r) * geometry->cell_size[0];
+      double domain_z_size = (right_z - left_z) * geometry->cell_size[1];
 
 #ifdef ENABLE_PML
       // set PML to domains
@@ -94,7 +102,7 @@ SMB::SMB ( Cfg* _cfg, Geometry *_geometry, TimeSim *_time,
 
 #ifdef ENABLE_PML
       Geometry *geom_domain = new Geometry (
-        { geometry->size[0] / r_domains, geometry->size[1] / z_domains},
+        { domain_r_size, domain_z_size },
         { geometry->global_size[0], geometry->global_size[1] }, // global size
         { bot_r, left_z, top_r, right_z },
         { 0, pml_l_z0, pml_l_rwall, pml_l_zwall, },
@@ -110,8 +118,8 @@ SMB::SMB ( Cfg* _cfg, Geometry *_geometry, TimeSim *_time,
       // /WORKAROUND
 #else
       Geometry *geom_domain = new Geometry (
-        { geometry->size[0] / r_domains,
-          geometry->size[1] / z_domains },
+        { domain_r_size,
+          domain_z_size },
         { bot_r, left_z, top_r, right_z },
         { wall_r0,
           wall_z0,
@@ -129,7 +137,10 @@ SMB::SMB ( Cfg* _cfg, Geometry *_geometry, TimeSim *_time,
 
       for (auto k = cfg->particle_species.begin(); k != cfg->particle_species.end(); ++k)
       {
-        unsigned int grid_cell_macro_amount = (int)(k->macro_amount / r_domains / z_domains);
+        // macroparticles amount is proportional to domain cells amount
+        unsigned int grid_cell_macro_amount = (unsigned int)(
+          (double)k->macro_amount * (top_r - bot_r) * (right_z - left_z)
+          / (geometry->cell_amount[0] * geometry->cell_amount[1]));
 
         double drho_by_dz = (k->right_density - k->left_density) / geometry->size[1];
         double ld_local = k->left_density + drho_by_dz * left_z * geom_domain->cell_size[1];
@@ -140,6 +151,7 @@ SMB::SMB ( Cfg* _cfg, Geometry *_geometry, TimeSim *_time,
                                     k->charge, k->mass, grid_cell_macro_amount,
                                     ld_local, rd_local,
                                     k->temperature, geom_domain, time);
+        pps->set_push_every(k->push_every);
         species_p.push_back(pps);
 
         ++p_id_counter;
@@ -163,7 +175,11 @@ SMB::SMB ( Cfg* _cfg, Geometry *_geometry, TimeSim *_time,
           ++b_id_counter;
         }
 
-      Domain *sim_domain = new Domain(*geom_domain, species_p, time);
+      Domain *sim_domain = Domain::create(*cfg->solvers, *geom_domain, species_p, time);
+
+      if (cfg->moving_window_params->use)
+        sim_domain->reserve_window();
+
       domains.set(i, j, sim_domain);
     };
 
@@ -182,6 +198,22 @@ SMB::SMB ( Cfg* _cfg, Geometry *_geometry, TimeSim *_time,
 #endif
 }
 
+SMB::~SMB()
+{
+  for (unsigned int i = 0; i < r_domains; i++)
+    for (unsigned int j = 0; j < z_domains; j++)
+    {
+      Domain *sim_domain = domains(i, j);
+
+      // particle species refer to geometry, allocated for domain
+      Geometry *geom_domain = sim_domain->species_p.empty()
+        ? NULL : sim_domain->species_p[0]->geometry;
+
+      delete sim_domain;
+      delete geom_domain;
+    }
+}
+
 void SMB::particles_runaway_collector ()
 {
   // ! collects particles, that runaways from their __domains and moves it to
@@ -195,6 +227,8 @@ void SMB::particles_runaway_collector ()
   // ! 4. recv from +/-1 SMB
   // ! 5. add new particles to local SMB's domains
 
+  INSTR_SCOPE(RUNAWAY_COLLECTOR, -1);
+
   // create vectors to place particles,
   // scheduled to be sent to other SMBs
 
@@ -215,15 +249,18 @@ void SMB::particles_runaway_collector ()
         for (unsigned int j = idy; j < z_domains; j+=2)
         {
           Domain *sim_domain = domains(i, j);
+          int domain_id = i * z_domains + j;
 
           for (auto ps = sim_domain->species_p.begin(); ps != sim_domain->species_p.end(); ++ps)
           {
+            size_t amount_before = (**ps).particles.size();
+
             (**ps).particles.erase (
               std::remove_if (
                 (**ps).particles.begin(), (**ps).particles.end(),
-                [ &j_c, &r_c, &ps, &__domains, &sim_domain,
+                [ this, &j_c, &r_c, &ps, &__domains, &sim_domain,
                   &queue_particles_minus, &queue_particles_plus,
-                  &i, &j, &__geometry ] ( Particle * & o )
+                  &i, &j, &__geometry, &domain_id ] ( Particle * & o )
                 {
                   bool res = false;
 
@@ -232,13 +269,8 @@ void SMB::particles_runaway_collector ()
                   int z_cell = P_CELL_Z((*o));
 
                   // this is unshifted domain numbers (local for SMB)
-                  unsigned int i_dst = (unsigned int)ceil (
-                    ( r_cell - __geometry->cell_dims[0] ) // we should make cell numbers local for SMB
-                    / sim_domain->geometry.cell_amount[0] );
-
-                  unsigned int j_dst = (unsigned int)ceil (
-                    ( z_cell - __geometry->cell_dims[1] ) // we should make cell numbers local for SMB
-                    / sim_domain->geometry.cell_amount[1] );
+                  unsigned int i_dst = domain_r_number(r_cell);
+                  unsigned int j_dst = domain_z_number(z_cell);
 
                   if (r_cell < 0 || z_cell < 0)
                   {
@@ -255,12 +287,14 @@ void SMB::particles_runaway_collector ()
 #ifdef ENABLE_MPI
                   else if (z_cell < __geometry->cell_dims[1])
                   {
+                    INSTR_COUNT(PARTICLES_MIGRATED, domain_id, 1);
                     queue_particles_minus.push_back(o);
                     res = true;
                   }
                   // send particle to next SMB
                   else if (z_cell >= __geometry->cell_dims[3])
                   {
+                    INSTR_COUNT(PARTICLES_MIGRATED, domain_id, 1);
                     queue_particles_plus.push_back(o);
                     res = true;
                   }
@@ -307,10 +341,22 @@ void SMB::particles_runaway_collector ()
                     res = true;
                   }
 
+                  // remove particles, left behind trailing edge of moving window
+                  else if (z_cell < (int)__geometry->cell_dims[1])
+                  {
+                    LOG_S(MAX) << "Particle is behind moving window: ["
+                               << P_POS_R((*o)) << ", "
+                               << P_POS_Z((*o)) << "]. Removing";
+                    delete o;
+                    ++r_c;
+                    res = true;
+                  }
+
                   // move particles between cells
                   else if (i_dst != i || j_dst != j) // check that destination domain is different, than source
                   {
                     ++j_c;
+                    INSTR_COUNT(PARTICLES_MIGRATED, domain_id, 1);
 
                     Domain *dst_domain = __domains(i_dst, j_dst);
                     for (auto pd = dst_domain->species_p.begin(); pd != dst_domain->species_p.end(); ++pd)
@@ -323,6 +369,7 @@ void SMB::particles_runaway_collector ()
                                    << "'' to domain ``"
                                    << i_dst << "," << j_dst << "''";
                         (**pd).particles.push_back(o);
+                        (**pd).invalidate_diagnostics();
                       }
 
                     res = true;
@@ -330,6 +377,11 @@ void SMB::particles_runaway_collector ()
                   return res;
                 }),
               (**ps).particles.end());
+
+            // density and temperature of specie, which lost particles,
+            // should be recalculated
+            if ((**ps).particles.size() != amount_before)
+              (**ps).invalidate_diagnostics();
           }
         }
     }
@@ -351,9 +403,14 @@ void SMB::particles_runaway_collector ()
   unsigned int prtls_minus = queue_particles_minus.size();
 
   // create MPI data structure
+  MPI_Datatype mpi_prtl_type;
+#ifdef ENABLE_MIXED_PRECISION
+  // mixed precision particle has tile-relative coordinates,
+  // so it is sent as is (nodes are assumed to be homogeneous)
+  MPI_Type_contiguous(sizeof(Particle), MPI_BYTE, &mpi_prtl_type);
+#else
   int blocklengths[3] = {11,3,1};
   MPI_Datatype types[3] = {MPI_DOUBLE, MPI_SIZE_T, MPI_UNSIGNED_SHORT};
-  MPI_Datatype mpi_prtl_type;
   MPI_Aint offsets[3];
 
   offsets[0] = offsetof(Particle, pos_r);
@@ -361,6 +418,7 @@ void SMB::particles_runaway_collector ()
   offsets[2] = offsetof(Particle, specie_id);
 
   MPI_Type_create_struct(3, blocklengths, offsets, types, &mpi_prtl_type);
+#endif // ENABLE_MIXED_PRECISION
   MPI_Type_commit(&mpi_prtl_type);
 
   if (world_rank < world_size - 1)
@@ -372,6 +430,7 @@ void SMB::particles_runaway_collector ()
       /* destination  = */ world_rank + 1,
       /* tag          = */ 0,
       /* communicator = */ MPI_COMM_WORLD);
+    INSTR_COUNT_MPI(-1, MPI_UNSIGNED, 1);
 
     LOG_S(MAX) << "Number of particles to be sent from MPI node ``"
                << world_rank
@@ -389,6 +448,7 @@ void SMB::particles_runaway_collector ()
           /* tag          = */ 0,
           /* communicator = */ MPI_COMM_WORLD);
       }
+    INSTR_COUNT_MPI(-1, mpi_prtl_type, prtls_plus);
   }
 
   if (world_rank > 0)
@@ -400,6 +460,7 @@ void SMB::particles_runaway_collector ()
       /* destination  = */ world_rank - 1,
       /* tag          = */ 0,
       /* communicator = */ MPI_COMM_WORLD);
+    INSTR_COUNT_MPI(-1, MPI_UNSIGNED, 1);
 
     LOG_S(MAX) << "Number of particles to be sent from MPI node ``"
                << world_rank
@@ -417,6 +478,7 @@ void SMB::particles_runaway_collector ()
           /* tag          = */ 0,
           /* communicator = */ MPI_COMM_WORLD);
       }
+    INSTR_COUNT_MPI(-1, mpi_prtl_type, prtls_minus);
   }
 
   ////
@@ -459,23 +521,18 @@ void SMB::particles_runaway_collector ()
         int r_cell = P_CELL_R((*n));
         int z_cell = P_CELL_Z((*n));
 
-        // FIXME: this is a hardcode
-        Domain *sim_domain = domains(0, 0);
-
-        unsigned int i_dst = (unsigned int)ceil (
-          ( r_cell - geometry->cell_dims[0] ) // we should make cell numbers local for SMB
-          / sim_domain->geometry.cell_amount[0] );
-
-        unsigned int j_dst = (unsigned int)ceil (
-          ( z_cell - geometry->cell_dims[1] ) // we should make cell numbers local for SMB
-          / sim_domain->geometry.cell_amount[1] );
+        unsigned int i_dst = domain_r_number(r_cell);
+        unsigned int j_dst = domain_z_number(z_cell);
 
         Domain *dst_domain = domains(i_dst, j_dst);
 
         // find proper specie for particle in domain
         for (auto sp = dst_domain->species_p.begin(); sp != dst_domain->species_p.end(); ++sp)
           if ((**sp).id == P_SPECIE_ID((*n)))
+          {
             (**sp).particles.push_back(n);
+            (**sp).invalidate_diagnostics();
+          }
       }
   }
 
@@ -515,16 +572,8 @@ void SMB::particles_runaway_collector ()
         int z_cell = P_CELL_Z((*n));
 
 
-        // this is unshifted domain numbers (local for SMB)
-        Domain *sim_domain = domains(0, 0);
-
-        unsigned int i_dst = (unsigned int)ceil (
-          ( r_cell - geometry->cell_dims[0] ) // we should make cell numbers local for SMB
-          / sim_domain->geometry.cell_amount[0] );
-
-        unsigned int j_dst = (unsigned int)ceil (
-          ( z_cell - geometry->cell_dims[1] ) // we should make cell numbers local for SMB
-          / sim_domain->geometry.cell_amount[1] );
+        unsigned int i_dst = domain_r_number(r_cell);
+        unsigned int j_dst = domain_z_number(z_cell);
 
         Domain *dst_domain = domains(i_dst, j_dst);
 
@@ -532,7 +581,10 @@ void SMB::particles_runaway_collector ()
         // find proper specie for particle in domain
         for (auto sp = dst_domain->species_p.begin(); sp != dst_domain->species_p.end(); ++sp)
           if ((**sp).id == P_SPECIE_ID((*n)))
+          {
             (**sp).particles.push_back(n);
+            (**sp).invalidate_diagnostics();
+          }
       }
   }
 
@@ -556,37 +608,52 @@ void SMB::particles_runaway_collector ()
 
 void SMB::current_overlay ()
 {
+  INSTR_SCOPE(OVERLAY_CURRENT, -1);
+
   for (unsigned int idx = 0; idx < 2; ++idx)
     for (unsigned int idy = 0; idy < 2; ++idy)
     {
 #pragma omp parallel for
       for (unsigned int i = idx; i < r_domains; i+=2)
         for (unsigned int j = idy; j < z_domains; j+=2)
-        {
-          Domain *sim_domain = domains(i, j);
+          current_overlay_domain(i, j);
+    }
 
-          // update grid
-          if (i < geometry->domains_amount[0] - 1)
-          {
-            Domain *dst_domain = domains(i+1, j);
-            sim_domain->current->current.overlay_x(dst_domain->current->current);
-          }
+#ifdef ENABLE_MPI
+  current_overlay_mpi();
+#endif // ENABLE_MPI
+}
 
-          if (j < geometry->domains_amount[1] - 1)
-          {
-            Domain *dst_domain = domains(i, j + 1);
-            sim_domain->current->current.overlay_y(dst_domain->current->current);
-          }
+void SMB::current_overlay_domain (unsigned int i, unsigned int j)
+{
+  //! overlay current of domain with its top,
+  //! right and top-right neighbours. Only touched
+  //! tiles of grids are overlaid
+  Domain *sim_domain = domains(i, j);
 
-          if (i < geometry->domains_amount[0] - 1 && j < geometry->domains_amount[1] - 1)
-          {
-            Domain *dst_domain = domains(i + 1, j + 1);
-            sim_domain->current->current.overlay_xy(dst_domain->current->current);
-          }
-        }
-    }
+  // update grid
+  if (i < geometry->domains_amount[0] - 1)
+  {
+    Domain *dst_domain = domains(i+1, j);
+    sim_domain->current->overlay_x(dst_domain->current);
+  }
+
+  if (j < geometry->domains_amount[1] - 1)
+  {
+    Domain *dst_domain = domains(i, j + 1);
+    sim_domain->current->overlay_y(dst_domain->current);
+  }
+
+  if (i < geometry->domains_amount[0] - 1 && j < geometry->domains_amount[1] - 1)
+  {
+    Domain *dst_domain = domains(i + 1, j + 1);
+    sim_domain->current->overlay_xy(dst_domain->current);
+  }
+}
 
 #ifdef ENABLE_MPI
+void SMB::current_overlay_mpi ()
+{
   ////
   //// send particles to other domain
   ////
@@ -676,6 +743,7 @@ void SMB::current_overlay ()
     {
       // LOG_S(WARNING) << "1 Sending from " << world_rank << " to " << world_rank + 1;
       MPI_Send(MPI_BOTTOM, 1, i->mpi_dtype(), world_rank + 1, 0, MPI_COMM_WORLD);
+      INSTR_COUNT_MPI(-1, i->mpi_dtype(), 1);
     }
 
     for (auto i = domains_plus_recv.begin(); i != domains_plus_recv.end(); ++i)
@@ -691,6 +759,7 @@ void SMB::current_overlay ()
     {
       // LOG_S(WARNING) << "3 Sending from " << world_rank << " to " << world_rank - 1;
       MPI_Send(MPI_BOTTOM, 1, i->mpi_dtype(), world_rank - 1, 0, MPI_COMM_WORLD);
+      INSTR_COUNT_MPI(-1, i->mpi_dtype(), 1);
     }
 
     for (auto i = domains_minus_recv.begin(); i != domains_minus_recv.end(); ++i)
@@ -708,6 +777,7 @@ void SMB::current_overlay ()
     for (auto i = domains_minus_recv.begin(); i != domains_minus_recv.end(); ++i)
     {
       Domain *dst_domain_minus = domains(i->dst_domain[0], 0);
+      dst_domain_minus->current->tiles.touch_all();
 
       int domain_r_size = dst_domain_minus->current->current[0].x_size;
       int domain_o_s = dst_domain_minus->current->current[0].o_s;
@@ -740,6 +810,7 @@ void SMB::current_overlay ()
     {
 
       Domain *dst_domain_plus = domains(i->dst_domain[0], z_domains - 1);
+      dst_domain_plus->current->tiles.touch_all();
 
       int domain_r_size = dst_domain_plus->current->current[0].x_size;
       int domain_o_s = dst_domain_plus->current->current[0].o_s;
@@ -769,51 +840,59 @@ void SMB::current_overlay ()
       }
     }
 
-#endif // ENABLE_MPI
 }
+#endif // ENABLE_MPI
 
 void SMB::field_h_overlay ()
 {
+  INSTR_SCOPE(OVERLAY_H, -1);
+
   for (unsigned int idx = 0; idx < 2; ++idx)
     for (unsigned int idy = 0; idy < 2; ++idy)
     {
 #pragma omp parallel for
       for (unsigned int i = idx; i < r_domains; i+=2)
         for (unsigned int j = idy; j < z_domains; j+=2)
-        {
-          Domain *sim_domain = domains(i, j);
+          field_h_overlay_domain(i, j);
+    }
 
-          // update grid
-          if (i < geometry->domains_amount[0] - 1)
-          {
-            Domain *dst_domain = domains(i+1, j);
-            sim_domain->maxwell_solver->field_h.overlay_x(
-              dst_domain->maxwell_solver->field_h
-              );
-            sim_domain->maxwell_solver->field_h_at_et.overlay_x(
-              dst_domain->maxwell_solver->field_h_at_et
-              );
-          }
+#ifdef ENABLE_MPI
+  field_h_overlay_mpi();
+#endif // ENABLE_MPI
+}
 
-          if (j < geometry->domains_amount[1] - 1)
-          {
-            Domain *dst_domain = domains(i, j + 1);
-            sim_domain->maxwell_solver->field_h.overlay_y(
-              dst_domain->maxwell_solver->field_h);
-            sim_domain->maxwell_solver->field_h_at_et.overlay_y(
-              dst_domain->maxwell_solver->field_h_at_et);
-          }
+void SMB::field_h_overlay_domain (unsigned int i, unsigned int j)
+{
+  //! overlay magnetic field of domain with its top,
+  //! right and top-right neighbours
+  Domain *sim_domain = domains(i, j);
 
-          if (i < geometry->domains_amount[0] - 1 && j < geometry->domains_amount[1] - 1)
-          {
-            Domain *dst_domain = domains(i + 1, j + 1);
-            sim_domain->maxwell_solver->field_h.overlay_xy(dst_domain->maxwell_solver->field_h);
-            sim_domain->maxwell_solver->field_h_at_et.overlay_xy(dst_domain->maxwell_solver->field_h_at_et);
-          }
-        }
-    }
+  // update grid
+  if (i < geometry->domains_amount[0] - 1)
+  {
+    Domain *dst_domain = domains(i+1, j);
+    sim_domain->maxwell_solver->field_h.overlay_x(
+      dst_domain->maxwell_solver->field_h
+      );
+  }
+
+  if (j < geometry->domains_amount[1] - 1)
+  {
+    Domain *dst_domain = domains(i, j + 1);
+    sim_domain->maxwell_solver->field_h.overlay_y(
+      dst_domain->maxwell_solver->field_h);
+  }
+
+  if (i < geometry->domains_amount[0] - 1 && j < geometry->domains_amount[1] - 1)
+  {
+    Domain *dst_domain = domains(i + 1, j + 1);
+    sim_domain->maxwell_solver->field_h.overlay_xy(dst_domain->maxwell_solver->field_h);
+  }
+}
 
 #ifdef ENABLE_MPI
+void SMB::field_h_overlay_mpi ()
+{
   ////
   //// send particles to other domain
   ////
@@ -828,11 +907,11 @@ void SMB::field_h_overlay ()
     // send to +1 rank
     Domain *sim_domain_plus = domains(i, z_domains - 1);
 
-    int domain_r_size = sim_domain_plus->maxwell_solver->field_h_at_et[0].x_size;
-    int domain_r_real_size = sim_domain_plus->maxwell_solver->field_h_at_et[0].x_real_size;
-    int domain_o_s = sim_domain_plus->maxwell_solver->field_h_at_et[0].o_s;
-    int domain_z_size = sim_domain_plus->maxwell_solver->field_h_at_et[0].y_size;
-    int domain_z_real_size = sim_domain_plus->maxwell_solver->field_h_at_et[0].y_real_size;
+    int domain_r_size = sim_domain_plus->maxwell_solver->field_h[0].x_size;
+    int domain_r_real_size = sim_domain_plus->maxwell_solver->field_h[0].x_real_size;
+    int domain_o_s = sim_domain_plus->maxwell_solver->field_h[0].o_s;
+    int domain_z_size = sim_domain_plus->maxwell_solver->field_h[0].y_size;
+    int domain_z_real_size = sim_domain_plus->maxwell_solver->field_h[0].y_real_size;
 
     MPICommOverlay item_plus (domain_r_real_size, i, 0);
     MPICommOverlay item_plus_recv (domain_r_real_size, i, 0);
@@ -843,21 +922,21 @@ void SMB::field_h_overlay ()
       int j_s = j - domain_o_s;
       int d_r_s = domain_z_size + domain_o_s;
 
-      item_plus.col_0_0[j] = sim_domain_plus->maxwell_solver->field_h_at_et[0](j_s, d_r_s - 4);
-      item_plus.col_0_1[j] = sim_domain_plus->maxwell_solver->field_h_at_et[1](j_s, d_r_s - 4);
-      item_plus.col_0_2[j] = sim_domain_plus->maxwell_solver->field_h_at_et[2](j_s, d_r_s - 4);
+      item_plus.col_0_0[j] = sim_domain_plus->maxwell_solver->field_h[0](j_s, d_r_s - 4);
+      item_plus.col_0_1[j] = sim_domain_plus->maxwell_solver->field_h[1](j_s, d_r_s - 4);
+      item_plus.col_0_2[j] = sim_domain_plus->maxwell_solver->field_h[2](j_s, d_r_s - 4);
 
-      item_plus.col_1_0[j] = sim_domain_plus->maxwell_solver->field_h_at_et[0](j_s, d_r_s - 3);
-      item_plus.col_1_1[j] = sim_domain_plus->maxwell_solver->field_h_at_et[1](j_s, d_r_s - 3);
-      item_plus.col_1_2[j] = sim_domain_plus->maxwell_solver->field_h_at_et[2](j_s, d_r_s - 3);
+      item_plus.col_1_0[j] = sim_domain_plus->maxwell_solver->field_h[0](j_s, d_r_s - 3);
+      item_plus.col_1_1[j] = sim_domain_plus->maxwell_solver->field_h[1](j_s, d_r_s - 3);
+      item_plus.col_1_2[j] = sim_domain_plus->maxwell_solver->field_h[2](j_s, d_r_s - 3);
 
-      item_plus.col_2_0[j] = sim_domain_plus->maxwell_solver->field_h_at_et[0](j_s, d_r_s - 2);
-      item_plus.col_2_1[j] = sim_domain_plus->maxwell_solver->field_h_at_et[1](j_s, d_r_s - 2);
-      item_plus.col_2_2[j] = sim_domain_plus->maxwell_solver->field_h_at_et[2](j_s, d_r_s - 2);
+      item_plus.col_2_0[j] = sim_domain_plus->maxwell_solver->field_h[0](j_s, d_r_s - 2);
+      item_plus.col_2_1[j] = sim_domain_plus->maxwell_solver->field_h[1](j_s, d_r_s - 2);
+      item_plus.col_2_2[j] = sim_domain_plus->maxwell_solver->field_h[2](j_s, d_r_s - 2);
 
-      item_plus.col_3_0[j] = sim_domain_plus->maxwell_solver->field_h_at_et[0](j_s, d_r_s - 1);
-      item_plus.col_3_1[j] = sim_domain_plus->maxwell_solver->field_h_at_et[1](j_s, d_r_s - 1);
-      item_plus.col_3_2[j] = sim_domain_plus->maxwell_solver->field_h_at_et[2](j_s, d_r_s - 1);
+      item_plus.col_3_0[j] = sim_domain_plus->maxwell_solver->field_h[0](j_s, d_r_s - 1);
+      item_plus.col_3_1[j] = sim_domain_plus->maxwell_solver->field_h[1](j_s, d_r_s - 1);
+      item_plus.col_3_2[j] = sim_domain_plus->maxwell_solver->field_h[2](j_s, d_r_s - 1);
     }
 
     domains_plus.push_back( item_plus );
@@ -866,8 +945,8 @@ void SMB::field_h_overlay ()
     // send to -1 rank
     Domain *sim_domain_minus = domains(i, 0);
 
-    domain_r_size = sim_domain_minus->maxwell_solver->field_h_at_et[0].x_size;
-    domain_o_s = sim_domain_minus->maxwell_solver->field_h_at_et[0].o_s;
+    domain_r_size = sim_domain_minus->maxwell_solver->field_h[0].x_size;
+    domain_o_s = sim_domain_minus->maxwell_solver->field_h[0].o_s;
 
     MPICommOverlay item_minus (domain_r_size + 2 * domain_o_s, i, 0);
     MPICommOverlay item_minus_recv (domain_r_size + 2 * domain_o_s, i, 0);
@@ -876,21 +955,21 @@ void SMB::field_h_overlay ()
     {
       int j_s = j + domain_o_s;
 
-      item_minus.col_0_0[j_s] = sim_domain_minus->maxwell_solver->field_h_at_et[0](j, 0 - domain_o_s);
-      item_minus.col_0_1[j_s] = sim_domain_minus->maxwell_solver->field_h_at_et[1](j, 0 - domain_o_s);
-      item_minus.col_0_2[j_s] = sim_domain_minus->maxwell_solver->field_h_at_et[2](j, 0 - domain_o_s);
+      item_minus.col_0_0[j_s] = sim_domain_minus->maxwell_solver->field_h[0](j, 0 - domain_o_s);
+      item_minus.col_0_1[j_s] = sim_domain_minus->maxwell_solver->field_h[1](j, 0 - domain_o_s);
+      item_minus.col_0_2[j_s] = sim_domain_minus->maxwell_solver->field_h[2](j, 0 - domain_o_s);
 
-      item_minus.col_1_0[j_s] = sim_domain_minus->maxwell_solver->field_h_at_et[0](j, 1 - domain_o_s);
-      item_minus.col_1_1[j_s] = sim_domain_minus->maxwell_solver->field_h_at_et[1](j, 1 - domain_o_s);
-      item_minus.col_1_2[j_s] = sim_domain_minus->maxwell_solver->field_h_at_et[2](j, 1 - domain_o_s);
+      item_minus.col_1_0[j_s] = sim_domain_minus->maxwell_solver->field_h[0](j, 1 - domain_o_s);
+      item_minus.col_1_1[j_s] = sim_domain_minus->maxwell_solver->field_h[1](j, 1 - domain_o_s);
+      item_minus.col_1_2[j_s] = sim_domain_minus->maxwell_solver->field_h[2](j, 1 - domain_o_s);
 
-      item_minus.col_2_0[j_s] = sim_domain_minus->maxwell_solver->field_h_at_et[0](j, 2 - domain_o_s);
-      item_minus.col_2_1[j_s] = sim_domain_minus->maxwell_solver->field_h_at_et[1](j, 2 - domain_o_s);
-      item_minus.col_2_2[j_s] = sim_domain_minus->maxwell_solver->field_h_at_et[2](j, 2 - domain_o_s);
+      item_minus.col_2_0[j_s] = sim_domain_minus->maxwell_solver->field_h[0](j, 2 - domain_o_s);
+      item_minus.col_2_1[j_s] = sim_domain_minus->maxwell_solver->field_h[1](j, 2 - domain_o_s);
+      item_minus.col_2_2[j_s] = sim_domain_minus->maxwell_solver->field_h[2](j, 2 - domain_o_s);
 
-      item_minus.col_3_0[j_s] = sim_domain_minus->maxwell_solver->field_h_at_et[0](j, 3 - domain_o_s);
-      item_minus.col_3_1[j_s] = sim_domain_minus->maxwell_solver->field_h_at_et[1](j, 3 - domain_o_s);
-      item_minus.col_3_2[j_s] = sim_domain_minus->maxwell_solver->field_h_at_et[2](j, 3 - domain_o_s);
+      item_minus.col_3_0[j_s] = sim_domain_minus->maxwell_solver->field_h[0](j, 3 - domain_o_s);
+      item_minus.col_3_1[j_s] = sim_domain_minus->maxwell_solver->field_h[1](j, 3 - domain_o_s);
+      item_minus.col_3_2[j_s] = sim_domain_minus->maxwell_solver->field_h[2](j, 3 - domain_o_s);
     }
 
     domains_minus.push_back( item_minus );
@@ -903,6 +982,7 @@ void SMB::field_h_overlay ()
     {
       // LOG_S(WARNING) << "1 Sending from " << world_rank << " to " << world_rank + 1;
       MPI_Send(MPI_BOTTOM, 1, i->mpi_dtype(), world_rank + 1, 0, MPI_COMM_WORLD);
+      INSTR_COUNT_MPI(-1, i->mpi_dtype(), 1);
     }
 
     for (auto i = domains_plus_recv.begin(); i != domains_plus_recv.end(); ++i)
@@ -918,6 +998,7 @@ void SMB::field_h_overlay ()
     {
       // LOG_S(WARNING) << "3 Sending from " << world_rank << " to " << world_rank - 1;
       MPI_Send(MPI_BOTTOM, 1, i->mpi_dtype(), world_rank - 1, 0, MPI_COMM_WORLD);
+      INSTR_COUNT_MPI(-1, i->mpi_dtype(), 1);
     }
 
     for (auto i = domains_minus_recv.begin(); i != domains_minus_recv.end(); ++i)
@@ -936,29 +1017,29 @@ void SMB::field_h_overlay ()
     {
       Domain *dst_domain_minus = domains(i->dst_domain[0], 0);
 
-      int domain_r_size = dst_domain_minus->maxwell_solver->field_h_at_et[0].x_size;
-      int domain_o_s = dst_domain_minus->maxwell_solver->field_h_at_et[0].o_s;
-      int domain_z_size = dst_domain_minus->maxwell_solver->field_h_at_et[0].y_size;
+      int domain_r_size = dst_domain_minus->maxwell_solver->field_h[0].x_size;
+      int domain_o_s = dst_domain_minus->maxwell_solver->field_h[0].o_s;
+      int domain_z_size = dst_domain_minus->maxwell_solver->field_h[0].y_size;
 
       for (int j = -domain_o_s; j < domain_r_size + domain_o_s; ++j)
       {
         int j_s = j + domain_o_s;
 
-        dst_domain_minus->maxwell_solver->field_h_at_et[0].inc(j, 0 - domain_o_s, i->col_0_0[j_s]);
-        dst_domain_minus->maxwell_solver->field_h_at_et[1].inc(j, 0 - domain_o_s, i->col_0_1[j_s]);
-        dst_domain_minus->maxwell_solver->field_h_at_et[2].inc(j, 0 - domain_o_s, i->col_0_2[j_s]);
+        dst_domain_minus->maxwell_solver->field_h[0].inc(j, 0 - domain_o_s, i->col_0_0[j_s]);
+        dst_domain_minus->maxwell_solver->field_h[1].inc(j, 0 - domain_o_s, i->col_0_1[j_s]);
+        dst_domain_minus->maxwell_solver->field_h[2].inc(j, 0 - domain_o_s, i->col_0_2[j_s]);
 
-        dst_domain_minus->maxwell_solver->field_h_at_et[0].inc(j, 1 - domain_o_s, i->col_1_0[j_s]);
-        dst_domain_minus->maxwell_solver->field_h_at_et[1].inc(j, 1 - domain_o_s, i->col_1_1[j_s]);
-        dst_domain_minus->maxwell_solver->field_h_at_et[2].inc(j, 1 - domain_o_s, i->col_1_2[j_s]);
+        dst_domain_minus->maxwell_solver->field_h[0].inc(j, 1 - domain_o_s, i->col_1_0[j_s]);
+        dst_domain_minus->maxwell_solver->field_h[1].inc(j, 1 - domain_o_s, i->col_1_1[j_s]);
+        dst_domain_minus->maxwell_solver->field_h[2].inc(j, 1 - domain_o_s, i->col_1_2[j_s]);
 
-        dst_domain_minus->maxwell_solver->field_h_at_et[0].inc(j, 2 - domain_o_s, i->col_2_0[j_s]);
-        dst_domain_minus->maxwell_solver->field_h_at_et[1].inc(j, 2 - domain_o_s, i->col_2_1[j_s]);
-        dst_domain_minus->maxwell_solver->field_h_at_et[2].inc(j, 2 - domain_o_s, i->col_2_2[j_s]);
+        dst_domain_minus->maxwell_solver->field_h[0].inc(j, 2 - domain_o_s, i->col_2_0[j_s]);
+        dst_domain_minus->maxwell_solver->field_h[1].inc(j, 2 - domain_o_s, i->col_2_1[j_s]);
+        dst_domain_minus->maxwell_solver->field_h[2].inc(j, 2 - domain_o_s, i->col_2_2[j_s]);
 
-        dst_domain_minus->maxwell_solver->field_h_at_et[0].inc(j, 3 - domain_o_s, i->col_3_0[j_s]);
-        dst_domain_minus->maxwell_solver->field_h_at_et[1].inc(j, 3 - domain_o_s, i->col_3_1[j_s]);
-        dst_domain_minus->maxwell_solver->field_h_at_et[2].inc(j, 3 - domain_o_s, i->col_3_2[j_s]);
+        dst_domain_minus->maxwell_solver->field_h[0].inc(j, 3 - domain_o_s, i->col_3_0[j_s]);
+        dst_domain_minus->maxwell_solver->field_h[1].inc(j, 3 - domain_o_s, i->col_3_1[j_s]);
+        dst_domain_minus->maxwell_solver->field_h[2].inc(j, 3 - domain_o_s, i->col_3_2[j_s]);
       }
     }
 
@@ -968,73 +1049,87 @@ void SMB::field_h_overlay ()
 
       Domain *dst_domain_plus = domains(i->dst_domain[0], z_domains - 1);
 
-      int domain_r_size = dst_domain_plus->maxwell_solver->field_h_at_et[0].x_size;
-      int domain_o_s = dst_domain_plus->maxwell_solver->field_h_at_et[0].o_s;
-      int domain_z_size = dst_domain_plus->maxwell_solver->field_h_at_et[0].y_size;
-      int domain_z_real_size = dst_domain_plus->maxwell_solver->field_h_at_et[0].y_real_size;
+      int domain_r_size = dst_domain_plus->maxwell_solver->field_h[0].x_size;
+      int domain_o_s = dst_domain_plus->maxwell_solver->field_h[0].o_s;
+      int domain_z_size = dst_domain_plus->maxwell_solver->field_h[0].y_size;
+      int domain_z_real_size = dst_domain_plus->maxwell_solver->field_h[0].y_real_size;
 
       for (int j = -domain_o_s; j < domain_r_size + domain_o_s; ++j)
       {
         int j_s = j + domain_o_s;
         int d_r_s = domain_z_size + domain_o_s;
 
-        dst_domain_plus->maxwell_solver->field_h_at_et[0].inc(j, d_r_s - 1, i->col_3_0[j_s]);
-        dst_domain_plus->maxwell_solver->field_h_at_et[1].inc(j, d_r_s - 1, i->col_3_1[j_s]);
-        dst_domain_plus->maxwell_solver->field_h_at_et[2].inc(j, d_r_s - 1, i->col_3_2[j_s]);
+        dst_domain_plus->maxwell_solver->field_h[0].inc(j, d_r_s - 1, i->col_3_0[j_s]);
+        dst_domain_plus->maxwell_solver->field_h[1].inc(j, d_r_s - 1, i->col_3_1[j_s]);
+        dst_domain_plus->maxwell_solver->field_h[2].inc(j, d_r_s - 1, i->col_3_2[j_s]);
 
-        dst_domain_plus->maxwell_solver->field_h_at_et[0].inc(j, d_r_s - 2, i->col_2_0[j_s]);
-        dst_domain_plus->maxwell_solver->field_h_at_et[1].inc(j, d_r_s - 2, i->col_2_1[j_s]);
-        dst_domain_plus->maxwell_solver->field_h_at_et[2].inc(j, d_r_s - 2, i->col_2_2[j_s]);
+        dst_domain_plus->maxwell_solver->field_h[0].inc(j, d_r_s - 2, i->col_2_0[j_s]);
+        dst_domain_plus->maxwell_solver->field_h[1].inc(j, d_r_s - 2, i->col_2_1[j_s]);
+        dst_domain_plus->maxwell_solver->field_h[2].inc(j, d_r_s - 2, i->col_2_2[j_s]);
 
-        dst_domain_plus->maxwell_solver->field_h_at_et[0].inc(j, d_r_s - 3, i->col_1_0[j_s]);
-        dst_domain_plus->maxwell_solver->field_h_at_et[1].inc(j, d_r_s - 3, i->col_1_1[j_s]);
-        dst_domain_plus->maxwell_solver->field_h_at_et[2].inc(j, d_r_s - 3, i->col_1_2[j_s]);
+        dst_domain_plus->maxwell_solver->field_h[0].inc(j, d_r_s - 3, i->col_1_0[j_s]);
+        dst_domain_plus->maxwell_solver->field_h[1].inc(j, d_r_s - 3, i->col_1_1[j_s]);
+        dst_domain_plus->maxwell_solver->field_h[2].inc(j, d_r_s - 3, i->col_1_2[j_s]);
 
-        dst_domain_plus->maxwell_solver->field_h_at_et[0].inc(j, d_r_s - 4, i->col_0_0[j_s]);
-        dst_domain_plus->maxwell_solver->field_h_at_et[1].inc(j, d_r_s - 4, i->col_0_1[j_s]);
-        dst_domain_plus->maxwell_solver->field_h_at_et[2].inc(j, d_r_s - 4, i->col_0_2[j_s]);
+        dst_domain_plus->maxwell_solver->field_h[0].inc(j, d_r_s - 4, i->col_0_0[j_s]);
+        dst_domain_plus->maxwell_solver->field_h[1].inc(j, d_r_s - 4, i->col_0_1[j_s]);
+        dst_domain_plus->maxwell_solver->field_h[2].inc(j, d_r_s - 4, i->col_0_2[j_s]);
       }
     }
-#endif // ENABLE_MPI
 }
+#endif // ENABLE_MPI
 
 void SMB::field_e_overlay ()
 {
+  INSTR_SCOPE(OVERLAY_E, -1);
+
   for (unsigned int idx = 0; idx < 2; ++idx)
     for (unsigned int idy = 0; idy < 2; ++idy)
     {
 #pragma omp parallel for
       for (unsigned int i = idx; i < r_domains; i+=2)
         for (unsigned int j = idy; j < z_domains; j+=2)
-        {
-          Domain *sim_domain = domains(i, j);
+          field_e_overlay_domain(i, j);
+    }
 
-          // update grid
-          if (i < geometry->domains_amount[0] - 1)
-          {
-            Domain *dst_domain = domains(i+1, j);
-            sim_domain->maxwell_solver->field_e.overlay_x(
-              dst_domain->maxwell_solver->field_e
-              );
-          }
+#ifdef ENABLE_MPI
+  field_e_overlay_mpi();
+#endif // ENABLE_MPI
+}
 
-          if (j < geometry->domains_amount[1] - 1)
-          {
-            Domain *dst_domain = domains(i, j + 1);
-            sim_domain->maxwell_solver->field_e.overlay_y(
-              dst_domain->maxwell_solver->field_e
-              );
-          }
+void SMB::field_e_overlay_domain (unsigned int i, unsigned int j)
+{
+  //! overlay electric field of domain with its top,
+  //! right and top-right neighbours
+  Domain *sim_domain = domains(i, j);
 
-          if (i < geometry->domains_amount[0] - 1 && j < geometry->domains_amount[1] - 1)
-          {
-            Domain *dst_domain = domains(i + 1, j + 1);
-            sim_domain->maxwell_solver->field_e.overlay_xy(dst_domain->maxwell_solver->field_e);
-          }
-        }
-    }
+  // update grid
+  if (i < geometry->domains_amount[0] - 1)
+  {
+    Domain *dst_domain = domains(i+1, j);
+    sim_domain->maxwell_solver->field_e.overlay_x(
+      dst_domain->maxwell_solver->field_e
+      );
+  }
+
+  if (j < geometry->domains_amount[1] - 1)
+  {
+    Domain *dst_domain = domains(i, j + 1);
+    sim_domain->maxwell_solver->field_e.overlay_y(
+      dst_domain->maxwell_solver->field_e
+      );
+  }
+
+  if (i < geometry->domains_amount[0] - 1 && j < geometry->domains_amount[1] - 1)
+  {
+    Domain *dst_domain = domains(i + 1, j + 1);
+    sim_domain->maxwell_solver->field_e.overlay_xy(dst_domain->maxwell_solver->field_e);
+  }
+}
 
 #ifdef ENABLE_MPI
+void SMB::field_e_overlay_mpi ()
+{
   ////
   //// send particles to other domain
   ////
@@ -1124,6 +1219,7 @@ void SMB::field_e_overlay ()
     {
       // LOG_S(WARNING) << "1 Sending from " << world_rank << " to " << world_rank + 1;
       MPI_Send(MPI_BOTTOM, 1, i->mpi_dtype(), world_rank + 1, 0, MPI_COMM_WORLD);
+      INSTR_COUNT_MPI(-1, i->mpi_dtype(), 1);
     }
 
     for (auto i = domains_plus_recv.begin(); i != domains_plus_recv.end(); ++i)
@@ -1139,6 +1235,7 @@ void SMB::field_e_overlay ()
     {
       // LOG_S(WARNING) << "3 Sending from " << world_rank << " to " << world_rank - 1;
       MPI_Send(MPI_BOTTOM, 1, i->mpi_dtype(), world_rank - 1, 0, MPI_COMM_WORLD);
+      INSTR_COUNT_MPI(-1, i->mpi_dtype(), 1);
     }
 
     for (auto i = domains_minus_recv.begin(); i != domains_minus_recv.end(); ++i)
@@ -1216,8 +1313,8 @@ void SMB::field_e_overlay ()
         dst_domain_plus->maxwell_solver->field_e[2].inc(j, d_r_s - 4, i->col_0_2[j_s]);
       }
     }
-#endif // ENABLE_MPI
 }
+#endif // ENABLE_MPI
 
 void SMB::solve_maxvell()
 {
@@ -1226,9 +1323,21 @@ void SMB::solve_maxvell()
     for (unsigned int j = 0; j < z_domains; j++)
     {
       Domain *sim_domain = domains(i, j);
+      INSTR_SCOPE(SOLVE_E, i * z_domains + j);
 
       sim_domain->weight_field_e();
     }
+  field_h_overlay();
+
+#pragma omp parallel for collapse(2)
+  for (unsigned int i=0; i < r_domains; i++)
+    for (unsigned int j = 0; j < z_domains; j++)
+    {
+      Domain *sim_domain = domains(i, j);
+      INSTR_SCOPE(SOLVE_E, i * z_domains + j);
+
+      sim_domain->weight_field_e_edge();
+    }
   field_e_overlay();
 
 #pragma omp parallel for collapse(2)
@@ -1236,6 +1345,7 @@ void SMB::solve_maxvell()
     for (unsigned int j = 0; j < z_domains; j++)
     {
       Domain *sim_domain = domains(i, j);
+      INSTR_SCOPE(SOLVE_H, i * z_domains + j);
 
       // ! 2. Calculate magnetic field (H)
       sim_domain->weight_field_h(); // +
@@ -1250,6 +1360,7 @@ void SMB::solve_current()
     for (unsigned int j = 0; j < z_domains; j++)
     {
       Domain *sim_domain = domains(i, j);
+      INSTR_SCOPE(SOLVE_CURRENT, i * z_domains + j);
 
       sim_domain->reset_current();
       sim_domain->weight_current();
@@ -1257,32 +1368,259 @@ void SMB::solve_current()
   current_overlay();
 }
 
+void SMB::advance_step()
+{
+  //! make time step (beam injection, maxwell equations, particles
+  //! push and current deposition) as graph of per-domain tasks.
+  //! Every domain starts next phase as soon as phases of its
+  //! neighbours, it depends on, are done, instead of waiting for
+  //! all domains at global barriers. Dependencies are set by
+  //! tokens of domain grids:
+  //!   E(d) -> overlay_H(d, neighbours) -> E_edge(d) -> overlay_E(d, neighbours)
+  //!   -> H(d) -> overlay_H(d, neighbours) -> push(d) -> [runaway collector]
+  //!   -> deposit(d) -> overlay_J(d, neighbours)
+  //! Conflicting overlays are run in order of 4-colour sweeps,
+  //! so results are the same as for phase-by-phase solve.
+  //! Runaway collector moves particles between any domains,
+  //! so it is the only global barrier of the step
+  size_t amount = r_domains * z_domains;
+
+  // dependency tokens (only addresses are used). They are
+  // unused (as well as domain indices of tasks), when OpenMP
+  // pragmas are ignored
+  vector<char> dep_e (amount), dep_h (amount), dep_j (amount), dep_p (amount);
+  [[maybe_unused]] char *t_e = dep_e.data();
+  [[maybe_unused]] char *t_h = dep_h.data();
+  [[maybe_unused]] char *t_j = dep_j.data();
+  [[maybe_unused]] char *t_p = dep_p.data();
+
+  bool inject = ! cfg->particle_beams.empty();
+
+#pragma omp parallel
+#pragma omp master
+  {
+    for (unsigned int i = 0; i < r_domains; i++)
+      for (unsigned int j = 0; j < z_domains; j++)
+      {
+        [[maybe_unused]] size_t d = i * z_domains + j;
+
+        if (inject)
+        {
+#pragma omp task firstprivate(i, j, d) depend(inout: t_p[d])
+          {
+            INSTR_SCOPE(INJECT_BEAM, d);
+            domains(i, j)->manage_beam();
+          }
+        }
+
+#pragma omp task firstprivate(i, j, d) depend(inout: t_e[d], t_h[d])
+        {
+          INSTR_SCOPE(SOLVE_E, d);
+          domains(i, j)->weight_field_e();
+        }
+      }
+
+    for (unsigned int idx = 0; idx < 2; ++idx)
+      for (unsigned int idy = 0; idy < 2; ++idy)
+        for (unsigned int i = idx; i < r_domains; i+=2)
+          for (unsigned int j = idy; j < z_domains; j+=2)
+          {
+            [[maybe_unused]] size_t d = i * z_domains + j;
+            [[maybe_unused]] size_t d_r = i < r_domains - 1 ? d + z_domains : d;
+            [[maybe_unused]] size_t d_z = j < z_domains - 1 ? d + 1 : d;
+            [[maybe_unused]] size_t d_rz = i < r_domains - 1 && j < z_domains - 1 ? d + z_domains + 1 : d;
+
+#pragma omp task firstprivate(i, j, d) depend(inout: t_h[d], t_h[d_r], t_h[d_z], t_h[d_rz])
+            {
+              INSTR_SCOPE(OVERLAY_H, d);
+              field_h_overlay_domain(i, j);
+            }
+          }
+
+#ifdef ENABLE_MPI
+#pragma omp taskwait
+    field_h_overlay_mpi();
+#endif // ENABLE_MPI
+
+    for (unsigned int i = 0; i < r_domains; i++)
+      for (unsigned int j = 0; j < z_domains; j++)
+      {
+        [[maybe_unused]] size_t d = i * z_domains + j;
+
+#pragma omp task firstprivate(i, j, d) depend(in: t_h[d]) depend(inout: t_e[d])
+        {
+          INSTR_SCOPE(SOLVE_E, d);
+          domains(i, j)->weight_field_e_edge();
+        }
+      }
+
+    for (unsigned int idx = 0; idx < 2; ++idx)
+      for (unsigned int idy = 0; idy < 2; ++idy)
+        for (unsigned int i = idx; i < r_domains; i+=2)
+          for (unsigned int j = idy; j < z_domains; j+=2)
+          {
+            [[maybe_unused]] size_t d = i * z_domains + j;
+            [[maybe_unused]] size_t d_r = i < r_domains - 1 ? d + z_domains : d;
+            [[maybe_unused]] size_t d_z = j < z_domains - 1 ? d + 1 : d;
+            [[maybe_unused]] size_t d_rz = i < r_domains - 1 && j < z_domains - 1 ? d + z_domains + 1 : d;
+
+#pragma omp task firstprivate(i, j, d) depend(inout: t_e[d], t_e[d_r], t_e[d_z], t_e[d_rz])
+            {
+              INSTR_SCOPE(OVERLAY_E, d);
+              field_e_overlay_domain(i, j);
+            }
+          }
+
+#ifdef ENABLE_MPI
+#pragma omp taskwait
+    field_e_overlay_mpi();
+#endif // ENABLE_MPI
+
+    for (unsigned int i = 0; i < r_domains; i++)
+      for (unsigned int j = 0; j < z_domains; j++)
+      {
+        [[maybe_unused]] size_t d = i * z_domains + j;
+
+#pragma omp task firstprivate(i, j, d) depend(in: t_e[d]) depend(inout: t_h[d])
+        {
+          INSTR_SCOPE(SOLVE_H, d);
+          domains(i, j)->weight_field_h();
+        }
+      }
+
+    for (unsigned int idx = 0; idx < 2; ++idx)
+      for (unsigned int idy = 0; idy < 2; ++idy)
+        for (unsigned int i = idx; i < r_domains; i+=2)
+          for (unsigned int j = idy; j < z_domains; j+=2)
+          {
+            [[maybe_unused]] size_t d = i * z_domains + j;
+            [[maybe_unused]] size_t d_r = i < r_domains - 1 ? d + z_domains : d;
+            [[maybe_unused]] size_t d_z = j < z_domains - 1 ? d + 1 : d;
+            [[maybe_unused]] size_t d_rz = i < r_domains - 1 && j < z_domains - 1 ? d + z_domains + 1 : d;
+
+#pragma omp task firstprivate(i, j, d) depend(inout: t_h[d], t_h[d_r], t_h[d_z], t_h[d_rz])
+            {
+              INSTR_SCOPE(OVERLAY_H, d);
+              field_h_overlay_domain(i, j);
+            }
+          }
+
+#ifdef ENABLE_MPI
+#pragma omp taskwait
+    field_h_overlay_mpi();
+#endif // ENABLE_MPI
+
+    for (unsigned int i = 0; i < r_domains; i++)
+      for (unsigned int j = 0; j < z_domains; j++)
+      {
+        [[maybe_unused]] size_t d = i * z_domains + j;
+
+#pragma omp task firstprivate(i, j, d) depend(in: t_e[d], t_h[d]) depend(inout: t_p[d])
+        advance_particles_domain(i, j);
+      }
+  }
+
+  particles_runaway_collector();
+
+#pragma omp parallel
+#pragma omp master
+  {
+    for (unsigned int i = 0; i < r_domains; i++)
+      for (unsigned int j = 0; j < z_domains; j++)
+      {
+        [[maybe_unused]] size_t d = i * z_domains + j;
+
+#pragma omp task firstprivate(i, j, d) depend(inout: t_j[d])
+        {
+          INSTR_SCOPE(SOLVE_CURRENT, d);
+          domains(i, j)->reset_current();
+          domains(i, j)->weight_current();
+        }
+      }
+
+    for (unsigned int idx = 0; idx < 2; ++idx)
+      for (unsigned int idy = 0; idy < 2; ++idy)
+        for (unsigned int i = idx; i < r_domains; i+=2)
+          for (unsigned int j = idy; j < z_domains; j+=2)
+          {
+            [[maybe_unused]] size_t d = i * z_domains + j;
+            [[maybe_unused]] size_t d_r = i < r_domains - 1 ? d + z_domains : d;
+            [[maybe_unused]] size_t d_z = j < z_domains - 1 ? d + 1 : d;
+            [[maybe_unused]] size_t d_rz = i < r_domains - 1 && j < z_domains - 1 ? d + z_domains + 1 : d;
+
+#pragma omp task firstprivate(i, j, d) depend(inout: t_j[d], t_j[d_r], t_j[d_z], t_j[d_rz])
+            {
+              INSTR_SCOPE(OVERLAY_CURRENT, d);
+              current_overlay_domain(i, j);
+            }
+          }
+  }
+
+#ifdef ENABLE_MPI
+  current_overlay_mpi();
+#endif // ENABLE_MPI
+}
+
 void SMB::advance_particles()
 {
 #pragma omp parallel for collapse(2)
   for (unsigned int i=0; i < r_domains; i++)
     for (unsigned int j = 0; j < z_domains; j++)
-    {
-      Domain *sim_domain = domains(i, j);
+      advance_particles_domain(i, j);
+
+  particles_runaway_collector();
+}
+
+void SMB::advance_particles_domain(unsigned int i, unsigned int j)
+{
+  //! push, collide, move and reflect particles of domain
+  Domain *sim_domain = domains(i, j);
 
-      // ! 3. Calculate velocity
-      sim_domain->push_particles();
+  // ! 3. Calculate velocity
+  {
+    INSTR_SCOPE(PUSH, i * z_domains + j);
+    INSTR_COUNT(PARTICLES_PUSHED, i * z_domains + j, sim_domain->particles_amount());
+
+    sim_domain->push_particles();
+  }
+
+  // fields are accumulated for sub-cycled species even
+  // in empty domain, but there is nothing to move there.
+  // Diagnostics are invalidated by mover, so it is done here,
+  // to not reuse already overlaid density and temperature
+  if (sim_domain->particles_amount() == 0)
+  {
+    for (auto i = sim_domain->species_p.begin(); i != sim_domain->species_p.end(); ++i)
+      (**i).invalidate_diagnostics();
+
+    return;
+  }
 
 #ifdef ENABLE_COULOMB_COLLISIONS
-      sim_domain->collide(); // collide before reflect
+  {
+    INSTR_SCOPE(COLLIDE, i * z_domains + j);
+
+    sim_domain->collide(); // collide before reflect
+  }
 #endif // ENABLE_COULOMB_COLLISIONS
 
-      sim_domain->dump_particle_positions_to_old();
-      sim_domain->update_particles_coords();
-      sim_domain->particles_back_position_to_rz();
+  {
+    INSTR_SCOPE(MOVE, i * z_domains + j);
 
-      sim_domain->reflect();
+    sim_domain->dump_particle_positions_to_old();
+    sim_domain->update_particles_coords();
+    sim_domain->particles_back_position_to_rz();
+  }
 
-      sim_domain->particles_back_velocity_to_rz();
+  {
+    INSTR_SCOPE(REFLECT, i * z_domains + j);
 
-      sim_domain->bind_cell_numbers();
-    }
-  particles_runaway_collector();
+    sim_domain->reflect();
+
+    sim_domain->particles_back_velocity_to_rz();
+
+    sim_domain->bind_cell_numbers();
+  }
 }
 
 void SMB::inject_beam()
@@ -1294,6 +1632,7 @@ void SMB::inject_beam()
       for (unsigned int j = 0; j < z_domains; j++)
       {
         Domain *sim_domain = domains(i, j);
+        INSTR_SCOPE(INJECT_BEAM, i * z_domains + j);
 
         // ! 1. manage beam
         sim_domain->manage_beam();
@@ -1312,3 +1651,228 @@ void SMB::distribute()
       sim_domain->distribute(); // spatial and velocity distribution
     }
 }
+
+size_t SMB::window_target_shift()
+{
+  //! amount of whole cells, passed by moving window at current time
+  double passed = cfg->moving_window_params->velocity
+    * (time->current - cfg->moving_window_params->start_time);
+
+  if (passed <= 0)
+    return 0;
+
+  return (size_t)floor(passed / geometry->cell_size[1]);
+}
+
+void SMB::move_window()
+{
+  //! shift window by one cell, when it passes the cell.
+  //! Grids are shifted with offset, fresh plasma is loaded
+  //! at the leading edge, particles behind trailing edge are removed
+  if (! cfg->moving_window_params->use)
+    return;
+
+  size_t target_shift = window_target_shift();
+
+  if (window_shift >= target_shift)
+    return;
+
+  while (window_shift < target_shift)
+  {
+    // columns, shifted into domains, should be taken before any shift
+#pragma omp parallel for collapse(2)
+    for (unsigned int i = 0; i < r_domains; i++)
+      for (unsigned int j = 0; j < z_domains; j++)
+        domains(i, j)->prepare_window_shift(j < z_domains - 1 ? domains(i, j + 1) : NULL);
+
+#pragma omp parallel for collapse(2)
+    for (unsigned int i = 0; i < r_domains; i++)
+      for (unsigned int j = 0; j < z_domains; j++)
+      {
+        Domain *sim_domain = domains(i, j);
+
+        sim_domain->shift_window();
+
+        if (j == 0)
+          sim_domain->drop_window_tail();
+
+        if (j == z_domains - 1)
+          sim_domain->load_window_edge();
+      }
+
+    geometry->cell_dims[1] += 1;
+    geometry->cell_dims[3] += 1;
+
+    ++window_shift;
+  }
+
+  LOG_S(MAX) << "Moving window is shifted by " << window_shift << " cells";
+
+  // particles near domains borders are in neighbour domains now
+  particles_runaway_collector();
+}
+
+void SMB::restore_window()
+{
+  //! set window position after restart from checkpoint.
+  //! Grids and particles are restored already shifted
+  if (! cfg->moving_window_params->use)
+    return;
+
+  size_t target_shift = window_target_shift();
+
+  for (unsigned int i = 0; i < r_domains; i++)
+    for (unsigned int j = 0; j < z_domains; j++)
+      domains(i, j)->shift_window_geometry(target_shift - window_shift);
+
+  geometry->cell_dims[1] += target_shift - window_shift;
+  geometry->cell_dims[3] += target_shift - window_shift;
+
+  window_shift = target_shift;
+}
+
+void SMB::resample_particles()
+{
+  //! merge and split macroparticles periodically to keep
+  //! amount of particles per cell in given limits. Every
+  //! domain is resampled in parallel per cell
+  if (! cfg->resampling_params->use)
+    return;
+
+  int current_time_step = ceil(time->current / time->step);
+
+  if (current_time_step == 0
+      || current_time_step % cfg->resampling_params->schedule != 0)
+    return;
+
+  for (unsigned int i = 0; i < r_domains; i++)
+    for (unsigned int j = 0; j < z_domains; j++)
+    {
+      INSTR_SCOPE(RESAMPLE, i * z_domains + j);
+
+      domains(i, j)->resample_particles(cfg->resampling_params->min_per_cell,
+                                        cfg->resampling_params->max_per_cell);
+    }
+
+  LOG_S(MAX) << "Macroparticles are resampled at step " << current_time_step;
+}
+
+void SMB::partition()
+{
+  //! find borders of domains. ``uniform'' partitioning cuts SMB
+  //! to blocks with equal amount of cells. ``load'' partitioning
+  //! sizes blocks to get equal expected load: fields calculation
+  //! per cell plus push of macroparticles, expected in the cell.
+  //! Borders are the same for all of domains in row (column),
+  //! so overlays are done between grids of equal size
+  size_t r_cells = geometry->cell_amount[0];
+  size_t z_cells = geometry->cell_amount[1];
+
+  r_bounds.assign(r_domains + 1, 0);
+  z_bounds.assign(z_domains + 1, 0);
+
+  for (unsigned int i = 0; i <= r_domains; ++i)
+    r_bounds[i] = r_cells * i / r_domains;
+
+  for (unsigned int j = 0; j <= z_domains; ++j)
+    z_bounds[j] = z_cells * j / z_domains;
+
+  if (cfg->partitioning.compare("load") != 0)
+    return;
+
+  if (r_cells < r_domains * PARTITION_MIN_CELLS || z_cells < z_domains * PARTITION_MIN_CELLS)
+  {
+    LOG_S(WARNING) << "Grid is too small for load-based partitioning. Using uniform one";
+    return;
+  }
+
+  double dr = geometry->cell_size[0];
+  double dz = geometry->cell_size[1];
+
+  // plasma macroparticles are loaded with equal amount per cell
+  // (their weights are proportional to cell volume)
+  double plasma_per_cell = 0;
+  for (auto k = cfg->particle_species.begin(); k != cfg->particle_species.end(); ++k)
+    plasma_per_cell += (double)k->macro_amount / (r_cells * z_cells);
+
+  // beam macroparticles are injected uniformly by r inside the
+  // bunch radius and pass through the whole longitude, so they
+  // load rows near axis with averaged over bunches train density
+  vector<double> cell_load (r_cells, PARTITION_CELL_COST + plasma_per_cell);
+
+  for (auto bm = cfg->particle_beams.begin(); bm != cfg->particle_beams.end(); ++bm)
+  {
+    if (bm->bunches_amount <= 0)
+      continue;
+
+    double radius_cells = bm->bunch_radius / dr;
+    double length_cells = fmax(bm->bunch_length / dz, 1);
+    double filling = bm->bunch_length / (bm->bunch_length + bm->bunches_distance);
+    double beam_per_cell = (double)bm->macro_amount / bm->bunches_amount
+      / (radius_cells * length_cells) * filling;
+
+    for (size_t i = 0; i < r_cells; ++i)
+    {
+      double bottom = (double)(i + geometry->cell_dims[0]);
+      double covered = fmin(fmax(radius_cells - bottom, 0), 1);
+
+      cell_load[i] += beam_per_cell * covered;
+    }
+  }
+
+  // space-reduced probes require domains borders, aligned to reduction factor
+  unsigned int alignment = 1;
+  for (auto prb = cfg->probes.begin(); prb != cfg->probes.end(); ++prb)
+    if (prb->factor > 1)
+      alignment = std::lcm(alignment, prb->factor);
+
+  vector<double> r_load (r_cells, 0);
+  vector<double> z_load (z_cells, 0);
+
+  for (size_t i = 0; i < r_cells; ++i)
+  {
+    r_load[i] = cell_load[i] * z_cells;
+    for (size_t j = 0; j < z_cells; ++j)
+      z_load[j] += cell_load[i];
+  }
+
+  r_bounds = algo::common::balanced_partition(r_load, r_domains, PARTITION_MIN_CELLS, alignment);
+  z_bounds = algo::common::balanced_partition(z_load, z_domains, PARTITION_MIN_CELLS, alignment);
+
+  stringstream r_str, z_str;
+  for (auto b = r_bounds.begin(); b != r_bounds.end(); ++b)
+    r_str << " " << *b;
+  for (auto b = z_bounds.begin(); b != z_bounds.end(); ++b)
+    z_str << " " << *b;
+
+  LOG_S(INFO) << "Load-based domains partitioning. Borders by r:" << r_str.str()
+              << ", by z:" << z_str.str();
+}
+
+unsigned int SMB::domain_r_number(int r_cell)
+{
+  //! find domain row, which contains cell (global cell number)
+  long int cell = (long int)r_cell - (long int)geometry->cell_dims[0];
+
+  if (cell < 0)
+    return 0;
+
+  unsigned int i = std::upper_bound(r_bounds.begin(), r_bounds.end(), (size_t)cell)
+    - r_bounds.begin();
+
+  return i > r_domains ? r_domains - 1 : i - 1;
+}
+
+unsigned int SMB::domain_z_number(int z_cell)
+{
+  //! find domain column, which contains cell (global cell number)
+  long int cell = (long int)z_cell - (long int)geometry->cell_dims[1];
+
+  if (cell < 0)
+    return 0;
+
+  unsigned int j = std::upper_bound(z_bounds.begin(), z_bounds.end(), (size_t)cell)
+    - z_bounds.begin();
+
+  return j > z_domains ? z_domains - 1 : j - 1;
+}
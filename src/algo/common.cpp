@@ -28,28 +28,6 @@ namespace algo::common
   using std::isnan;
 #endif
 
-#ifdef __AVX__
-  double sqrt_recip(double x)
-  {
-    //! 1/sqrt(x), using AVX squared root procedure
-    double d[4];
-    __m256d c = _mm256_sqrt_pd(_mm256_set_pd(x, 0, 0, 0));
-
-    _mm256_store_pd(d, c);
-
-    return d[3];
-  }
-#endif
-
-  double sq_rt(double x)
-  {
-#if defined (__AVX__)
-    return sqrt_recip(x);
-#else
-    return sqrt(x);
-#endif
-  }
-
   bool to_bool(string str)
   {
     std::transform(str.begin(), str.end(), str.begin(), ::tolower);
@@ -224,4 +202,50 @@ namespace algo::common
 
     return (ret & 0x7FFFFFFF);
   }
+
+  std::vector<size_t> balanced_partition (const std::vector<double> &load, unsigned int parts,
+                                          unsigned int min_size, unsigned int alignment)
+  {
+    //! cut array of loads to ``parts'' pieces of contiguous
+    //! elements with about equal summary load. Returns borders
+    //! of the pieces (parts + 1 values, from 0 to load size).
+    //! Every piece has at least ``min_size'' elements, inner
+    //! borders are aligned to ``alignment'', when possible
+    size_t size = load.size();
+    std::vector<size_t> bounds (parts + 1, 0);
+    std::vector<double> prefix (size + 1, 0);
+
+    for (size_t i = 0; i < size; ++i)
+      prefix[i + 1] = prefix[i] + load[i];
+
+    if (alignment < 1) alignment = 1;
+
+    for (unsigned int d = 1; d < parts; ++d)
+    {
+      double target = prefix[size] * d / parts;
+
+      size_t b = std::lower_bound(prefix.begin(), prefix.end(), target) - prefix.begin();
+      if (b > 0 && target - prefix[b - 1] < prefix[b] - target)
+        --b;
+
+      // align to nearest border
+      b = (size_t)round((double)b / alignment) * alignment;
+
+      size_t lower = bounds[d - 1] + min_size;
+      size_t upper = size - (size_t)(parts - d) * min_size;
+
+      if (b < lower)
+        b = (lower + alignment - 1) / alignment * alignment;
+      if (b > upper)
+        b = upper / alignment * alignment;
+      if (b < lower || b > upper) // can not align with required size
+        b = std::min(std::max(b, lower), upper);
+
+      bounds[d] = b;
+    }
+
+    bounds[parts] = size;
+
+    return bounds;
+  }
 }
@@ -112,12 +112,8 @@ void BeamP::inject()
         P_POS_PHI((*v)) = 0;
         // 3. set pos_z
         P_POS_Z((*v)) = dl * rand_z + half_z_cell_size;
-        // 4. set vel_r
-        P_VEL_R((*v)) = 0;
-        // 5. set vel_phi
-        P_VEL_PHI((*v)) = 0;
-        // 6. set vel_z
-        P_VEL_Z((*v)) = velocity;
+        // 4-6. set vel_r, vel_phi and vel_z
+        set_particle_velocity((*v), 0, 0, velocity);
 
         // coefitient of normalization
         double norm;
@@ -164,7 +160,8 @@ void BeamP::reflect ()
   // shift for converting local positions into global and back
   double r_shift = geometry->cell_dims[0] * dr;
 
-  for (auto p = particles.begin(); p != particles.end(); ++p)
+#pragma omp taskloop default(shared) grainsize(PARTICLES_CHUNK_SIZE)
+  for (auto p = particles.begin(); p < particles.end(); ++p)
   {
     double pos_r = P_POS_R((**p)) - r_shift;
 
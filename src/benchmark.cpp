@@ -0,0 +1,300 @@
+/*
+ * This file is part of the PiCoPiC distribution (https://github.com/cosmonaut-ok/PiCoPiC).
+ * Copyright (c) 2020 Alexander Vynnyk.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <sstream>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif // _OPENMP
+
+#include "picojson.h"
+
+#include "benchmark.hpp"
+#include "cfg.hpp"
+#include "SMB.hpp"
+#include "math/rand.hpp"
+#include "algo/common.hpp"
+
+using namespace std;
+
+Benchmark::Benchmark (string _profile, unsigned int _steps,
+                      vector<unsigned int> _threads,
+                      vector< vector<unsigned int> > _domains,
+                      vector< vector<string> > _solvers)
+{
+  profile = _profile;
+  steps = _steps;
+  threads = _threads;
+  domains = _domains;
+  solvers = _solvers;
+
+  if (profile.compare("uniform") != 0
+      && profile.compare("beam") != 0
+      && profile.compare("collisions") != 0)
+    LOG_S(FATAL) << "Unknown benchmark profile ``" << profile
+                 << "''. Should be ``uniform'', ``beam'' or ``collisions''";
+
+#ifndef ENABLE_COULOMB_COLLISIONS
+  if (profile.compare("collisions") == 0)
+    LOG_S(FATAL) << "Benchmark profile ``collisions'' requires application, built with coulomb collisions support";
+#endif // ENABLE_COULOMB_COLLISIONS
+
+  if (steps == 0)
+    LOG_S(FATAL) << "Benchmark steps amount should be positive";
+
+  if (threads.empty())
+  {
+    // powers of 2 up to amount of processors, and amount of processors itself
+#ifdef _OPENMP
+    unsigned int procs = omp_get_num_procs();
+#else
+    unsigned int procs = 1;
+#endif // _OPENMP
+    for (unsigned int t = 1; t < procs; t *= 2)
+      threads.push_back(t);
+    threads.push_back(procs);
+  }
+
+  if (domains.empty())
+    domains = parse_domains(BENCHMARK_DOMAINS);
+
+  // solvers, selected at configure time
+  if (solvers.empty())
+    solvers.push_back(vector<string>());
+}
+
+vector<unsigned int> Benchmark::parse_threads(string str)
+{
+  vector<string> items;
+  vector<unsigned int> res;
+
+  algo::common::splitstr(str, ',', items);
+
+  for (auto i = items.begin(); i != items.end(); ++i)
+  {
+    int t = atoi(i->c_str());
+    if (t <= 0)
+      LOG_S(FATAL) << "Wrong threads amount ``" << *i << "''";
+    res.push_back(t);
+  }
+
+  return res;
+}
+
+vector< vector<unsigned int> > Benchmark::parse_domains(string str)
+{
+  vector<string> items;
+  vector< vector<unsigned int> > res;
+
+  algo::common::splitstr(str, ',', items);
+
+  for (auto i = items.begin(); i != items.end(); ++i)
+  {
+    vector<string> dims;
+    algo::common::splitstr(*i, 'x', dims);
+
+    if (dims.size() != 2 || atoi(dims[0].c_str()) <= 0 || atoi(dims[1].c_str()) <= 0)
+      LOG_S(FATAL) << "Wrong domains decomposition ``" << *i << "''. Should be in format ``<r>x<z>''";
+
+    res.push_back({(unsigned int)atoi(dims[0].c_str()), (unsigned int)atoi(dims[1].c_str())});
+  }
+
+  return res;
+}
+
+vector< vector<string> > Benchmark::parse_solvers(string str)
+{
+  vector<string> items;
+  vector< vector<string> > res;
+
+  algo::common::splitstr(str, ',', items);
+
+  for (auto i = items.begin(); i != items.end(); ++i)
+  {
+    vector<string> names;
+    algo::common::splitstr(*i, ':', names);
+
+    if (names.size() != 2 && names.size() != 3)
+      LOG_S(FATAL) << "Wrong solvers combination ``" << *i
+                   << "''. Should be in format ``<pusher>:<current>[:<collisions>]''";
+
+    res.push_back(names);
+  }
+
+  return res;
+}
+
+string Benchmark::scenario(vector<string> &run_solvers, unsigned int r_domains, unsigned int z_domains)
+{
+  //! configuration of canonical scenario. All of the scenarios
+  //! share geometry and background plasma of default PiCoPiC.json.
+  //! Beam is injected at the begining of ``beam'' scenario
+  stringstream cfg;
+
+  cfg << "{"
+      << "\"macro_amount\": 1e6,"
+      << "\"beam_plasma_macro_size_ratio\": 2,"
+      << "\"log_file\": \"/dev/null\","
+      << "\"geometry\": {"
+      << "  \"size\": {\"radius\": 0.0375, \"longitude\": 0.15},"
+      << "  \"grid\": {\"radius\": 64, \"longitude\": 256},"
+      << "  \"domains_amount\": {\"radius\": " << r_domains << ", \"longitude\": " << z_domains << "},"
+      << "  \"pml\": {\"left_wall\": 0, \"right_wall\": 0.05, \"outer_wall\": 0.2, \"sigma_1\": 1e-5, \"sigma_2\": 1.5}"
+      << "},"
+      << "\"time\": {\"start\": 0, \"end\": " << 5e-13 * steps << ", \"step\": 5e-13},"
+      << "\"particles\": ["
+      << "  {\"name\": \"electrons\", \"charge\": -1, \"mass\": 1, \"density\": 1e17, \"temperature\": 1},"
+      << "  {\"name\": \"ions\", \"charge\": 1, \"mass\": 1836, \"density\": 1e17, \"temperature\": 0.1}"
+      << "],"
+      << "\"beams\": [";
+
+  if (profile.compare("beam") == 0)
+    cfg << "{\"name\": \"electrons\", \"charge\": -1, \"mass\": 1, \"velocity\": 2.8e8, \"start_time\": 0,"
+        << " \"bunch\": {\"amount\": 1, \"distance\": 0.0914, \"length\": 0.0056, \"radius\": 0.005, \"density\": 5e16}}";
+
+  cfg << "],"
+      << "\"data\": {\"data_root\": \"./\", \"compression\": {\"use\": false, \"level\": 1}, \"probes\": []},"
+      << "\"solvers\": {";
+
+  vector<string> items;
+
+  if (!run_solvers.empty())
+  {
+    items.push_back("\"pusher\": \"" + run_solvers[0] + "\"");
+    items.push_back("\"current\": \"" + run_solvers[1] + "\"");
+  }
+
+  // only ``collisions'' scenario collides particles
+  // with build default scheme, if not given
+  if (run_solvers.size() == 3)
+    items.push_back("\"collisions\": \"" + run_solvers[2] + "\"");
+  else if (profile.compare("collisions") != 0)
+    items.push_back("\"collisions\": \"none\"");
+
+  for (auto i = items.begin(); i != items.end(); ++i)
+    cfg << (i == items.begin() ? "" : ", ") << *i;
+
+  cfg << "}}";
+
+  return cfg.str();
+}
+
+benchmark_result Benchmark::run(vector<string> &run_solvers,
+                                 unsigned int r_domains, unsigned int z_domains,
+                                 unsigned int threads_amount)
+{
+  stringstream json (scenario(run_solvers, r_domains, z_domains));
+  Cfg cfg (json);
+
+  if (profile.compare("collisions") == 0 && cfg.solvers->collisions.compare("none") == 0)
+    LOG_S(FATAL) << "Benchmark profile ``collisions'' requires coulomb collisions scheme";
+
+  // every run starts from the same state
+  math::random::seed(BENCHMARK_SEED);
+
+  SMB smb (&cfg, cfg.geometry, cfg.time, 0, 1);
+
+  // SMB sets threads amount to amount of processors
+#ifdef _OPENMP
+  omp_set_num_threads(threads_amount);
+#endif // _OPENMP
+
+  smb.distribute();
+
+  benchmark_result res;
+  res.threads = threads_amount;
+  res.r_domains = r_domains;
+  res.z_domains = z_domains;
+  res.particles_pushed = 0;
+  res.solvers = cfg.solvers->pusher + ":" + cfg.solvers->current + ":"
+    + cfg.solvers->maxwell_solver + ":" + cfg.solvers->collisions;
+  res.cell_updates = (double)cfg.geometry->cell_amount[0] * cfg.geometry->cell_amount[1] * steps;
+
+  auto start = chrono::steady_clock::now();
+
+  for (unsigned int s = 0; s < steps; ++s)
+  {
+    for (unsigned int i = 0; i < smb.r_domains; i++)
+      for (unsigned int j = 0; j < smb.z_domains; j++)
+        res.particles_pushed += smb.domains(i, j)->particles_amount();
+
+    smb.advance_step();
+
+    cfg.time->current += cfg.time->step;
+  }
+
+  chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+  res.seconds = elapsed.count();
+
+  LOG_S(INFO) << "Benchmark ``" << profile << "'' (" << res.solvers << ") with "
+              << r_domains << "x" << z_domains << " domains and "
+              << threads_amount << " threads: " << res.seconds << " s";
+
+  return res;
+}
+
+void Benchmark::operator()(ostream &out)
+{
+  picojson::array runs;
+
+  for (auto sl = solvers.begin(); sl != solvers.end(); ++sl)
+    for (auto d = domains.begin(); d != domains.end(); ++d)
+    {
+      // single-thread time of the same solvers and decomposition
+      // to calculate parallel efficiency
+      double single_thread_seconds = 0;
+
+      for (auto t = threads.begin(); t != threads.end(); ++t)
+      {
+        benchmark_result res = run(*sl, (*d)[0], (*d)[1], *t);
+
+        if (*t == 1)
+          single_thread_seconds = res.seconds;
+
+        picojson::object o;
+        o["solvers"] = picojson::value(res.solvers);
+        o["threads"] = picojson::value((double)res.threads);
+        o["domains"] = picojson::value(to_string(res.r_domains) + "x" + to_string(res.z_domains));
+        o["seconds"] = picojson::value(res.seconds);
+        o["particles_pushed"] = picojson::value(res.particles_pushed);
+        o["particles_per_second"] = picojson::value(res.particles_pushed / res.seconds);
+        o["cell_updates_per_second"] = picojson::value(res.cell_updates / res.seconds);
+
+        if (single_thread_seconds > 0)
+          o["parallel_efficiency"] = picojson::value(single_thread_seconds / res.seconds / res.threads);
+        else
+          o["parallel_efficiency"] = picojson::value();
+
+        runs.push_back(picojson::value(o));
+      }
+    }
+
+  picojson::object report;
+  report["profile"] = picojson::value(profile);
+  report["steps"] = picojson::value((double)steps);
+  report["package_version"] = picojson::value((string)PACKAGE_VERSION);
+  report["build_flags"] = picojson::value((string)CXXFLAGS);
+#ifdef ENABLE_COULOMB_COLLISIONS
+  report["collisions"] = picojson::value(true);
+#else
+  report["collisions"] = picojson::value(false);
+#endif // ENABLE_COULOMB_COLLISIONS
+  report["runs"] = picojson::value(runs);
+
+  out << picojson::value(report).serialize(true) << endl;
+}
@@ -23,23 +23,35 @@ using namespace picojson;
 Cfg::Cfg(const std::string json_file_name)
 {
   //! read given json file and parse it
-  stringstream ss;
   ifstream f;
-  // unsigned int i;
 
-  time = new TimeSim();
-  output_data = new save_data();
-
-  // Read Json file
   f.open(json_file_name.c_str(), ios::binary);
   if (!f.is_open())
     LOG_S(FATAL) << "Can not read configuration file ``" << json_file_name.c_str() << "''";
-  ss << f.rdbuf();
+
+  init(f);
   f.close();
+}
+
+Cfg::Cfg(std::istream &json_stream)
+{
+  //! parse json configuration from stream (e.g. generated in place)
+  init(json_stream);
+}
+
+void Cfg::init(std::istream &json_stream)
+{
+  time = new TimeSim();
+  output_data = new save_data();
+  checkpoint_params = new checkpoint_data();
+  instrumentation_params = new instrumentation_data();
+  moving_window_params = new moving_window_data();
+  resampling_params = new resampling_data();
+  solvers = new solvers_data();
 
   //! Parse Json data
   value v;
-  ss >> v;
+  json_stream >> v;
   string err = get_last_error();
   if(!err.empty())
     LOG_S(FATAL) << err;
@@ -57,6 +69,10 @@ Cfg::Cfg(const std::string json_file_name)
   loguru::g_stderr_verbosity = loguru::Verbosity_INFO;
 #endif
 
+  //! select solvers before build options
+  //! are stored, to keep them in metadata
+  init_solvers();
+
   //! update json with additional items
   //! to inform about build options
   //! and package version
@@ -76,6 +92,12 @@ Cfg::Cfg(const std::string json_file_name)
   o["ieee"] = value(true);
 #endif
 
+#ifdef ENABLE_MIXED_PRECISION
+  o["mixed_precision"] = value(true);
+#else
+  o["mixed_precision"] = value(false);
+#endif
+
 #ifdef SWITCH_PLASMA_SPATIAL_CENTERED
   o["plasma_spatial_distribution"] = value("centered");
 #elif defined(SWITCH_PLASMA_SPATIAL_FLAT)
@@ -94,27 +116,10 @@ Cfg::Cfg(const std::string json_file_name)
   o["plasma_velocity_distribution"] = value("rectangular");
 #endif
 
-#ifdef SWITCH_PUSHER_BORIS_ADAPTIVE
-  o["particles_pusher"] = value("boris adaptive");
-#elif defined(SWITCH_PUSHER_BORIS)
-  o["particles_pusher"] = value("boris classic");
-#elif defined(SWITCH_PUSHER_BORIS_RELATIVISTIC)
-  o["particles_pusher"] = value("boris relativistic");
-#elif defined(SWITCH_PUSHER_HC)
-  o["particles_pusher"] = value("higuera-cary");
-#elif defined(SWITCH_PUSHER_VAY)
-  o["particles_pusher"] = value("vay");
-#endif
-
-#ifdef SWITCH_CCS_ZIGZAG
-  o["current_deposition"] = value("zigzag");
-#elif defined(SWITCH_CCS_VB)
-  o["current_deposition"] = value("villasenor-buneman");
-#endif
-
-#ifdef SWITCH_MAXWELL_SOLVER_YEE
-  o["maxwell_solver"] = value("yee");
-#endif
+  o["particles_pusher"] = value(solvers->pusher);
+  o["current_deposition"] = value(solvers->current);
+  o["maxwell_solver"] = value(solvers->maxwell_solver);
+  o["coulomb_collisions"] = value(solvers->collisions);
 
 #ifdef SWITCH_TEMP_CALC_COUNTING
   o["temperature_calculation_algorithm"] = value("counting");
@@ -158,6 +163,10 @@ Cfg::Cfg(const std::string json_file_name)
   weight_macro_amount();
 
   init_output_data();
+  init_checkpoint();
+  init_instrumentation();
+  init_moving_window();
+  init_resampling();
   init_probes();
 
   method_limitations_check();
@@ -200,6 +209,15 @@ void Cfg::init_particles()
     p_s.right_density = o["density"].get<double>(); // TODO: density profile still not supported, but planned
     p_s.temperature = o["temperature"].get<double>();
 
+    // optional: sub-cycling for heavy species
+    p_s.push_every = 1;
+    try { p_s.push_every = (unsigned int)o["push_every"].get<double>(); }
+    catch (std::exception& e) {}
+
+    if (p_s.push_every < 1)
+      LOG_S(FATAL) << "``push_every'' for particles specie ``" << specie_name
+                   << "'' should be positive integer";
+
     particle_species.push_back(p_s);
 
     ++current_specie_id;
@@ -304,6 +322,74 @@ void Cfg::init_probes ()
 
     p_p.schedule = (int)o["schedule"].get<double>();
 
+    //// in-situ reduction of probe values (optional)
+    string time_reduce;
+    try { time_reduce = o["time_reduce"].get<string>().c_str(); }
+    catch (std::exception& e) { time_reduce = "none"; }
+
+    if (time_reduce.compare("none") == 0) p_p.time_reduce = 0;
+    else if (time_reduce.compare("average") == 0) p_p.time_reduce = 1;
+    else if (time_reduce.compare("min") == 0) p_p.time_reduce = 2;
+    else if (time_reduce.compare("max") == 0) p_p.time_reduce = 3;
+    else if (time_reduce.compare("rms") == 0) p_p.time_reduce = 4;
+    else if (time_reduce.compare("spectrum") == 0) p_p.time_reduce = 5;
+    else
+      LOG_S(FATAL) << "Unknown probe time reduction ``" << time_reduce << "''";
+
+    try { p_p.sample = (int)o["sample"].get<double>(); }
+    catch (std::exception& e) { p_p.sample = 1; }
+
+    string space_reduce;
+    try { space_reduce = o["space_reduce"].get<string>().c_str(); }
+    catch (std::exception& e) { space_reduce = "none"; }
+
+    if (space_reduce.compare("none") == 0) p_p.space_reduce = 0;
+    else if (space_reduce.compare("pick") == 0) p_p.space_reduce = 1;
+    else if (space_reduce.compare("block") == 0) p_p.space_reduce = 2;
+    else
+      LOG_S(FATAL) << "Unknown probe space reduction ``" << space_reduce << "''";
+
+    try { p_p.factor = (int)o["factor"].get<double>(); }
+    catch (std::exception& e) { p_p.factor = 1; }
+
+    if (p_p.sample < 1 || p_p.factor < 1)
+      LOG_S(FATAL) << "Probe's " << p_p.component << "/" << p_shape
+                   << " sample and factor should be positive";
+
+    try { p_p.window = (int)o["window"].get<double>(); }
+    catch (std::exception& e) { p_p.window = 0; }
+
+    if (p_p.time_reduce == 5)
+    {
+      if (p_p.shape != 1 && p_p.shape != 3)
+        LOG_S(FATAL) << "Spectral probe " << p_p.component << "/" << p_shape
+                     << " is supported only for dot and col shapes";
+
+      if (p_p.window < 2 || ! math::fft::is_power_of_2(p_p.window))
+        LOG_S(FATAL) << "Spectral probe " << p_p.component << "/" << p_shape
+                     << " window should be power of 2, but it is " << p_p.window;
+    }
+    else
+      p_p.window = 0;
+
+    if (p_p.shape == 3 && p_p.space_reduce != 0)
+    {
+      LOG_S(WARNING) << "Space reduction is meaningless for dot-shaped probe "
+                     << p_p.component << "/" << p_shape << ". Ignoring";
+      p_p.space_reduce = 0;
+    }
+
+    if (p_p.space_reduce == 0)
+      p_p.factor = 1;
+
+    // add reduction to probe path to not mix it with instant probe values
+    if (p_p.time_reduce == 5)
+      p_p.path += SPACE_DELIMITER + time_reduce + to_string(p_p.window);
+    else if (p_p.time_reduce != 0)
+      p_p.path += SPACE_DELIMITER + time_reduce;
+    if (p_p.space_reduce != 0)
+      p_p.path += SPACE_DELIMITER + space_reduce + to_string(p_p.factor);
+
     if (p_p.dims[0] > p_p.dims[2] || p_p.dims[1] > p_p.dims[3])
     {
       LOG_S(FATAL) << "Incorrect probe's " << p_p.component << "/" << p_shape << " shape: ["
@@ -418,6 +504,8 @@ void Cfg::init_geometry ()
   vector<size_t> domains (2, 0);
   geometry->domains_amount = domains;
 
+  partitioning = "uniform";
+
   //
 #ifdef ENABLE_SINGLETHREAD
   LOG_S(INFO) << "Singlethread mode. Reducing domains amount to 1";
@@ -426,6 +514,13 @@ void Cfg::init_geometry ()
 #else
   geometry->domains_amount[0] = (int)json_root["domains_amount"].get<object>()["radius"].get<double>();
   geometry->domains_amount[1] = (int)json_root["domains_amount"].get<object>()["longitude"].get<double>();
+
+  try { partitioning = json_root["domains_amount"].get<object>()["partitioning"].get<string>(); }
+  catch (std::exception& e) {}
+
+  if (partitioning.compare("uniform") != 0 && partitioning.compare("load") != 0)
+    LOG_S(FATAL) << "Unknown domains partitioning ``" << partitioning
+                 << "''. Should be ``uniform'' or ``load''";
 #endif
 }
 
@@ -452,65 +547,278 @@ void Cfg::init_output_data()
   output_data->compress_level = (int)json_root["compression"].get<object>()["level"].get<double>();
 }
 
-void Cfg::weight_macro_amount()
-//! calculate alignment of macroparticles amount
-//! to each particles specie and each beam
+void Cfg::init_checkpoint()
 {
-  double norm_sum = 0;
+  //! initialize checkpoint/restart parameters (optional section)
+  object& json_root = json_data.get<object>();
 
-// increase normalization sum for particle species (assume, that specie size times species amount)
-  norm_sum += geometry->cell_amount[0] * geometry->cell_amount[1] * particle_species.size();
+  checkpoint_params->use = false;
+  checkpoint_params->path = string(output_data->data_root) + PATH_DELIMITER + "checkpoint";
+  checkpoint_params->schedule = 0;
+  checkpoint_params->restart = false;
 
-// increase normalization sum for particle beams
-  for (auto b = particle_beams.begin(); b != particle_beams.end(); ++b)
-  {
-    double beam_r_grid_size = (*b).bunch_radius / geometry->cell_size[0];
-    double beam_z_grid_size = (*b).bunch_length * (*b).bunches_amount / geometry->cell_size[1];
+  if (json_root.find("checkpoint") == json_root.end())
+    return;
 
-    norm_sum += beam_r_grid_size * beam_z_grid_size * beam_macro_ratio;
-  }
+  object& json_root_cp = json_root["checkpoint"].get<object>();
 
-  // calculate normalization coeffitient
-  double norm = macro_amount / norm_sum;
+  checkpoint_params->use = true;
 
-  // message about pusher, used in system
-#ifdef SWITCH_PUSHER_BORIS
-  LOG_S(INFO) << "Using classic Boris particles pusher";
-#elif defined(SWITCH_PUSHER_BORIS_ADAPTIVE)
-  LOG_S(INFO) << "Using adaptive Boris particles pusher";
+  try { checkpoint_params->path = json_root_cp["path"].get<string>(); }
+  catch (std::exception& e) {}
+
+  try { checkpoint_params->schedule = (unsigned int)json_root_cp["schedule"].get<double>(); }
+  catch (std::exception& e) {}
+
+  try { checkpoint_params->restart = json_root_cp["restart"].get<bool>(); }
+  catch (std::exception& e) {}
+
+  LOG_S(INFO) << "Checkpoints are enabled. Path: ``" << checkpoint_params->path
+              << "'', schedule: " << checkpoint_params->schedule;
+}
+
+void Cfg::init_instrumentation()
+{
+  //! initialize per-phase timers and counters output (optional section)
+  object& json_root = json_data.get<object>();
+
+  instrumentation_params->use = false;
+  instrumentation_params->path = "";
+  instrumentation_params->schedule = 0;
+  instrumentation_params->format = "json";
+
+  if (json_root.find("instrumentation") == json_root.end())
+    return;
+
+#ifndef ENABLE_INSTRUMENTATION
+  LOG_S(WARNING) << "Application is built without instrumentation support. Section ``instrumentation'' ignored";
+  return;
+#endif // ENABLE_INSTRUMENTATION
+
+  object& json_root_in = json_root["instrumentation"].get<object>();
+
+  instrumentation_params->use = true;
+
+  try { instrumentation_params->path = json_root_in["path"].get<string>(); }
+  catch (std::exception& e) {}
+
+  try { instrumentation_params->schedule = (unsigned int)json_root_in["schedule"].get<double>(); }
+  catch (std::exception& e) {}
+
+  try { instrumentation_params->format = json_root_in["format"].get<string>(); }
+  catch (std::exception& e) {}
+
+  if (instrumentation_params->format.compare("json") != 0
+      && instrumentation_params->format.compare("csv") != 0)
+    LOG_S(FATAL) << "Unknown instrumentation format ``" << instrumentation_params->format
+                 << "''. Should be ``json'' or ``csv''";
+
+  if (instrumentation_params->path.empty())
+    instrumentation_params->path = string(output_data->data_root)
+      + PATH_DELIMITER + "instrumentation." + instrumentation_params->format;
+}
+
+void Cfg::init_moving_window()
+{
+  //! initialize moving window parameters (optional section)
+  object& json_root = json_data.get<object>();
+
+  moving_window_params->use = false;
+  moving_window_params->velocity = 0;
+  moving_window_params->start_time = 0;
+
+  if (json_root.find("moving_window") == json_root.end())
+    return;
+
+#ifdef ENABLE_MPI
+  LOG_S(FATAL) << "Moving window is not supported with MPI yet";
+#endif // ENABLE_MPI
+
+  object& json_root_mw = json_root["moving_window"].get<object>();
+
+  moving_window_params->use = true;
+  moving_window_params->velocity = json_root_mw["velocity"].get<double>();
+
+  try { moving_window_params->start_time = json_root_mw["start_time"].get<double>(); }
+  catch (std::exception& e) {}
+
+  if (moving_window_params->velocity <= 0)
+    LOG_S(FATAL) << "Moving window velocity should be positive";
+
+  LOG_S(INFO) << "Moving window is enabled. Velocity: " << moving_window_params->velocity
+              << ", start time: " << moving_window_params->start_time;
+}
+
+void Cfg::init_resampling()
+{
+  //! initialize macroparticles merging/splitting parameters (optional section)
+  object& json_root = json_data.get<object>();
+
+  resampling_params->use = false;
+  resampling_params->schedule = 100;
+  resampling_params->min_per_cell = 0;
+  resampling_params->max_per_cell = 0;
+
+  if (json_root.find("resampling") == json_root.end())
+    return;
+
+  object& json_root_rs = json_root["resampling"].get<object>();
+
+  try { resampling_params->schedule = (unsigned int)json_root_rs["schedule"].get<double>(); }
+  catch (std::exception& e) {}
+
+  try { resampling_params->min_per_cell = (unsigned int)json_root_rs["min_per_cell"].get<double>(); }
+  catch (std::exception& e) {}
+
+  try { resampling_params->max_per_cell = (unsigned int)json_root_rs["max_per_cell"].get<double>(); }
+  catch (std::exception& e) {}
+
+  if (resampling_params->schedule < 1)
+    LOG_S(FATAL) << "Resampling schedule should be positive";
+
+  // merging makes max_per_cell / 2 particles, which should not be split back
+  if (resampling_params->max_per_cell > 0
+      && resampling_params->max_per_cell < 2 * resampling_params->min_per_cell)
+    LOG_S(FATAL) << "Resampling max_per_cell should be at least twice as much as min_per_cell";
+
+  resampling_params->use = resampling_params->min_per_cell > 0
+    || resampling_params->max_per_cell > 0;
+
+  if (resampling_params->use)
+    LOG_S(INFO) << "Macroparticles resampling is enabled. Schedule: " << resampling_params->schedule
+                << ", particles per cell: [" << resampling_params->min_per_cell
+                << ", " << resampling_params->max_per_cell << "]";
+}
+
+void Cfg::init_solvers()
+{
+  //! select particles pusher, current deposition scheme, maxwell solver
+  //! and coulomb collisions scheme (optional section). Defaults are
+  //! the ones, selected at configure time
+  object& json_root = json_data.get<object>();
+
+#ifdef SWITCH_PUSHER_BORIS_ADAPTIVE
+  solvers->pusher = "boris_adaptive";
+#elif defined(SWITCH_PUSHER_BORIS)
+  solvers->pusher = "boris";
 #elif defined(SWITCH_PUSHER_BORIS_RELATIVISTIC)
-  LOG_S(INFO) << "Using fully relativistic Boris particles pusher";
-#elif defined(SWITCH_PUSHER_VAY)
-  LOG_S(INFO) << "Using Vay particles pusher [10.1063/1.2837054]";
+  solvers->pusher = "boris_relativistic";
 #elif defined(SWITCH_PUSHER_HC)
-  LOG_S(INFO) << "Using Higuera-Cary particles pusher [10.1063/1.4979989]";
-#else
-  LOG_S(FATAL) << "Undefined particles pusher used";
+  solvers->pusher = "hc";
+#elif defined(SWITCH_PUSHER_VAY)
+  solvers->pusher = "vay";
 #endif
 
-  // message about charge conservation scheme, used in system
 #ifdef SWITCH_CCS_ZIGZAG
-  LOG_S(INFO) << "Using ZigZag charge conservation scheme [10.1016/S0010-4655(03)00437-5]";
+  solvers->current = "zigzag";
 #elif defined(SWITCH_CCS_VB)
-  LOG_S(INFO) << "Using Villasenor-Buneman charge conservation scheme [10.1016/0010-4655(92)90169-Y]";
+  solvers->current = "vb";
 #endif
 
-  // message about coulomb colisions
+  solvers->maxwell_solver = "yee";
+
+  solvers->collisions = "none";
 #ifdef ENABLE_COULOMB_COLLISIONS
-  LOG_S(WARNING) << "Particle collisions are enabled. This is still development feature. Ensure, that you know, what you doing";
 #ifdef SWITCH_COULOMB_COLLISIONS_TA77S
-  LOG_S(INFO) << "Using Takizuka and Abe Coulomb collisions scheme";
-  LOG_S(INFO) << "\twith symmetric weighted particles correction [10.1002/ctpp.201700121]";
+  solvers->collisions = "ta77s";
 #elif defined(SWITCH_COULOMB_COLLISIONS_SK98)
-  LOG_S(INFO) << "Using Sentoku and Kemp Coulomb collisions scheme [10.1143/JPSJ.67.4084, 10.1016/j.jcp.2008.03.043]";
+  solvers->collisions = "sk98";
 #elif defined(SWITCH_COULOMB_COLLISIONS_P12)
-  LOG_S(INFO) << "Using Perez et al. collisions scheme [10.1063/1.4742167]";
-#endif
+  solvers->collisions = "p12";
 #endif
+#endif // ENABLE_COULOMB_COLLISIONS
 
-#ifdef SWITCH_MAXWELL_SOLVER_YEE
-  LOG_S(INFO) << "Using Yee (FDTD) maxwellian solver [10.1109/TAP.1966.1138693]";
-#endif
+  if (json_root.find("solvers") != json_root.end())
+  {
+    object& json_root_sl = json_root["solvers"].get<object>();
+
+    try { solvers->pusher = json_root_sl["pusher"].get<string>(); }
+    catch (std::exception& e) {}
+
+    try { solvers->current = json_root_sl["current"].get<string>(); }
+    catch (std::exception& e) {}
+
+    try { solvers->maxwell_solver = json_root_sl["maxwell_solver"].get<string>(); }
+    catch (std::exception& e) {}
+
+    try { solvers->collisions = json_root_sl["collisions"].get<string>(); }
+    catch (std::exception& e) {}
+  }
+
+#ifndef ENABLE_COULOMB_COLLISIONS
+  if (solvers->collisions.compare("none") != 0)
+    LOG_S(FATAL) << "Application is built without coulomb collisions support. Collisions scheme ``"
+                 << solvers->collisions << "'' is not available";
+#endif // ENABLE_COULOMB_COLLISIONS
+
+  // message about pusher, used in system
+  if (solvers->pusher.compare("boris") == 0)
+    LOG_S(INFO) << "Using classic Boris particles pusher";
+  else if (solvers->pusher.compare("boris_adaptive") == 0)
+    LOG_S(INFO) << "Using adaptive Boris particles pusher";
+  else if (solvers->pusher.compare("boris_relativistic") == 0)
+    LOG_S(INFO) << "Using fully relativistic Boris particles pusher";
+  else if (solvers->pusher.compare("vay") == 0)
+    LOG_S(INFO) << "Using Vay particles pusher [10.1063/1.2837054]";
+  else if (solvers->pusher.compare("hc") == 0)
+    LOG_S(INFO) << "Using Higuera-Cary particles pusher [10.1063/1.4979989]";
+  else
+    LOG_S(FATAL) << "Unknown particles pusher ``" << solvers->pusher
+                 << "''. Should be ``boris'', ``boris_adaptive'', ``boris_relativistic'', ``vay'' or ``hc''";
+
+  // message about charge conservation scheme, used in system
+  if (solvers->current.compare("zigzag") == 0)
+    LOG_S(INFO) << "Using ZigZag charge conservation scheme [10.1016/S0010-4655(03)00437-5]";
+  else if (solvers->current.compare("vb") == 0)
+    LOG_S(INFO) << "Using Villasenor-Buneman charge conservation scheme [10.1016/0010-4655(92)90169-Y]";
+  else
+    LOG_S(FATAL) << "Unknown current deposition scheme ``" << solvers->current
+                 << "''. Should be ``vb'' or ``zigzag''";
+
+  if (solvers->maxwell_solver.compare("yee") == 0)
+    LOG_S(INFO) << "Using Yee (FDTD) maxwellian solver [10.1109/TAP.1966.1138693]";
+  else
+    LOG_S(FATAL) << "Unknown maxwell solver ``" << solvers->maxwell_solver
+                 << "''. Should be ``yee''";
+
+  // message about coulomb colisions
+  if (solvers->collisions.compare("none") != 0)
+    LOG_S(WARNING) << "Particle collisions are enabled. This is still development feature. Ensure, that you know, what you doing";
+
+  if (solvers->collisions.compare("ta77s") == 0)
+  {
+    LOG_S(INFO) << "Using Takizuka and Abe Coulomb collisions scheme";
+    LOG_S(INFO) << "\twith symmetric weighted particles correction [10.1002/ctpp.201700121]";
+  }
+  else if (solvers->collisions.compare("sk98") == 0)
+    LOG_S(INFO) << "Using Sentoku and Kemp Coulomb collisions scheme [10.1143/JPSJ.67.4084, 10.1016/j.jcp.2008.03.043]";
+  else if (solvers->collisions.compare("p12") == 0)
+    LOG_S(INFO) << "Using Perez et al. collisions scheme [10.1063/1.4742167]";
+  else if (solvers->collisions.compare("none") != 0)
+    LOG_S(FATAL) << "Unknown coulomb collisions scheme ``" << solvers->collisions
+                 << "''. Should be ``none'', ``ta77s'', ``sk98'' or ``p12''";
+}
+
+void Cfg::weight_macro_amount()
+//! calculate alignment of macroparticles amount
+//! to each particles specie and each beam
+{
+  double norm_sum = 0;
+
+// increase normalization sum for particle species (assume, that specie size times species amount)
+  norm_sum += geometry->cell_amount[0] * geometry->cell_amount[1] * particle_species.size();
+
+// increase normalization sum for particle beams
+  for (auto b = particle_beams.begin(); b != particle_beams.end(); ++b)
+  {
+    double beam_r_grid_size = (*b).bunch_radius / geometry->cell_size[0];
+    double beam_z_grid_size = (*b).bunch_length * (*b).bunches_amount / geometry->cell_size[1];
+
+    norm_sum += beam_r_grid_size * beam_z_grid_size * beam_macro_ratio;
+  }
+
+  // calculate normalization coeffitient
+  double norm = macro_amount / norm_sum;
 
   // align macroparticles amount to particle species
   // with respect to normalization
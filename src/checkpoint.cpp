@@ -0,0 +1,311 @@
+/*
+ * This file is part of the PiCoPiC distribution (https://github.com/cosmonaut-ok/PiCoPiC).
+ * Copyright (c) 2020 Alexander Vynnyk.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <chrono>
+
+#include "checkpoint.hpp"
+
+using namespace std;
+
+// write all of the buffer to file by given offset
+static void pwrite_all(int fd, const char *buffer, size_t size, size_t offset, string file_name)
+{
+  while (size > 0)
+  {
+    ssize_t written = pwrite(fd, buffer, size, offset);
+    if (written < 0)
+      LOG_S(FATAL) << "Can not write checkpoint file ``" << file_name << "'': " << strerror(errno);
+    buffer += written;
+    offset += written;
+    size -= written;
+  }
+}
+
+Checkpoint::Checkpoint (string _path, SMB *_smb, TimeSim *_time, int _world_rank)
+  : path(_path), smb(_smb), time(_time)
+{
+  file_name = path + "/checkpoint_" + to_string(_world_rank) + ".bin";
+}
+
+bool Checkpoint::exists()
+{
+  struct stat buffer;
+  return stat(file_name.c_str(), &buffer) == 0;
+}
+
+vector< Grid<double>* > Checkpoint::domain_grids(Domain *_domain)
+{
+  vector< Grid<double>* > grids;
+
+  for (unsigned int c = 0; c < 3; ++c)
+  {
+    grids.push_back(&(_domain->maxwell_solver->field_e[c]));
+    grids.push_back(&(_domain->maxwell_solver->field_h[c]));
+    grids.push_back(&(_domain->current->current[c]));
+  }
+
+  return grids;
+}
+
+size_t Checkpoint::domain_size(Domain *_domain)
+{
+  vector< Grid<double>* > grids = domain_grids(_domain);
+
+  // grids amount and sizes
+  size_t size = sizeof(size_t) * 3;
+  for (auto g = grids.begin(); g != grids.end(); ++g)
+    size += algo::serialize::grid_size(**g);
+
+  // species
+  size += sizeof(size_t);
+  for (auto ps = _domain->species_p.begin(); ps != _domain->species_p.end(); ++ps)
+    size += sizeof(unsigned int) * 2 + sizeof(size_t)
+      + algo::serialize::particles_size((**ps).particles);
+
+  // time reduction state of probes
+  size += sizeof(size_t);
+  for (auto w = _domain->out_writers.begin(); w != _domain->out_writers.end(); ++w)
+    size += w->state_size();
+
+  return size;
+}
+
+void Checkpoint::domain_serialize(Domain *_domain, char *_buffer)
+{
+  vector< Grid<double>* > grids = domain_grids(_domain);
+
+  algo::serialize::put(_buffer, grids.size());
+  algo::serialize::put(_buffer, (size_t)grids[0]->x_real_size);
+  algo::serialize::put(_buffer, (size_t)grids[0]->y_real_size);
+
+  for (auto g = grids.begin(); g != grids.end(); ++g)
+    algo::serialize::put_grid(_buffer, **g);
+
+  algo::serialize::put(_buffer, _domain->species_p.size());
+
+  for (auto ps = _domain->species_p.begin(); ps != _domain->species_p.end(); ++ps)
+  {
+    algo::serialize::put(_buffer, (unsigned int)(**ps).id);
+    algo::serialize::put(_buffer, (**ps).current_bunch_number);
+    algo::serialize::put(_buffer, (**ps).particles.size());
+    algo::serialize::put_particles(_buffer, (**ps).particles);
+  }
+
+  algo::serialize::put(_buffer, _domain->out_writers.size());
+
+  for (auto w = _domain->out_writers.begin(); w != _domain->out_writers.end(); ++w)
+    w->state_serialize(_buffer);
+}
+
+void Checkpoint::domain_deserialize(Domain *_domain, const char *_buffer, size_t _size)
+{
+  const char *end = _buffer + _size;
+  vector< Grid<double>* > grids = domain_grids(_domain);
+  size_t grids_amount, x_real_size, y_real_size;
+
+  algo::serialize::get(_buffer, grids_amount);
+  algo::serialize::get(_buffer, x_real_size);
+  algo::serialize::get(_buffer, y_real_size);
+
+  if (grids_amount != grids.size()
+      || x_real_size != grids[0]->x_real_size
+      || y_real_size != grids[0]->y_real_size)
+    LOG_S(FATAL) << "Checkpoint ``" << file_name << "'' does not fit simulation geometry";
+
+  for (auto g = grids.begin(); g != grids.end(); ++g)
+    algo::serialize::get_grid(_buffer, **g);
+
+  // loaded current is not tracked by deposition
+  _domain->current->tiles.touch_all();
+
+  size_t species_amount;
+  algo::serialize::get(_buffer, species_amount);
+
+  if (species_amount != _domain->species_p.size())
+    LOG_S(FATAL) << "Checkpoint ``" << file_name << "'' does not fit simulation particles species";
+
+  for (auto ps = _domain->species_p.begin(); ps != _domain->species_p.end(); ++ps)
+  {
+    unsigned int id, current_bunch_number;
+    size_t particles_amount;
+
+    algo::serialize::get(_buffer, id);
+    algo::serialize::get(_buffer, current_bunch_number);
+    algo::serialize::get(_buffer, particles_amount);
+
+    if (id != (**ps).id)
+      LOG_S(FATAL) << "Checkpoint ``" << file_name << "'' does not fit particles specie ``"
+                   << (**ps).name << "''";
+
+    if (_buffer + sizeof(Particle) * particles_amount > end)
+      LOG_S(FATAL) << "Checkpoint ``" << file_name << "'' is truncated or corrupted";
+
+    (**ps).current_bunch_number = current_bunch_number;
+
+    // drop particles, which could be already distributed
+    algo::serialize::get_particles(_buffer, (**ps).particles, particles_amount);
+
+    (**ps).invalidate_diagnostics();
+  }
+
+  size_t writers_amount;
+  algo::serialize::get(_buffer, writers_amount);
+
+  if (writers_amount != _domain->out_writers.size())
+    LOG_S(FATAL) << "Checkpoint ``" << file_name << "'' does not fit configured probes";
+
+  for (auto w = _domain->out_writers.begin(); w != _domain->out_writers.end(); ++w)
+    w->state_deserialize(_buffer);
+
+  if (_buffer != end)
+    LOG_S(FATAL) << "Checkpoint ``" << file_name << "'' is truncated or corrupted";
+}
+
+void Checkpoint::save()
+{
+  auto begin = chrono::steady_clock::now();
+
+  algo::common::make_directory(path);
+
+  unsigned int domains_amount = smb->r_domains * smb->z_domains;
+  string rng_state = math::random::get_state();
+
+  // calculate layout: header, offsets table, rng state, domains
+  vector<size_t> offsets (domains_amount + 1);
+  offsets[0] = sizeof(checkpoint_header) + sizeof(size_t) * (domains_amount + 1) + rng_state.size();
+  for (unsigned int d = 0; d < domains_amount; ++d)
+    offsets[d + 1] = offsets[d] + domain_size(smb->domains(d / smb->z_domains, d % smb->z_domains));
+
+  checkpoint_header header;
+  memset(&header, 0, sizeof(checkpoint_header));
+  strncpy(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic));
+  header.version = CHECKPOINT_VERSION;
+  header.domains_amount = domains_amount;
+  header.time_current = time->current;
+  header.print_header_counter = time->print_header_counter;
+  header.rng_state_size = rng_state.size();
+  header.particle_size = sizeof(Particle);
+  header.momentum = CHECKPOINT_MOMENTUM;
+
+  string tmp_file_name = file_name + ".tmp";
+  int fd = open(tmp_file_name.c_str(), O_CREAT | O_TRUNC | O_WRONLY, 0644);
+  if (fd < 0)
+    LOG_S(FATAL) << "Can not create checkpoint file ``" << tmp_file_name << "'': " << strerror(errno);
+
+  if (ftruncate(fd, offsets[domains_amount]) != 0)
+    LOG_S(FATAL) << "Can not allocate checkpoint file ``" << tmp_file_name << "'': " << strerror(errno);
+
+  pwrite_all(fd, (const char*)&header, sizeof(checkpoint_header), 0, tmp_file_name);
+  pwrite_all(fd, (const char*)offsets.data(), sizeof(size_t) * (domains_amount + 1),
+             sizeof(checkpoint_header), tmp_file_name);
+  pwrite_all(fd, rng_state.data(), rng_state.size(),
+             sizeof(checkpoint_header) + sizeof(size_t) * (domains_amount + 1), tmp_file_name);
+
+  // domains are independent blocks of file, so write them in parallel
+#pragma omp parallel for
+  for (unsigned int d = 0; d < domains_amount; ++d)
+  {
+    size_t size = offsets[d + 1] - offsets[d];
+    char *buffer = new char[size];
+
+    domain_serialize(smb->domains(d / smb->z_domains, d % smb->z_domains), buffer);
+    pwrite_all(fd, buffer, size, offsets[d], tmp_file_name);
+
+    delete [] buffer;
+  }
+
+  fsync(fd);
+  close(fd);
+
+  if (rename(tmp_file_name.c_str(), file_name.c_str()) != 0)
+    LOG_S(FATAL) << "Can not replace checkpoint file ``" << file_name << "'': " << strerror(errno);
+
+  chrono::duration<double> elapsed = chrono::steady_clock::now() - begin;
+  LOG_S(INFO) << "Checkpoint ``" << file_name << "'' (" << offsets[domains_amount]
+              << " bytes) saved at " << time->current << " in " << elapsed.count() << " s";
+}
+
+void Checkpoint::load()
+{
+  auto begin = chrono::steady_clock::now();
+
+  int fd = open(file_name.c_str(), O_RDONLY);
+  if (fd < 0)
+    LOG_S(FATAL) << "Can not open checkpoint file ``" << file_name << "'': " << strerror(errno);
+
+  struct stat st;
+  fstat(fd, &st);
+  size_t file_size = st.st_size;
+
+  if (file_size < sizeof(checkpoint_header))
+    LOG_S(FATAL) << "Checkpoint ``" << file_name << "'' is truncated or corrupted";
+
+  char *data = (char*)mmap(NULL, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (data == MAP_FAILED)
+    LOG_S(FATAL) << "Can not map checkpoint file ``" << file_name << "'': " << strerror(errno);
+  madvise(data, file_size, MADV_SEQUENTIAL);
+
+  checkpoint_header header;
+  memcpy(&header, data, sizeof(checkpoint_header));
+
+  unsigned int domains_amount = smb->r_domains * smb->z_domains;
+
+  if (strncmp(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic)) != 0
+      || header.version != CHECKPOINT_VERSION)
+    LOG_S(FATAL) << "``" << file_name << "'' is not a checkpoint file, or it's version is not supported";
+
+  if (header.particle_size != sizeof(Particle))
+    LOG_S(FATAL) << "Checkpoint ``" << file_name << "'' is written by application "
+                 << "with different particles precision";
+
+  if (header.momentum != CHECKPOINT_MOMENTUM)
+    LOG_S(FATAL) << "Checkpoint ``" << file_name << "'' is written by application "
+                 << "with different particles velocity/momentum representation";
+
+  if (header.domains_amount != domains_amount)
+    LOG_S(FATAL) << "Checkpoint ``" << file_name << "'' has " << header.domains_amount
+                 << " domains, but simulation has " << domains_amount;
+
+  vector<size_t> offsets (domains_amount + 1);
+  memcpy(offsets.data(), data + sizeof(checkpoint_header), sizeof(size_t) * (domains_amount + 1));
+
+  if (offsets[domains_amount] != file_size)
+    LOG_S(FATAL) << "Checkpoint ``" << file_name << "'' is truncated or corrupted";
+
+  string rng_state (data + sizeof(checkpoint_header) + sizeof(size_t) * (domains_amount + 1),
+                    header.rng_state_size);
+  math::random::set_state(rng_state);
+
+  time->current = header.time_current;
+  time->print_header_counter = header.print_header_counter;
+
+#pragma omp parallel for
+  for (unsigned int d = 0; d < domains_amount; ++d)
+    domain_deserialize(smb->domains(d / smb->z_domains, d % smb->z_domains),
+                       data + offsets[d], offsets[d + 1] - offsets[d]);
+
+  munmap(data, file_size);
+  close(fd);
+
+  chrono::duration<double> elapsed = chrono::steady_clock::now() - begin;
+  LOG_S(INFO) << "Checkpoint ``" << file_name << "'' loaded. Continue from "
+              << time->current << " (loaded in " << elapsed.count() << " s)";
+}
@@ -61,19 +61,13 @@ Collisions::Collisions (Geometry* _geometry, TimeSim *_time, vector <SpecieP *>
 //! TA77: clear
 void Collisions::clear()
 {
-  energy_tot_el = 0;
-  energy_tot_el.overlay_set(0);
-  amount_tot_el = 0;
-  amount_tot_el.overlay_set(0);
-  moment_tot_el = 0;
-  moment_tot_el.overlay_set(0);
-
-  energy_tot_ion = 0;
-  energy_tot_ion.overlay_set(0);
-  amount_tot_ion = 0;
-  amount_tot_ion.overlay_set(0);
-  moment_tot_ion = 0;
-  moment_tot_ion.overlay_set(0);
+  energy_tot_el.zero();
+  amount_tot_el.zero();
+  moment_tot_el.zero();
+
+  energy_tot_ion.zero();
+  amount_tot_ion.zero();
+  moment_tot_ion.zero();
 
   for (int i = 0; i < geometry->cell_amount[0]; ++i)
     for (int j = 0; j < geometry->cell_amount[1]; ++j)
@@ -180,9 +174,8 @@ void Collisions::collect_weighted_params_tot_grid ()
       // ion weighting
       for (unsigned int k = 0; k < vec_size_ions; ++k)
       {
-        double vr = P_VEL_R((*map_ion2cell(i, j)[k]));
-        double vphi = P_VEL_PHI((*map_ion2cell(i, j)[k]));
-        double vz = P_VEL_Z((*map_ion2cell(i, j)[k]));
+        double vr, vphi, vz;
+        particle_velocity((*map_ion2cell(i, j)[k]), vr, vphi, vz);
         double v_sq = vr*vr + vphi*vphi + vz*vz;
 
         double weight = P_WEIGHT((*map_ion2cell(i, j)[k]));
@@ -201,9 +194,8 @@ void Collisions::collect_weighted_params_tot_grid ()
       // electron weighting
       for (unsigned int k = 0; k < vec_size_electrons; ++k)
       {
-        double vr = P_VEL_R((*map_el2cell(i, j)[k]));
-        double vphi = P_VEL_PHI((*map_el2cell(i, j)[k]));
-        double vz = P_VEL_Z((*map_el2cell(i, j)[k]));
+        double vr, vphi, vz;
+        particle_velocity((*map_el2cell(i, j)[k]), vr, vphi, vz);
         double v_sq = vr*vr + vphi*vphi + vz*vz;
 
         double weight = P_WEIGHT((*map_el2cell(i, j)[k]));
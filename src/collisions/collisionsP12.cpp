@@ -45,17 +45,13 @@ void CollisionsP12::collide_single(double m_real_a, double m_real_b,
   // a-particle should be lighter, than b-particle
   if (w_ratio <= 1)
   {
-    v_a[0] = P_VEL_R(pa);
-    v_a[1] = P_VEL_PHI(pa);
-    v_a[2] = P_VEL_Z(pa);
+    v_a = particle_velocity(pa);
     charge_a = q_real_a;
     mass_a = m_real_a;
     w_a = P_WEIGHT(pa);
     density_a = _density_a;
 
-    v_b[0] = P_VEL_R(pb);
-    v_b[1] = P_VEL_PHI(pb);
-    v_b[2] = P_VEL_Z(pb);
+    v_b = particle_velocity(pb);
     charge_b = q_real_b;
     mass_b = m_real_b;
     w_b = P_WEIGHT(pb);
@@ -63,17 +59,13 @@ void CollisionsP12::collide_single(double m_real_a, double m_real_b,
   }
   else
   {
-    v_a[0] = P_VEL_R(pb);
-    v_a[1] = P_VEL_PHI(pb);
-    v_a[2] = P_VEL_Z(pb);
+    v_a = particle_velocity(pb);
     charge_a = q_real_b;
     mass_a = m_real_b;
     w_a = P_WEIGHT(pb);
     density_a = _density_b;
 
-    v_b[0] = P_VEL_R(pa);
-    v_b[1] = P_VEL_PHI(pa);
-    v_b[2] = P_VEL_Z(pa);
+    v_b = particle_velocity(pa);
     charge_b = q_real_a;
     mass_b = m_real_a;
     w_b = P_WEIGHT(pa);
@@ -297,32 +289,24 @@ void CollisionsP12::collide_single(double m_real_a, double m_real_b,
     // according to rejection scheme
     if (U_defl < w_a)
     {
-      P_VEL_R(pa) = v_b_prime[0];
-      P_VEL_PHI(pa) = v_b_prime[1];
-      P_VEL_Z(pa) = v_b_prime[2];
+      set_particle_velocity(pa, v_b_prime);
     }
 
     if (U_defl < w_b)
     {
-      P_VEL_R(pb) = v_a_prime[0];
-      P_VEL_PHI(pb) = v_a_prime[1];
-      P_VEL_Z(pb) = v_a_prime[2];
+      set_particle_velocity(pb, v_a_prime);
     }
   }
   else
   {
     if (U_defl < w_a)
     {
-      P_VEL_R(pa) = v_a_prime[0];
-      P_VEL_PHI(pa) = v_a_prime[1];
-      P_VEL_Z(pa) = v_a_prime[2];
+      set_particle_velocity(pa, v_a_prime);
     }
 
     if (U_defl < w_b)
     {
-      P_VEL_R(pb) = v_b_prime[0];
-      P_VEL_PHI(pb) = v_b_prime[1];
-      P_VEL_Z(pb) = v_b_prime[2];
+      set_particle_velocity(pb, v_b_prime);
     }
   }
 }
@@ -46,32 +46,24 @@ void CollisionsTA77S::collide_single(double m_real_a, double m_real_b,
   // a-particle should be lighter, than b-particle
   if (w_ratio <= 1)
   {
-    vr_a = P_VEL_R(pa);
-    vphi_a = P_VEL_PHI(pa);
-    vz_a = P_VEL_Z(pa);
+    particle_velocity(pa, vr_a, vphi_a, vz_a);
     charge_a = q_real_a;
     mass_a = m_real_a;
     density_a = _density_a;
 
-    vr_b = P_VEL_R(pb);
-    vphi_b = P_VEL_PHI(pb);
-    vz_b = P_VEL_Z(pb);
+    particle_velocity(pb, vr_b, vphi_b, vz_b);
     charge_b = q_real_b;
     mass_b = m_real_b;
     density_b = _density_b;
   }
   else
   {
-    vr_a = P_VEL_R(pb);
-    vphi_a = P_VEL_PHI(pb);
-    vz_a = P_VEL_Z(pb);
+    particle_velocity(pb, vr_a, vphi_a, vz_a);
     charge_a = q_real_b;
     mass_a = m_real_b;
     density_a = _density_b;
 
-    vr_b = P_VEL_R(pa);
-    vphi_b = P_VEL_PHI(pa);
-    vz_b = P_VEL_Z(pa);
+    particle_velocity(pa, vr_b, vphi_b, vz_b);
     charge_b = q_real_a;
     mass_b = m_real_a;
     density_b = _density_a;
@@ -188,23 +180,13 @@ void CollisionsTA77S::collide_single(double m_real_a, double m_real_b,
   // set new velocity components
   if (swap)
   {
-    P_VEL_R(pa) = vr_b_new;
-    P_VEL_PHI(pa) = vphi_b_new;
-    P_VEL_Z(pa) = vz_b_new;
-
-    P_VEL_R(pb) = vr_a_new;
-    P_VEL_PHI(pb) = vphi_a_new;
-    P_VEL_Z(pb) = vz_a_new;
+    set_particle_velocity(pa, vr_b_new, vphi_b_new, vz_b_new);
+    set_particle_velocity(pb, vr_a_new, vphi_a_new, vz_a_new);
   }
   else
   {
-    P_VEL_R(pa) = vr_a_new;
-    P_VEL_PHI(pa) = vphi_a_new;
-    P_VEL_Z(pa) = vz_a_new;
-
-    P_VEL_R(pb) = vr_b_new;
-    P_VEL_PHI(pb) = vphi_b_new;
-    P_VEL_Z(pb) = vz_b_new;
+    set_particle_velocity(pa, vr_a_new, vphi_a_new, vz_a_new);
+    set_particle_velocity(pb, vr_b_new, vphi_b_new, vz_b_new);
   }
 
   if (vr_a_new > LIGHT_VEL || vphi_a_new > LIGHT_VEL || vz_a_new > LIGHT_VEL
@@ -433,9 +415,8 @@ void CollisionsTA77S::correct_velocities()
 
       for (unsigned int k = 0; k < vec_size_ions; ++k)
       {
-        double vr = P_VEL_R((*map_ion2cell(i, j)[k]));
-        double vphi = P_VEL_PHI((*map_ion2cell(i, j)[k]));
-        double vz = P_VEL_Z((*map_ion2cell(i, j)[k]));
+        double vr, vphi, vz;
+        particle_velocity((*map_ion2cell(i, j)[k]), vr, vphi, vz);
         double v_sq = vr*vr + vphi*vphi + vz*vz;
 
         // mass of the macroparticle
@@ -449,9 +430,8 @@ void CollisionsTA77S::correct_velocities()
 
       for (unsigned int k = 0; k < vec_size_electrons; ++k)
       {
-        double vr = P_VEL_R((*map_el2cell(i, j)[k]));
-        double vphi = P_VEL_PHI((*map_el2cell(i, j)[k]));
-        double vz = P_VEL_Z((*map_el2cell(i, j)[k]));
+        double vr, vphi, vz;
+        particle_velocity((*map_el2cell(i, j)[k]), vr, vphi, vz);
         double v_sq = vr*vr + vphi*vphi + vz*vz;
 
         double mass_m = mass_el * P_WEIGHT((*map_el2cell(i, j)[k]));
@@ -523,17 +503,14 @@ void CollisionsTA77S::correct_velocities()
 
         for (unsigned int k = 0; k < vec_size_ions; ++k)
         {
-          double vr = P_VEL_R((*map_ion2cell(i, j)[k]));
-          double vphi = P_VEL_PHI((*map_ion2cell(i, j)[k]));
-          double vz = P_VEL_Z((*map_ion2cell(i, j)[k]));
+          double vr, vphi, vz;
+          particle_velocity((*map_ion2cell(i, j)[k]), vr, vphi, vz);
 
           double vr_corr = V_0_r_ion + alpha_ion * (vr - V_0_r_ion - delta_V_r_ion);
           double vphi_corr = V_0_phi_ion + alpha_ion * (vphi - V_0_phi_ion - delta_V_phi_ion);
           double vz_corr = V_0_z_ion + alpha_ion * (vz - V_0_z_ion - delta_V_z_ion);
 
-          P_VEL_R((*map_ion2cell(i, j)[k])) = vr_corr;
-          P_VEL_PHI((*map_ion2cell(i, j)[k])) = vphi_corr;
-          P_VEL_Z((*map_ion2cell(i, j)[k])) = vz_corr;
+          set_particle_velocity((*map_ion2cell(i, j)[k]), vr_corr, vphi_corr, vz_corr);
         }
       }
 
@@ -549,17 +526,14 @@ void CollisionsTA77S::correct_velocities()
 
         for (unsigned int k = 0; k < vec_size_electrons; ++k)
         {
-          double vr = P_VEL_R((*map_el2cell(i, j)[k]));
-          double vphi = P_VEL_PHI((*map_el2cell(i, j)[k]));
-          double vz = P_VEL_Z((*map_el2cell(i, j)[k]));
+          double vr, vphi, vz;
+          particle_velocity((*map_el2cell(i, j)[k]), vr, vphi, vz);
 
           double vr_corr = V_0_r_el + alpha_el * (vr - V_0_r_el - delta_V_r_el);
           double vphi_corr = V_0_phi_el + alpha_el * (vphi - V_0_phi_el - delta_V_phi_el);
           double vz_corr = V_0_z_el + alpha_el * (vz - V_0_z_el - delta_V_z_el);
 
-          P_VEL_R((*map_el2cell(i, j)[k])) = vr_corr;
-          P_VEL_PHI((*map_el2cell(i, j)[k])) = vphi_corr;
-          P_VEL_Z((*map_el2cell(i, j)[k])) = vz_corr;
+          set_particle_velocity((*map_el2cell(i, j)[k]), vr_corr, vphi_corr, vz_corr);
         }
       }
     }
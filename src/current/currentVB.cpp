@@ -19,157 +19,32 @@
 
 using namespace constant;
 
-void CurrentVB::simple_current_distribution(double radius_new,
-                                          double longitude_new,
-                                          double radius_old,
-                                          double longitude_old,
-                                          int i_n,
-                                          int k_n,
-                                          double p_charge)
+void CurrentVB::segments_distribution()
 {
-  //! shift also to take overlaying into account
-  int i_n_shift = i_n - geometry->cell_dims[0];
-  int k_n_shift = k_n - geometry->cell_dims[1];
+  int bottom_shift = geometry->cell_dims[0];
+  int left_shift = geometry->cell_dims[1];
 
-  double dr = geometry->cell_size[0];
-  double dz = geometry->cell_size[1];
-  double wj = 0;
-  double delta_t = time->step;
+  algo::vb::currents(segments,
+                     geometry->cell_size[0], geometry->cell_size[1], time->step,
+                     segments_currents);
 
-  // distance of particle moving //
-  double delta_r = radius_new - radius_old;
-  double delta_z = longitude_new - longitude_old;
+  // grid accumulation is done in the same order, as segments
+  // are collected, so results does not depend on batching
+  for (size_t n = 0; n < segments.size; ++n)
+  {
+    //! shift also to take overlaying into account
+    int i_n_shift = segments.i[n] - bottom_shift;
+    int k_n_shift = segments.k[n] - left_shift;
 
-  double some_shit_density;
+    current[2].inc(i_n_shift, k_n_shift, segments_currents.j_z_0[n]);
+    current[2].inc(i_n_shift + 1, k_n_shift, segments_currents.j_z_1[n]);
+    current[0].inc(i_n_shift, k_n_shift, segments_currents.j_r_0[n]);
+    current[0].inc(i_n_shift, k_n_shift + 1, segments_currents.j_r_1[n]);
 
-  if ((abs(delta_r) < MNZL) || (abs(delta_z) < MNZL)) // MNZL see constant.h
-    return;
-  // if i cell is not equal 0
-  if (i_n>=1)
-  {
-    // equation y = k*x + b; //
-    // finding k & b //
-    double k = delta_r / delta_z;
-    double b = radius_old;
-
-    // calculate current jz in [i,k] cell
-    some_shit_density = SOME_SHIT_DENSITY_R(p_charge, i_n * dr, dr, dz, delta_t);
-
-    wj = some_shit_density
-      * (dr * delta_z - k * delta_z * delta_z / 2. - delta_z * b + dr * dr / k
-         * ((i_n + 0.5) * (i_n + 0.5) - 0.25) * log((k * delta_z + b) / b));
-    // set new weighting current value
-    // el_current->inc_j_z(i_n, k_n, wj);
-    current[2].inc(i_n_shift, k_n_shift, wj);
-
-    some_shit_density = SOME_SHIT_DENSITY_R(p_charge, (i_n + 1) * dr, dr, dz, delta_t);
-
-    // calculate current in [i+1,k] cell //
-    wj = some_shit_density
-      * (k * delta_z * delta_z / 2. + delta_z * b + delta_z * dr + dr * dr / k *
-         (0.25-(i_n + 0.5) * (i_n + 0.5)) * log((k * delta_z + b) / b));
-    // set new weighting current value
-    // el_current->inc_j_z(i_n+1, k_n, wj);
-    current[2].inc(i_n_shift + 1, k_n_shift, wj);
-
-    ////////////////////////////////// /
-    // calculate current jr in [i,k] cell //
-    // equation y = k * x + b; //
-    // finding k & b //
-    k = -delta_z / delta_r;
-    double r0 = (i_n + 0.5) * dr;
-    double r1 =  radius_old;
-    b = (k_n + 1.) * dz - longitude_old;
-
-    // weighting jr in [i][k] cell
-    some_shit_density = SOME_SHIT_DENSITY_Z(p_charge, r0, dr, dz, delta_t);
-
-    wj = some_shit_density
-      * (r0 * k * delta_r + k / 2. * delta_r * (radius_old + delta_r / 2.)
-         + 0.5 * delta_r * (b - k * (2 * r0 + r1))
-         + delta_r * (b-k * r1) * (4 * r0 * r0-dr * dr)
-         / (8 * radius_old * (radius_old + delta_r)) +
-         (k * (r0 * r0 / 2.-dr * dr / 8.))
-         * log((radius_old + delta_r) / radius_old));
-    // el_current->inc_j_r(i_n,k_n, wj);
-    current[0].inc(i_n_shift, k_n_shift, wj);
-
-    b = longitude_old - k_n * dz;
-    // weighting jr in [i][k+1] cell
-    wj = some_shit_density
-      * (-r0 * k * delta_r - k / 2. * delta_r * (radius_old + delta_r / 2.)
-         + 0.5 * delta_r * (b + k * (2 * r0 + r1))
-         + delta_r * (b + k * r1) * (4 * r0 * r0 - dr * dr)
-         / (8 * radius_old * (radius_old + delta_r))
-         - (k * (r0 * r0 / 2.-dr * dr / 8.))
-         * log((radius_old + delta_r) / radius_old));
-    // el_current->inc_j_r(i_n, k_n+1, wj);
-    current[0].inc(i_n_shift, k_n_shift + 1, wj);
-  }
-  // if i cell is equal 0
-  else
-  {
-    // equation y = k * x + b; //
-    // finding k & b //
-    double k = delta_r / delta_z;
-    double b = radius_old;
-    // calculate current jz in [i,k] cell //
-    some_shit_density = p_charge
-      / (2. * PI * dr / 4. * dr * dz
-         * delta_t
-         * dr);
-
-    wj = some_shit_density
-      * (dr * delta_z - k * delta_z * delta_z / 2. - delta_z * b );
-    // set new weighting current value
-    // el_current->inc_j_z(i_n,k_n, wj);
-    current[2].inc(i_n_shift, k_n_shift, wj);
-
-    // calculate current in [i + 1,k] cell //
-    some_shit_density = SOME_SHIT_DENSITY_R(p_charge, dr, dr, dz, delta_t);
-
-    wj = some_shit_density
-      * (k * delta_z * delta_z / 2. + delta_z * dr + delta_z * b);
-    // set new weighting current value
-    // el_current->inc_j_z(i_n + 1,k_n, wj);
-    current[2].inc(i_n_shift + 1, k_n_shift, wj);
-
-    ////////////////////////////////// /
-    // calculate current jr in [i,k] cell //
-    // equation y = k * x + b; //
-    // finding k & b //
-    k = -delta_z / delta_r;
-    double r0 = (i_n + 0.5) * dr;
-    double r1 = radius_old;
-    b= (k_n + 1.) * dz - longitude_old;
-
-    // weighting jr in [i][k] cell
-    some_shit_density = SOME_SHIT_DENSITY_Z(p_charge, r0, dr, dz, delta_t);
-
-    wj = some_shit_density
-      * (r0 * k * delta_r + k / 2. * delta_r * (radius_old + delta_r / 2.)
-         + 0.5 * delta_r * (b-k * (2 * r0 + r1))
-         + delta_r * (b-k * r1) * (4 * r0 * r0-dr * dr)
-         / (8 * radius_old * (radius_old + delta_r))
-         + (k * (r0 * r0 / 2.-dr * dr / 8.))
-         * log((radius_old + delta_r) / radius_old));
-    // el_current->inc_j_r(i_n,k_n, wj);
-    current[0].inc(i_n_shift, k_n_shift, wj);
-
-    b = longitude_old- k_n * dz;;
-    // weighting jr in [i][k + 1] cell
-    // some_shit_density = SOME_SHIT_DENSITY_Z(p_charge, r0, dr, dz, delta_t);
-
-    wj = some_shit_density
-      * (-r0 * k * delta_r - k / 2. * delta_r * (radius_old + delta_r / 2.)
-         + 0.5 * delta_r * (b + k * (2 * r0 + r1))
-         + delta_r * (b + k * r1) * (4 * r0 * r0-dr * dr)
-         / (8 * radius_old * (radius_old + delta_r))
-         - (k * (r0 * r0 / 2.-dr * dr / 8.)) *
-         log((radius_old + delta_r) / radius_old));
-    // el_current->inc_j_r(i_n, k_n + 1, wj);
-    current[0].inc(i_n_shift, k_n_shift + 1, wj);
+    tiles.touch(i_n_shift, i_n_shift + 1, k_n_shift, k_n_shift + 1);
   }
+
+  segments.size = 0;
 }
 
 void CurrentVB::rz_current_distribution()
@@ -179,7 +54,15 @@ void CurrentVB::rz_current_distribution()
   double dr = geometry->cell_size[0];
   double dz = geometry->cell_size[1];
 
+  segments.size = 0;
+
   for (auto ps = species_p.begin(); ps != species_p.end(); ++ps)
+  {
+    // sub-cycled species are moved once per sub-cycle. Whole
+    // displacement is weighted at once with field time step,
+    // so continuity equation holds at every step
+    if (! (**ps).is_push_step()) continue;
+
     for (auto i = (**ps).particles.begin(); i != (**ps).particles.end(); ++i)
     {
       // finding number new and old cells
@@ -194,8 +77,6 @@ void CurrentVB::rz_current_distribution()
       if (P_POS_R((**i)) == (i_n + 1) * dr) i_n = i_o;
       if (P_POS_Z((**i)) == (k_n + 1) * dz) k_n = k_o;
 
-      int res_cell = abs(i_n - i_o) + abs(k_n - k_o);
-
       if (abs (i_n - i_o) > 1 || abs (i_n - i_o) > 1)
       {
         LOG_S(ERROR) << "rz_current_distribution: can not weight particle's currents. It moved to more than one grid cell. Particle's position (r_old:r_new, z_old:z_new): "
@@ -204,195 +85,28 @@ void CurrentVB::rz_current_distribution()
       }
       else if ((abs(P_POS_R((**i)) - P_POS_OLD_R((**i))) < MNZL)
                || (abs(P_POS_Z((**i)) - P_POS_OLD_Z((**i))) < MNZL))
+      {
+        // strict motion weighting also resets some currents,
+        // so collected segments should be weighted before
+        segments_distribution();
         strict_motion_distribution(P_POS_R((**i)), P_POS_Z((**i)),
                                    P_POS_OLD_R((**i)), P_POS_OLD_Z((**i)),
                                    p_charge);
+      }
       else
       {
-        switch (res_cell)
-        {
-          // 1) charge in four nodes
-        case 0: simple_current_distribution(P_POS_R((**i)), P_POS_Z((**i)),
-                                            P_POS_OLD_R((**i)), P_POS_OLD_Z((**i)),
-                                            i_n, k_n,
-                                            p_charge);
-          break;
-          // 2) charge in 7 nodes
-        case 1:
-        {
-          // charge in 7 nodes. Moving on r-axis (i_new != i_old)
-          if ((i_n != i_o) && (k_n == k_o))
-          {
-            // moving to center from outer to innter cell
-            if (P_POS_OLD_R((**i)) > (i_n + 1) * dr)
-            {
-              double a = (P_POS_OLD_R((**i)) - P_POS_R((**i))) / (P_POS_OLD_Z((**i)) - P_POS_Z((**i)));
-              double r_boundary = (i_n + 1) * dr;
-              double delta_r = r_boundary - P_POS_R((**i));
-              double z_boundary = P_POS_Z((**i)) + delta_r / a;
-
-              simple_current_distribution(r_boundary, z_boundary,
-                                          P_POS_OLD_R((**i)), P_POS_OLD_Z((**i)), i_n + 1, k_n, p_charge);
-              simple_current_distribution(P_POS_R((**i)), P_POS_Z((**i)),
-                                          r_boundary, z_boundary, i_n, k_n, p_charge);
-            }
-            // moving to wall
-            else
-            {
-              double a = (P_POS_R((**i)) - P_POS_OLD_R((**i))) / (P_POS_Z((**i)) - P_POS_OLD_Z((**i)));
-              double r_boundary = (i_n) * dr;
-              double delta_r = r_boundary - P_POS_OLD_R((**i));
-              double z_boundary = P_POS_OLD_Z((**i)) + delta_r / a;
-
-              simple_current_distribution(r_boundary, z_boundary, P_POS_OLD_R((**i)),
-                                          P_POS_OLD_Z((**i)), i_n-1, k_n,
-                                          p_charge);
-              simple_current_distribution(P_POS_R((**i)), P_POS_Z((**i)),
-                                          r_boundary, z_boundary,
-                                          i_n, k_n,
-                                          p_charge);
-            }
-          }
-          // charge in seven cells. Moving on z-axis (k_new != k_old)
-          else if ((i_n == i_o) && (k_n != k_o))
-          {
-            // moving forward from N to N + 1 cell
-            if (P_POS_OLD_Z((**i)) < k_n * dz)
-            {
-              double z_boundary = k_n * dz;
-              double delta_z = z_boundary - P_POS_OLD_Z((**i));
-              double a = (P_POS_R((**i)) - P_POS_OLD_R((**i))) / (P_POS_Z((**i)) - P_POS_OLD_Z((**i)));
-              double r_boundary = P_POS_OLD_R((**i)) + a * delta_z;
-              simple_current_distribution(r_boundary, z_boundary ,P_POS_OLD_R((**i)), P_POS_OLD_Z((**i)), i_n, k_n-1, p_charge);
-              simple_current_distribution(P_POS_R((**i)), P_POS_Z((**i)), r_boundary, z_boundary, i_n, k_n, p_charge);
-            }
-            // moving backward
-            else
-            {
-              double z_boundary = (k_n + 1) * dz;
-              double delta_z = z_boundary - P_POS_Z((**i));
-              double a = (P_POS_OLD_R((**i)) - P_POS_R((**i))) / (P_POS_OLD_Z((**i)) - P_POS_Z((**i)));
-              double r_boundary = P_POS_R((**i)) + a * delta_z;
-              simple_current_distribution(r_boundary, z_boundary, P_POS_OLD_R((**i)), P_POS_OLD_Z((**i)), i_n, k_n + 1, p_charge);
-              simple_current_distribution(P_POS_R((**i)), P_POS_Z((**i)), r_boundary, z_boundary, i_n, k_n, p_charge);
-            }
-          }
-        }
-        break;
-        // 3) charge in 10 nodes
-        case 2:
-        {
-          // moving forward
-          if (i_o < i_n)
-          {
-            // case, when particle move from [i-1][k-1] -> [i][k] cell
-            if(k_o < k_n)
-            {
-              double a = (P_POS_R((**i)) - P_POS_OLD_R((**i))) / (P_POS_Z((**i)) - P_POS_OLD_Z((**i)));
-              double r1 = i_n * dr;
-              double delta_z1 = (r1 - P_POS_OLD_R((**i))) / a;
-              double z1 = P_POS_OLD_Z((**i)) + delta_z1;
-              double z2 = k_n * dz;
-              double delta_r2 = (z2 - P_POS_OLD_Z((**i))) * a;
-              double r2 = P_POS_OLD_R((**i)) + delta_r2;
-              if (z1 < k_n * dz)
-              {
-                simple_current_distribution(r1, z1 ,P_POS_OLD_R((**i)), P_POS_OLD_Z((**i)), i_n-1, k_n-1, p_charge);
-                simple_current_distribution(r2, z2, r1, z1, i_n, k_n-1, p_charge);
-                simple_current_distribution(P_POS_R((**i)), P_POS_Z((**i)), r2, z2, i_n, k_n, p_charge);
-              }
-              else if (z1>k_n * dz)
-              {
-                simple_current_distribution(r2, z2 ,P_POS_OLD_R((**i)), P_POS_OLD_Z((**i)), i_n-1, k_n-1, p_charge);
-                simple_current_distribution(r1, z1, r2, z2,i_n-1, k_n, p_charge);
-                simple_current_distribution(P_POS_R((**i)), P_POS_Z((**i)), r1, z1, i_n, k_n, p_charge);
-              }
-            }
-            // case, when particle move from [i-1][k + 1] -> [i][k] cell
-            else
-            {
-              double a = (P_POS_R((**i)) - P_POS_OLD_R((**i))) / (P_POS_Z((**i)) - P_POS_OLD_Z((**i)));
-              double r1 = i_n * dr;
-              double delta_z1 = (r1 - P_POS_OLD_R((**i))) / a;
-              double z1 = P_POS_OLD_Z((**i)) + delta_z1;
-
-              double z2 = (k_n + 1) * dz;
-              double delta_r2 = -(P_POS_OLD_Z((**i))-z2) * a;
-              double r2 = P_POS_OLD_R((**i)) + delta_r2;
-              if (z1>(k_n + 1) * dz)
-              {
-                simple_current_distribution(r1, z1 ,P_POS_OLD_R((**i)), P_POS_OLD_Z((**i)), i_n-1, k_n + 1, p_charge);
-                simple_current_distribution(r2, z2, r1, z1, i_n, k_n + 1, p_charge);
-                simple_current_distribution(P_POS_R((**i)), P_POS_Z((**i)), r2, z2, i_n, k_n, p_charge);
-              }
-              else if (z1<(k_n + 1) * dz)
-              {
-                simple_current_distribution(r2, z2 ,P_POS_OLD_R((**i)), P_POS_OLD_Z((**i)), i_n-1, k_n + 1, p_charge);
-                simple_current_distribution(r1, z1, r2, z2,i_n-1, k_n, p_charge);
-                simple_current_distribution(P_POS_R((**i)), P_POS_Z((**i)), r1, z1, i_n, k_n, p_charge);
-              }
-            }
-          }
-          // case, when particle move from [i + 1] cell to [i] cell
-          else if (i_o > i_n)
-          {
-            // case, when particle move from [i + 1][k-1] -> [i][k] cell
-            if(k_o<k_n)
-            {
-              double a = (P_POS_R((**i)) - P_POS_OLD_R((**i))) / (P_POS_Z((**i)) - P_POS_OLD_Z((**i)));
-              double r1 = (i_n + 1) * dr;
-              double delta_z1 = -(P_POS_OLD_R((**i))-r1) / a;
-              double z1 = P_POS_OLD_Z((**i)) + delta_z1;
-
-              double z2 = k_n * dz;
-              double delta_r2 = -(z2-P_POS_OLD_Z((**i))) * a;
-              double r2 = P_POS_OLD_R((**i))- delta_r2;
-
-              if (z1<(k_n) * dz)
-              {
-                simple_current_distribution(r1, z1 ,P_POS_OLD_R((**i)), P_POS_OLD_Z((**i)), i_n + 1, k_n-1, p_charge);
-                simple_current_distribution(r2, z2, r1, z1, i_n, k_n-1, p_charge);
-                simple_current_distribution(P_POS_R((**i)), P_POS_Z((**i)), r2, z2, i_n, k_n, p_charge);
-              }
-              else if (z1>(k_n) * dz)
-              {
-                simple_current_distribution(r2, z2 ,P_POS_OLD_R((**i)), P_POS_OLD_Z((**i)), i_n + 1, k_n-1, p_charge);
-                simple_current_distribution(r1, z1, r2, z2,i_n + 1, k_n, p_charge);
-                simple_current_distribution(P_POS_R((**i)), P_POS_Z((**i)), r1, z1, i_n, k_n, p_charge);
-              }
-
-            }
-            // case, when particle move from [i + 1][k + 1] -> [i][k] cell
-            else if (k_o>k_n)
-            {
-              double a = (P_POS_OLD_R((**i))-P_POS_R((**i))) / (P_POS_OLD_Z((**i))-P_POS_Z((**i)));
-              double r1 = (i_n + 1) * dr;
-              double delta_z1 = (r1-P_POS_R((**i))) / a;
-              double z1 = P_POS_Z((**i)) + delta_z1;
-
-              double z2 = (k_n + 1) * dz;
-              double delta_r2 = (z2-P_POS_Z((**i))) * a;
-              double r2 = P_POS_R((**i)) + delta_r2;
-
-              if (z1>(k_n + 1) * dz)
-              {
-                simple_current_distribution(r1, z1, P_POS_OLD_R((**i)),P_POS_OLD_Z((**i)), i_n + 1, k_n + 1, p_charge);
-                simple_current_distribution(r2, z2, r1, z1, i_n, k_n + 1, p_charge);
-                simple_current_distribution(P_POS_R((**i)), P_POS_Z((**i)), r2, z2, i_n, k_n, p_charge);
-              }
-              else if (z1<(k_n + 1) * dz)
-              {
-                simple_current_distribution(r2, z2, P_POS_OLD_R((**i)), P_POS_OLD_Z((**i)), i_n + 1, k_n + 1, p_charge);
-                simple_current_distribution(r1, z1, r2, z2,i_n + 1, k_n, p_charge);
-                simple_current_distribution(P_POS_R((**i)), P_POS_Z((**i)), r1, z1, i_n, k_n, p_charge);
-              }
-            }
-          }
-        }
-        break;
-        }
+        algo::vb::split(P_POS_R((**i)), P_POS_Z((**i)),
+                        P_POS_OLD_R((**i)), P_POS_OLD_Z((**i)),
+                        i_n, k_n, i_o, k_o, dr, dz, p_charge,
+                        segments);
+
+        if (segments.full())
+          segments_distribution();
       }
     }
+  }
+
+  segments_distribution();
 }
 
 void CurrentVB::azimuthal_current_distribution()
@@ -427,6 +141,9 @@ void CurrentVB::azimuthal_current_distribution()
 
       double pos_r = (P_POS_R((**i)) + P_POS_OLD_R((**i))) / 2;
       double pos_z = (P_POS_Z((**i)) + P_POS_OLD_Z((**i))) / 2;;
+      double vel_phi = P_VEL_PHI((**i)) * P_GAMMA_INV((**i));
+
+      tiles.touch(r_i_shift, r_i_shift + 1, z_k_shift, z_k_shift + 1);
       // in first cell other alg. of ro_v calc
       if(pos_r > dr)
       {
@@ -439,25 +156,25 @@ void CurrentVB::azimuthal_current_distribution()
 
         // weighting in j[i][k] cell
         rho = ro_v * CYL_RNG_VOL(dz1, r1, r2) / v_1;
-        wj = rho * P_VEL_PHI((**i));
+        wj = rho * vel_phi;
         // this_j->inc_j_phi(r_i, z_k, wj);
         current[1].inc(r_i_shift, z_k_shift, wj);
 
         // weighting in j[i + 1][k] cell
         rho = ro_v * CYL_RNG_VOL(dz1, r2, r3) / v_2;
-        wj = rho * P_VEL_PHI((**i));
+        wj = rho * vel_phi;
         // this_j->inc_j_phi(r_i + 1,z_k, wj);
         current[1].inc(r_i_shift + 1, z_k_shift, wj);
 
         // weighting in j[i][k + 1] cell
         rho = ro_v * CYL_RNG_VOL(dz2, r1, r2) / v_1;
-        wj = rho * P_VEL_PHI((**i));
+        wj = rho * vel_phi;
         // this_j->inc_j_phi(r_i, z_k + 1, wj);
         current[1].inc(r_i_shift, z_k_shift + 1, wj);
 
         // weighting in j[i + 1][k + 1] cell
         rho = ro_v * CYL_RNG_VOL(dz2, r2, r3) / v_2;
-        wj = rho * P_VEL_PHI((**i));
+        wj = rho * vel_phi;
         // this_j->inc_j_phi(r_i + 1, z_k + 1, wj);
         current[1].inc(r_i_shift + 1, z_k_shift + 1, wj);
       }
@@ -472,25 +189,25 @@ void CurrentVB::azimuthal_current_distribution()
 
         // weighting in j[i][k] cell
         rho = ro_v * CYL_RNG_VOL(dz1, r1, r2) / v_1;
-        wj = rho * P_VEL_PHI((**i));
+        wj = rho * vel_phi;
         // this_j->inc_j_phi(r_i, z_k, wj);
         current[1].inc(r_i_shift, z_k_shift, wj);
 
         // weighting in j[i + 1][k] cell
         rho = ro_v * CYL_RNG_VOL(dz1, r2, r3) / v_2;
-        wj = rho * P_VEL_PHI((**i));
+        wj = rho * vel_phi;
         // this_j->inc_j_phi(r_i + 1,z_k, wj);
         current[1].inc(r_i_shift + 1, z_k_shift, wj);
 
         // weighting in j[i][k + 1] cell
         rho = ro_v * CYL_RNG_VOL(dz2, r1, r2) / v_1;
-        wj = rho * P_VEL_PHI((**i));
+        wj = rho * vel_phi;
         // this_j->inc_j_phi(r_i, z_k + 1, wj);
         current[1].inc(r_i_shift, z_k_shift + 1, wj);
 
         // weighting in j[i + 1][k + 1] cell
         rho = ro_v * CYL_RNG_VOL(dz2, r2, r3) / v_2;
-        wj = rho * P_VEL_PHI((**i));
+        wj = rho * vel_phi;
         // this_j->inc_j_phi(r_i + 1, z_k + 1, wj);
         current[1].inc(r_i_shift + 1, z_k_shift + 1, wj);
       }
@@ -520,6 +237,8 @@ void CurrentVB::strict_motion_distribution(double radius_new,
       && (abs(longitude_new - longitude_old) < MNZL))
     return;
 
+  tiles.touch(i_n_shift - 1, i_n_shift + 1, k_n_shift - 1, k_n_shift + 1);
+
   // stirct axis motion
   if (abs(radius_new - radius_old) < MNZL)
   {
@@ -19,118 +19,94 @@
 
 using namespace constant;
 
+CurrentZigZag::CurrentZigZag(Geometry *geom, TimeSim *t, vector<SpecieP *> species)
+  : Current(geom, t, species)
+{
+  double dr = geometry->cell_size[0];
+  double dz = geometry->cell_size[1];
+
+  // particle's trajectory middle point could be
+  // in the overlay cells around domain
+  inv_volume_first = (int)geometry->cell_dims[0] - 1;
+
+  for (int i = inv_volume_first; i <= (int)geometry->cell_dims[2]; ++i)
+    inv_volume.push_back(1 / (CELL_VOLUME(i, dr, dz)));
+}
+
+void CurrentZigZag::batch_distribution(bool rz_current)
+{
+  algo::zigzag::currents(batch, geometry->cell_size[0], geometry->cell_size[1], time->step,
+                         inv_volume.data(), inv_volume_first, rz_current);
+
+  //! shift also to take overlaying into account
+  int bottom_shift = geometry->cell_dims[0];
+  int left_shift = geometry->cell_dims[1];
+
+  for (size_t n = 0; n < batch.size; ++n)
+  {
+    int i_o_shift = batch.i_o[n] - bottom_shift;
+    int i_n_shift = batch.i_n[n] - bottom_shift;
+    int k_o_shift = batch.k_o[n] - left_shift;
+    int k_n_shift = batch.k_n[n] - left_shift;
+
+    // weight only to grid nodes, related to new position
+    // because oldone is "zeroed", because of
+    // 2.5D simplifications
+    current[1].inc(i_n_shift, k_n_shift, batch.j_phi[0][n]);
+    current[1].inc(i_n_shift, k_n_shift+1, batch.j_phi[1][n]);
+    current[1].inc(i_n_shift+1, k_n_shift, batch.j_phi[2][n]);
+    current[1].inc(i_n_shift+1, k_n_shift+1, batch.j_phi[3][n]);
+
+    tiles.touch(i_n_shift, i_n_shift+1, k_n_shift, k_n_shift+1);
+
+    if (! rz_current)
+      continue;
+
+    current[0].inc(i_o_shift, k_o_shift, batch.j_r[0][n]);
+    current[0].inc(i_o_shift, k_o_shift+1, batch.j_r[1][n]);
+    current[0].inc(i_n_shift, k_n_shift, batch.j_r[2][n]);
+    current[0].inc(i_n_shift, k_n_shift+1, batch.j_r[3][n]);
+
+    current[2].inc(i_o_shift, k_o_shift, batch.j_z[0][n]);
+    current[2].inc(i_o_shift+1, k_o_shift, batch.j_z[1][n]);
+    current[2].inc(i_n_shift, k_n_shift, batch.j_z[2][n]);
+    current[2].inc(i_n_shift+1, k_n_shift, batch.j_z[3][n]);
+
+    tiles.touch(i_o_shift, i_o_shift+1, k_o_shift, k_o_shift+1);
+  }
+
+  batch.size = 0;
+}
+
 void CurrentZigZag::current_distribution()
 {
   current.overlay_set(0);
 
-  double dr = geometry->cell_size[0];
-  double dz = geometry->cell_size[1];
-  double dt = time->step;
+  batch.size = 0;
 
   for (auto ps = species_p.begin(); ps != species_p.end(); ++ps)
+  {
+    // sub-cycled species are moved once per sub-cycle. Whole
+    // displacement is weighted at once with field time step,
+    // so continuity equation holds at every step. Azimuthal
+    // current depends on velocity, not displacement, so it
+    // is weighted every step (positions are not changed
+    // between push steps)
+    bool rz_current = (**ps).is_push_step();
+
     for (auto i = (**ps).particles.begin(); i != (**ps).particles.end(); ++i)
     {
-      //// Preparation
-
-      // particle's position at t and \f$t + \Delta t \f$
-      // TODO: is it P_POS and P_POS_OLD?
-      double r_pos_old = P_POS_OLD_R((**i));
-      double z_pos_old = P_POS_OLD_Z((**i));
-      double r_pos_new = P_POS_R((**i));
-      double z_pos_new = P_POS_Z((**i));
-
-      double charge_over_dt = (**ps).charge * P_WEIGHT((**i)) / dt;
-
-      // finding number new and old cells
-      int i_n = CELL_NUMBER(r_pos_new, dr);
-      int i_o = CELL_NUMBER(r_pos_old, dr);
-      int k_n = CELL_NUMBER(z_pos_new, dz);
-      int k_o = CELL_NUMBER(z_pos_old, dz);
-
-      //! shift also to take overlaying into account
-      int i_o_shift = i_o - geometry->cell_dims[0];
-      int i_n_shift = i_n - geometry->cell_dims[0];
-      int k_o_shift = k_o - geometry->cell_dims[1];
-      int k_n_shift = k_n - geometry->cell_dims[1];
-
-      // find number of cell for middle point
-      // between \f$ r_{old} \f$ and \f$ r_{new} \f$
-      int i_middle = CELL_NUMBER((r_pos_new + r_pos_old) / 2., dr);
-      double one_over_volume = 1 / (CELL_VOLUME(i_middle, dr, dz));
-
-      //// Calculation
-
-      //! \f$ F_{\phi} = \frac{Q_{prtl} * (\phi{new} + \phi_{new})}{\Delta t} \f$
-      double F_phi = (**ps).charge * P_WEIGHT((**i)) * P_VEL_PHI((**i));
-
-      //! the formula is \f$ \frac{\phi_{old} + \phi_{new}}{2 \Delta \phi} - j_{old} \f$
-      //! where \f$ j_{old} \f$ is 0 as well as \f$ j_{new} \f$ and
-      //! \f$ \Delta \phi \f$ is full circle = \f$ 2 \pi r\f$,
-      //! where \f$ r = (r_{position \; old} + r_{position \; new}) / 2\f$
-      //! and (phi_pos_old + phi_pos_new) / 2 = \frac{v_{\phi} \Delta t}{2}
-      double W_phi = P_VEL_PHI((**i)) * dt / (2. * PI * (r_pos_old + r_pos_new));
-
-      double r_relay_pos = RELAY_POINT(i_o, i_n, r_pos_old, r_pos_new, dr);
-      double z_relay_pos = RELAY_POINT(k_o, k_n, z_pos_old, z_pos_new, dz);
-
-      double F_r1 = charge_over_dt * (r_relay_pos - r_pos_old);
-      double F_r2 = charge_over_dt * (r_pos_new - r_relay_pos);
-      double F_z1 = charge_over_dt * (z_relay_pos - z_pos_old);
-      double F_z2 = charge_over_dt * (z_pos_new - z_relay_pos);
-
-      double W_r1 = (r_pos_old + r_relay_pos) / 2 - i_o * dr;
-      double W_r2 = (r_pos_new + r_relay_pos) / 2 - i_n * dr;
-      double W_z1 = (z_pos_old + z_relay_pos) / 2 - k_o * dz;
-      double W_z2 = (z_pos_new + z_relay_pos) / 2 - k_n * dz;
-
-      double one_minus_Wr1 = 1 - W_r1;
-      double one_minus_Wr2 = 1 - W_r2;
-      double one_minus_Wz1 = 1 - W_z1;
-      double one_minus_Wz2 = 1 - W_z2;
-      double one_minus_Wphi = 1 - W_phi;
-
-      double Jr_i1h_j1_k1 = one_over_volume * F_r1 * one_minus_Wphi * one_minus_Wz1;
-      double Jr_i2h_j2_k2 = one_over_volume * F_r2 * one_minus_Wphi * one_minus_Wz2;
-      double Jr_i1h_j1_1_k1 = one_over_volume * F_r1 * W_phi * one_minus_Wz1;
-      double Jr_i2h_j2_1_k2 = one_over_volume * F_r2 * W_phi * one_minus_Wz2;
-      double Jr_i1h_j1_k1_1 = one_over_volume * F_r1 * one_minus_Wphi * W_z1;
-      double Jr_i2h_j2_k2_1 = one_over_volume * F_r2 * one_minus_Wphi * W_z2;
-      double Jr_i1h_j1_1_k1_1 = one_over_volume * F_r1 * W_phi * W_z1;
-      double Jr_i2h_j2_1_k2_1 = one_over_volume * F_r2 * W_phi * W_z2;
-
-      // Let \f$ \phi_{relay} = \phi_{1} = 0
-      // because geometry is axisymmetric
-      double Jphi_i_jh_k = one_over_volume * F_phi * one_minus_Wr2 * one_minus_Wz2;
-      double Jphi_i_jh_k_1 = one_over_volume * F_phi * one_minus_Wr2 * W_z1;
-      double Jphi_i_1_jh_k = one_over_volume * F_phi * W_r2 * one_minus_Wz2;
-      double Jphi_i_1_jh_k_1 = one_over_volume * F_phi * W_r2 * W_z2;
-
-      double Jz_i1_j1_k1h = one_over_volume * F_z1 * one_minus_Wr1 * one_minus_Wphi;
-      double Jz_i2_j2_k2h = one_over_volume * F_z2 * one_minus_Wr2 * one_minus_Wphi;
-      double Jz_i1_j1_1_k1h = one_over_volume * F_z1 * one_minus_Wr1 * W_phi;
-      double Jz_i2_j2_1_k2h = one_over_volume * F_z2 * one_minus_Wr2 * W_phi;
-      double Jz_i1_1_j1_k1h = one_over_volume * F_z1 * W_r1 * one_minus_Wphi;
-      double Jz_i2_1_j2_k2h = one_over_volume * F_z2 * W_r2 * one_minus_Wphi;
-      double Jz_i1_1_j1_1_k1h = one_over_volume * F_z1 * W_r1 * W_phi;
-      double Jz_i2_1_j2_1_k2h = one_over_volume * F_z2 * W_r2 * W_phi;
-
-      // weight currents with calculated values
-      current[0].inc(i_o_shift, k_o_shift, Jr_i1h_j1_k1 + Jr_i1h_j1_1_k1);
-      current[0].inc(i_o_shift, k_o_shift+1, Jr_i1h_j1_k1_1 + Jr_i1h_j1_1_k1_1);
-      current[0].inc(i_n_shift, k_n_shift, Jr_i2h_j2_k2 + Jr_i2h_j2_1_k2);
-      current[0].inc(i_n_shift, k_n_shift+1, Jr_i2h_j2_k2_1 + Jr_i2h_j2_1_k2_1);
-
-      // weight only to grid nodes, related to new position
-      // because oldone is "zeroed", because of
-      // 2.5D simplifications
-      current[1].inc(i_n_shift, k_n_shift, Jphi_i_jh_k);
-      current[1].inc(i_n_shift, k_n_shift+1, Jphi_i_jh_k_1);
-      current[1].inc(i_n_shift+1, k_n_shift, Jphi_i_1_jh_k);
-      current[1].inc(i_n_shift+1, k_n_shift+1, Jphi_i_1_jh_k_1);
-
-      current[2].inc(i_o_shift, k_o_shift, Jz_i1_j1_k1h + Jz_i1_j1_1_k1h);
-      current[2].inc(i_o_shift+1, k_o_shift, Jz_i1_1_j1_k1h + Jz_i1_1_j1_1_k1h);
-      current[2].inc(i_n_shift, k_n_shift, Jz_i2_j2_k2h + Jz_i2_j2_1_k2h);
-      current[2].inc(i_n_shift+1, k_n_shift, Jz_i2_1_j2_k2h + Jz_i2_1_j2_1_k2h);
+      // cell numbers of new position are already bound
+      batch.add(P_POS_OLD_R((**i)), P_POS_OLD_Z((**i)),
+                P_POS_R((**i)), P_POS_Z((**i)),
+                P_CELL_R((**i)), P_CELL_Z((**i)),
+                (**ps).charge * P_WEIGHT((**i)),
+                P_VEL_PHI((**i)) * P_GAMMA_INV((**i)));
+
+      if (batch.full())
+        batch_distribution(rz_current);
     }
+
+    batch_distribution(rz_current);
+  }
 }
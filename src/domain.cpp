@@ -15,11 +15,31 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include "domain.hpp"
+#include "domainT.hpp"
+
+#include <map>
+#include <algorithm>
+
+#include "pusher/pusherBoris.hpp"
+#include "pusher/pusherVay.hpp"
+#include "pusher/pusherHC.hpp"
+
+#include "maxwellSolver/maxwellSolverYee.hpp"
+
+#include "current/currentVB.hpp"
+#include "current/currentZigZag.hpp"
+
+#include "collisions/collisionsNone.hpp"
+#ifdef ENABLE_COULOMB_COLLISIONS
+#include "collisions/collisionsTA77S.hpp"
+#include "collisions/collisionsSK98.hpp"
+#include "collisions/collisionsP12.hpp"
+#endif // ENABLE_COULOMB_COLLISIONS
 
 Domain::Domain(Geometry _geometry, vector<SpecieP *> _species_p, TimeSim* _time) : geometry(_geometry)
 {
-  //! Pass geometry, particle species configuration and time
+  //! Pass geometry, particle species configuration and time.
+  //! Solvers are created by DomainT
   // TODO: is it ok to pass only configuration,
   // but not prepared particles specie w/o linking?
 
@@ -27,40 +47,105 @@ Domain::Domain(Geometry _geometry, vector<SpecieP *> _species_p, TimeSim* _time)
 
   species_p = _species_p;
 
-#ifdef SWITCH_CCS_VB
-  current = new CurrentVB(&geometry, time, species_p);
-#elif defined(SWITCH_CCS_ZIGZAG)
-  current = new CurrentZigZag(&geometry, time, species_p);
-#endif
+  current = NULL;
+  maxwell_solver = NULL;
+}
+
+Domain::~Domain()
+{
+  for (auto i = species_p.begin(); i != species_p.end(); i++)
+    delete *i;
+  species_p.clear();
+}
+
+//
+// runtime dispatch table of solvers combinations
+//
+typedef Domain* (*domain_factory)(Geometry, vector<SpecieP *>, TimeSim*);
+typedef map<string, domain_factory> domain_factories;
+
+template <class PusherT, class DepositT, class FieldSolverT, class CollisionsT>
+static Domain* make_domain(Geometry _geometry, vector<SpecieP *> _species_p, TimeSim* _time)
+{
+  return new DomainT<PusherT, DepositT, FieldSolverT, CollisionsT>(_geometry, _species_p, _time);
+}
+
+static string solvers_key(const solvers_data &solvers)
+{
+  return solvers.pusher + ":" + solvers.current + ":"
+    + solvers.maxwell_solver + ":" + solvers.collisions;
+}
+
+template <class DepositT, class FieldSolverT, class CollisionsT>
+static void register_pushers(domain_factories &table, solvers_data solvers)
+{
+  solvers.pusher = "boris";
+  table[solvers_key(solvers)] = &make_domain<PusherBoris<FieldSolverT, BORIS_CLASSIC>, DepositT, FieldSolverT, CollisionsT>;
+  solvers.pusher = "boris_adaptive";
+  table[solvers_key(solvers)] = &make_domain<PusherBoris<FieldSolverT, BORIS_ADAPTIVE>, DepositT, FieldSolverT, CollisionsT>;
+  solvers.pusher = "boris_relativistic";
+  table[solvers_key(solvers)] = &make_domain<PusherBoris<FieldSolverT, BORIS_RELATIVISTIC>, DepositT, FieldSolverT, CollisionsT>;
+  solvers.pusher = "vay";
+  table[solvers_key(solvers)] = &make_domain<PusherVay<FieldSolverT>, DepositT, FieldSolverT, CollisionsT>;
+  solvers.pusher = "hc";
+  table[solvers_key(solvers)] = &make_domain<PusherHC<FieldSolverT>, DepositT, FieldSolverT, CollisionsT>;
+}
+
+template <class FieldSolverT, class CollisionsT>
+static void register_currents(domain_factories &table, solvers_data solvers)
+{
+  solvers.current = "vb";
+  register_pushers<CurrentVB, FieldSolverT, CollisionsT>(table, solvers);
+  solvers.current = "zigzag";
+  register_pushers<CurrentZigZag, FieldSolverT, CollisionsT>(table, solvers);
+}
+
+static domain_factories build_domain_factories()
+{
+  domain_factories table;
+  solvers_data solvers;
 
-#ifdef SWITCH_MAXWELL_SOLVER_YEE
-  maxwell_solver = new MaxwellSolverYee(&geometry, time, species_p, current);
-#endif
+  solvers.maxwell_solver = "yee";
 
+  solvers.collisions = "none";
+  register_currents<MaxwellSolverYee, CollisionsNone>(table, solvers);
 #ifdef ENABLE_COULOMB_COLLISIONS
-#ifdef SWITCH_COULOMB_COLLISIONS_TA77S
-  collisions = new CollisionsTA77S(&geometry, time, species_p);
-#elif defined(SWITCH_COULOMB_COLLISIONS_SK98)
-  collisions = new CollisionsSK98(&geometry, time, species_p);
-#elif defined(SWITCH_COULOMB_COLLISIONS_P12)
-  collisions = new CollisionsP12(&geometry, time, species_p);
-#endif // WITH_COULOMB_COLLISIONS
+  solvers.collisions = "ta77s";
+  register_currents<MaxwellSolverYee, CollisionsTA77S>(table, solvers);
+  solvers.collisions = "sk98";
+  register_currents<MaxwellSolverYee, CollisionsSK98>(table, solvers);
+  solvers.collisions = "p12";
+  register_currents<MaxwellSolverYee, CollisionsP12>(table, solvers);
 #endif // ENABLE_COULOMB_COLLISIONS
 
-  // ! Linking classes:
-  // ! * insert field pointers to each particles specie
-  for (auto sp = species_p.begin(); sp != species_p.end(); ++sp)
-  {
-    (**sp).maxwell_solver = maxwell_solver;
-  }
+  return table;
+}
+
+static const domain_factories& get_domain_factories()
+{
+  static const domain_factories table = build_domain_factories();
+
+  return table;
+}
+
+bool Domain::available(const solvers_data &solvers)
+{
+  const domain_factories &table = get_domain_factories();
+
+  return table.find(solvers_key(solvers)) != table.end();
+}
+
+Domain* Domain::create(const solvers_data &solvers, Geometry _geometry,
+                       vector<SpecieP *> _species_p, TimeSim* _time)
+{
+  const domain_factories &table = get_domain_factories();
+  auto factory = table.find(solvers_key(solvers));
+
+  if (factory == table.end())
+    LOG_S(FATAL) << "Solvers combination ``" << solvers_key(solvers)
+                 << "'' (pusher:current:maxwell_solver:collisions) is not available";
 
-#if defined(SWITCH_PUSHER_BORIS_ADAPTIVE) || defined(SWITCH_PUSHER_BORIS) || defined(SWITCH_PUSHER_BORIS_RELATIVISTIC)
-  pusher = new PusherBoris(maxwell_solver, species_p, time);
-#elif defined(SWITCH_PUSHER_VAY)
-  pusher = new PusherVay(maxwell_solver, species_p, time);
-#elif defined(SWITCH_PUSHER_HC)
-  pusher = new PusherHC(maxwell_solver, species_p, time);
-#endif
+  return factory->second(_geometry, _species_p, _time);
 }
 
 void Domain::distribute()
@@ -95,25 +180,9 @@ void Domain::weight_temperature(string specie)
   speciep->calc_temperature();
 }
 
-void Domain::weight_field_h()
-{
-  maxwell_solver->calc_field_h();
-}
-
-void Domain::weight_field_e()
-{
-  maxwell_solver->calc_field_e();
-}
-
 void Domain::reset_current()
 {
-  current->current = 0;
-  current->current.overlay_set(0);
-}
-
-void Domain::push_particles ()
-{
-  (*pusher)();
+  current->reset();
 }
 
 void Domain::update_particles_coords()
@@ -130,6 +199,13 @@ void Domain::bind_cell_numbers()
     (**i).bind_cell_numbers();
 }
 
+void Domain::resample_particles(unsigned int min_per_cell, unsigned int max_per_cell)
+{
+  // ! merge and split particles of each specie per cell
+  for (auto i = species_p.begin(); i != species_p.end(); i++)
+    (**i).resample(min_per_cell, max_per_cell);
+}
+
 void Domain::reflect()
 {
   // ! update particles coordinates
@@ -158,20 +234,134 @@ void Domain::manage_beam()
       (**i).inject();
 }
 
-void Domain::weight_current()
+void Domain::dump_particle_positions_to_old()
 {
-  current->current_distribution();
+  for (auto i = species_p.begin(); i != species_p.end(); i++)
+    (**i).dump_position_to_old();
 }
 
-void Domain::dump_particle_positions_to_old()
+size_t Domain::particles_amount()
 {
+  size_t amount = 0;
+
   for (auto i = species_p.begin(); i != species_p.end(); i++)
-    (**i).dump_position_to_old();
+    amount += (**i).particles.size();
+
+  return amount;
 }
 
-#ifdef ENABLE_COULOMB_COLLISIONS
-void Domain::collide()
+vector< Grid3D<double> * > Domain::window_grids()
+{
+  //! grids, moved with window. Current is moved too, because window
+  //! is moved after deposition, and current is used by electric field
+  //! solver at the next step. Density and temperature are recalculated
+  //! on demand, PML and dielectric walls are bound to window,
+  //! so they are not moved
+  vector< Grid3D<double> * > grids = { &maxwell_solver->field_e,
+                                       &maxwell_solver->field_h,
+                                       &current->current };
+
+  // fields, accumulated for sub-cycled species
+  for (auto i = species_p.begin(); i != species_p.end(); i++)
+    if ((**i).push_every > 1)
+    {
+      grids.push_back(&(**i).field_e_sum);
+      grids.push_back(&(**i).field_h_sum);
+    }
+
+  return grids;
+}
+
+void Domain::reserve_window()
 {
-  collisions->run();
+  vector< Grid3D<double> * > grids = window_grids();
+
+  for (auto g = grids.begin(); g != grids.end(); ++g)
+    (**g).reserve_shift_y(WINDOW_SHIFT_RESERVE);
+}
+
+void Domain::prepare_window_shift(Domain *next_domain)
+{
+  //! set column, which is shifted into domain: first column
+  //! of next domain, or empty one at leading edge of window.
+  //! Should be done for all of the domains before shift
+  vector< Grid3D<double> * > grids = window_grids();
+
+  if (next_domain == NULL)
+    for (auto g = grids.begin(); g != grids.end(); ++g)
+      (**g).clear_next_y();
+  else
+  {
+    vector< Grid3D<double> * > next_grids = next_domain->window_grids();
+
+    for (size_t g = 0; g < grids.size(); ++g)
+      grids[g]->copy_next_y(*next_grids[g]);
+  }
+}
+
+void Domain::shift_window()
+{
+  //! shift domain by one cell in z direction
+  vector< Grid3D<double> * > grids = window_grids();
+
+  for (auto g = grids.begin(); g != grids.end(); ++g)
+    (**g).shift_y();
+
+  // shifted values could get into any tile of current grid
+  current->tiles.touch_all();
+
+  shift_window_geometry(1);
+}
+
+void Domain::shift_window_geometry(size_t cells)
+{
+  //! particles positions and cell numbers are global,
+  //! so only domain edges are shifted
+  geometry.cell_dims[1] += cells;
+  geometry.cell_dims[3] += cells;
+
+  // all of the particle species share the same geometry
+  if (! species_p.empty())
+  {
+    species_p[0]->geometry->cell_dims[1] += cells;
+    species_p[0]->geometry->cell_dims[3] += cells;
+  }
+}
+
+void Domain::load_window_edge()
+{
+  //! load background plasma to the leading edge of window.
+  //! Cell at z=z wall is not filled (see rectangular_spatial_distribution)
+  unsigned int right_cell = geometry.cell_dims[3] - (geometry.walls[3] ? 1 : 0);
+  unsigned int left_cell = right_cell - 1;
+
+  for (auto i = species_p.begin(); i != species_p.end(); i++)
+    if (dynamic_cast<BeamP *>(*i) == NULL)
+      (**i).load_plasma(left_cell, right_cell);
+}
+
+void Domain::drop_window_tail()
+{
+  //! remove particles, which are left behind trailing edge of window
+  double edge = geometry.cell_dims[1] * geometry.cell_size[1];
+  if (geometry.walls[1])
+    edge += geometry.cell_size[1] / 2.;
+
+  for (auto i = species_p.begin(); i != species_p.end(); i++)
+  {
+    (**i).particles.erase(
+      std::remove_if(
+        (**i).particles.begin(), (**i).particles.end(),
+        [edge] (Particle * & o)
+        {
+          if (P_POS_Z((*o)) >= edge)
+            return false;
+
+          delete o;
+          return true;
+        }),
+      (**i).particles.end());
+
+    (**i).invalidate_diagnostics();
+  }
 }
-#endif // ENABLE_COULOMB_COLLISIONS
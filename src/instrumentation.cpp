@@ -0,0 +1,261 @@
+/*
+ * This file is part of the PiCoPiC distribution (https://github.com/cosmonaut-ok/PiCoPiC).
+ * Copyright (c) 2020 Alexander Vynnyk.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "instrumentation.hpp"
+
+#ifdef ENABLE_INSTRUMENTATION
+
+#include <fstream>
+
+#include "msg.hpp"
+
+using namespace std;
+
+namespace instrumentation
+{
+  static const char *phase_names[PHASES_AMOUNT] =
+  {
+    "inject_beam",
+    "solve_e",
+    "overlay_e",
+    "solve_h",
+    "overlay_h",
+    "push",
+    "collide",
+    "move",
+    "reflect",
+    "runaway_collector",
+    "solve_current",
+    "overlay_current",
+    "resample",
+    "out_controller"
+  };
+
+  static const char *counter_names[COUNTERS_AMOUNT] =
+  {
+    "particles_pushed",
+    "particles_migrated",
+    "bytes_written",
+    "mpi_bytes"
+  };
+
+  //! records of single thread. Slot ``0'' is for whole SMB,
+  //! slot ``domain + 1'' is for domain
+  struct thread_records
+  {
+    vector<double> time; // [slot][phase]
+    vector<unsigned long> calls; // [slot][phase]
+    vector<unsigned long> counters; // [slot][counter]
+  };
+
+  static vector<thread_records> records;
+  static unsigned int slots_amount = 0;
+  static string file_name;
+  static string file_format;
+  static int rank = 0;
+  static bool header_written = false;
+
+  static inline int thread_number()
+  {
+#ifdef _OPENMP
+    return omp_get_thread_num();
+#else
+    return 0;
+#endif // _OPENMP
+  }
+
+  void init(unsigned int domains_amount, string path, string format, int world_rank)
+  {
+#ifdef _OPENMP
+    int threads_amount = omp_get_max_threads();
+#else
+    int threads_amount = 1;
+#endif // _OPENMP
+
+    slots_amount = domains_amount + 1;
+    file_format = format;
+    rank = world_rank;
+    header_written = false;
+
+    file_name = path;
+#ifdef ENABLE_MPI
+    file_name += "." + to_string(world_rank);
+#endif // ENABLE_MPI
+
+    records.clear();
+    records.resize(threads_amount);
+
+    // allocate records by it's own thread (first touch)
+#pragma omp parallel num_threads(threads_amount)
+    {
+      thread_records &r = records[thread_number()];
+
+      r.time.assign(slots_amount * PHASES_AMOUNT, 0);
+      r.calls.assign(slots_amount * PHASES_AMOUNT, 0);
+      r.counters.assign(slots_amount * COUNTERS_AMOUNT, 0);
+    }
+
+    // truncate file from previous runs
+    ofstream f (file_name, ios::trunc);
+    if (!f.is_open())
+      LOG_S(FATAL) << "Can not open instrumentation file ``" << file_name << "''";
+
+    LOG_S(INFO) << "Instrumentation is enabled. Writing to ``" << file_name << "''";
+  }
+
+  //! records are not initialized (instrumentation is not used
+  //! in config, or benchmark mode), thread was not seen by ``init''
+  //! or domain is out of slots. Such measurements are dropped
+  static inline bool is_dropped(int thread, int domain)
+  {
+    return (unsigned int)thread >= records.size()
+      || domain + 1 < 0
+      || (unsigned int)(domain + 1) >= slots_amount;
+  }
+
+  void add_time(phase p, int domain, double seconds)
+  {
+    int thread = thread_number();
+    if (is_dropped(thread, domain))
+      return;
+
+    thread_records &r = records[thread];
+    unsigned int idx = (domain + 1) * PHASES_AMOUNT + p;
+
+    r.time[idx] += seconds;
+    ++r.calls[idx];
+  }
+
+  void count(counter c, int domain, unsigned long value)
+  {
+    int thread = thread_number();
+    if (is_dropped(thread, domain))
+      return;
+
+    records[thread].counters[(domain + 1) * COUNTERS_AMOUNT + c] += value;
+  }
+
+#ifdef ENABLE_MPI
+  void count_mpi(int domain, MPI_Datatype dtype, int amount)
+  {
+    int size;
+    MPI_Type_size(dtype, &size);
+    count(MPI_BYTES, domain, (unsigned long)size * amount);
+  }
+#endif // ENABLE_MPI
+
+  static void dump_json(ofstream &f, int step)
+  {
+    bool first = true;
+
+    f << "{\"step\": " << step
+      << ", \"rank\": " << rank
+      << ", \"threads\": " << records.size()
+      << ", \"phases\": [";
+
+    for (unsigned int t = 0; t < records.size(); ++t)
+      for (unsigned int s = 0; s < slots_amount; ++s)
+        for (unsigned int p = 0; p < PHASES_AMOUNT; ++p)
+        {
+          unsigned int idx = s * PHASES_AMOUNT + p;
+          if (records[t].calls[idx] == 0)
+            continue;
+
+          f << (first ? "" : ", ")
+            << "{\"thread\": " << t
+            << ", \"domain\": " << (int)s - 1
+            << ", \"phase\": \"" << phase_names[p] << "\""
+            << ", \"calls\": " << records[t].calls[idx]
+            << ", \"time\": " << records[t].time[idx] << "}";
+          first = false;
+        }
+
+    f << "], \"counters\": [";
+    first = true;
+
+    for (unsigned int t = 0; t < records.size(); ++t)
+      for (unsigned int s = 0; s < slots_amount; ++s)
+        for (unsigned int c = 0; c < COUNTERS_AMOUNT; ++c)
+        {
+          unsigned int idx = s * COUNTERS_AMOUNT + c;
+          if (records[t].counters[idx] == 0)
+            continue;
+
+          f << (first ? "" : ", ")
+            << "{\"thread\": " << t
+            << ", \"domain\": " << (int)s - 1
+            << ", \"counter\": \"" << counter_names[c] << "\""
+            << ", \"value\": " << records[t].counters[idx] << "}";
+          first = false;
+        }
+
+    f << "]}" << endl;
+  }
+
+  static void dump_csv(ofstream &f, int step)
+  {
+    if (!header_written)
+    {
+      f << "step,rank,thread,domain,kind,name,calls,value" << endl;
+      header_written = true;
+    }
+
+    for (unsigned int t = 0; t < records.size(); ++t)
+      for (unsigned int s = 0; s < slots_amount; ++s)
+      {
+        for (unsigned int p = 0; p < PHASES_AMOUNT; ++p)
+        {
+          unsigned int idx = s * PHASES_AMOUNT + p;
+          if (records[t].calls[idx] > 0)
+            f << step << "," << rank << "," << t << "," << (int)s - 1
+              << ",phase," << phase_names[p] << ","
+              << records[t].calls[idx] << "," << records[t].time[idx] << endl;
+        }
+
+        for (unsigned int c = 0; c < COUNTERS_AMOUNT; ++c)
+        {
+          unsigned int idx = s * COUNTERS_AMOUNT + c;
+          if (records[t].counters[idx] > 0)
+            f << step << "," << rank << "," << t << "," << (int)s - 1
+              << ",counter," << counter_names[c] << ",0,"
+              << records[t].counters[idx] << endl;
+        }
+      }
+  }
+
+  void dump(int step)
+  {
+    if (records.empty())
+      return;
+
+    ofstream f (file_name, ios::app);
+    if (!f.is_open())
+    {
+      LOG_S(ERROR) << "Can not open instrumentation file ``" << file_name << "''";
+      return;
+    }
+
+    f.precision(9);
+
+    if (file_format.compare("csv") == 0)
+      dump_csv(f, step);
+    else
+      dump_json(f, step);
+  }
+}
+
+#endif // ENABLE_INSTRUMENTATION
@@ -54,6 +54,24 @@ namespace math::random
     return normal_distribution(gen);
   }
 
+  void seed(unsigned int value)
+  {
+    gen.seed(value);
+  }
+
+  string get_state()
+  {
+    stringstream state;
+    state << gen;
+    return state.str();
+  }
+
+  void set_state(string state)
+  {
+    stringstream s_state (state);
+    s_state >> gen;
+  }
+
   // random_reverse from PDP2: pseudorandom number generator
   // could be useful for debug to get the same values in same
   // cases
@@ -23,11 +23,6 @@ MaxwellSolverYee::MaxwellSolverYee(Geometry *_geometry, TimeSim *_time,
                                    vector<SpecieP *> _species_p, Current *_current)
   : MaxwellSolver(_geometry, _time, _species_p, _current)
 {
-  // set field_h_at_et to zero-state
-  field_h_at_et = Grid3D<double> (geometry->cell_amount[0], geometry->cell_amount[1], 2);
-  field_h_at_et = 0.;
-  field_h_at_et.overlay_set(0.);
-
   // emulate dielectric walls
   if (geometry->walls[0]) // r=0
     r_begin = 1;
@@ -108,12 +103,52 @@ void MaxwellSolverYee::set_pml()
                           + lenght_sigma_right, 2));
 }
 
+void MaxwellSolverYee::half_step_field_h(int i, int k_begin, int k_end)
+//! advance magnetic field in cells [k_begin, k_end) of row i
+//! by half of time step
+{
+  Grid<double> &e_r = field_e[0];
+  Grid<double> &e_phi = field_e[1];
+  Grid<double> &e_z = field_e[2];
+
+  Grid<double> &h_r = field_h[0];
+  Grid<double> &h_phi = field_h[1];
+  Grid<double> &h_z = field_h[2];
+
+  double dr = geometry->cell_size[0];
+  double dz = geometry->cell_size[1];
+
+  // constants of the row, to avoid divisions in the loop
+  double koef_dr = time->step / (2. * dr * MAGN_CONST);
+  double koef_dz = time->step / (2. * dz * MAGN_CONST);
+  double koef_r = time->step
+    / (4. * dr * (i + 0.5 + geometry->cell_dims[0]) * MAGN_CONST);
+
+  for (int k = k_begin; k < k_end; k++)
+  {
+    h_r.inc(i, k, koef_dz * (e_phi(i, k+1) - e_phi(i, k)));
+
+    h_phi.inc(i, k, koef_dr * (e_z(i+1, k) - e_z(i, k))
+              - koef_dz * (e_r(i, k+1) - e_r(i, k)));
+
+    h_z.dec(i, k, koef_r * (e_phi(i+1, k) + e_phi(i, k))
+            + koef_dr * (e_phi(i+1, k) - e_phi(i, k)));
+  }
+}
+
 void MaxwellSolverYee::calc_field_h()
 {
+  //! magnetic field is stored synchronized in time with electric
+  //! one, so it is advanced by half of time step after electric
+  //! field, and by another half before it. Both of half steps of
+  //! inner cells are done by calc_field_e, so only the outer
+  //! frame of cells, which uses electric field of neighbour
+  //! domains, or is used by them, is advanced here
   field_h.overlay_set(0);
-  field_h_at_et.overlay_set(0);
 
-  double dr = geometry->cell_size[0];
+  int r_size = geometry->cell_amount[0];
+  int z_size = geometry->cell_amount[1];
+
   double dz = geometry->cell_size[1];
 
   // H_r on outer wall (r=r)
@@ -125,53 +160,34 @@ void MaxwellSolverYee::calc_field_h()
       double alpha_t = time->step
         * (field_e(1, i, k + 1) - field_e(1, i, k)) / (dz * MAGN_CONST);
 
-      field_h[0].set(i, k, field_h_at_et(0, i, k) + alpha_t / 2);
-      field_h_at_et[0].inc(i, k, alpha_t);
+      field_h[0].inc(i, k, alpha_t);
     }
 
   // regular case
-  for (int i = 0; i < geometry->cell_amount[0]; i++)
-    for (int k = 0; k < geometry->cell_amount[1]; k++)
+  for (int i = 0; i < r_size; i++)
+    if (i == 0 || i == r_size - 1)
+      half_step_field_h(i, 0, z_size);
+    else
     {
-      double alpha_t_r = time->step
-        * (field_e(1, i, k + 1) - field_e(1, i, k)) / (dz * MAGN_CONST);
-
-      field_h[0].set(i, k, field_h_at_et(0, i, k) + alpha_t_r / 2);
-      field_h_at_et[0].inc(i, k, alpha_t_r);
-
-      double alpha_t_phi = time->step
-        * ((field_e(2, i+1, k) - field_e(2, i, k)) / dr
-           - (field_e(0, i, k+1) - field_e(0, i, k)) / dz)
-        / MAGN_CONST;
-
-      field_h[1].set(i, k, field_h_at_et(1, i, k) + alpha_t_phi / 2);
-      field_h_at_et[1].inc(i, k, alpha_t_phi);
-
-      double alpha_t_z = time->step
-        * (
-          (field_e(1, i+1, k) + field_e(1, i, k)) / (2. * dr * (i + 0.5 + geometry->cell_dims[0]))
-          + (field_e(1, i+1, k) - field_e(1, i, k)) / dr)
-        / MAGN_CONST;
-
-      field_h[2].set(i, k, field_h_at_et(2, i, k) - alpha_t_z / 2);
-      field_h_at_et[2].dec(i, k, alpha_t_z);
+      half_step_field_h(i, 0, 1);
+      if (z_size > 1)
+        half_step_field_h(i, z_size - 1, z_size);
     }
 }
 
-void MaxwellSolverYee::calc_field_e()
+void MaxwellSolverYee::calc_field_e_row(unsigned int i, unsigned int k_begin, unsigned int k_end)
+//! electric field in cells [k_begin, k_end) of row i
 {
-  field_e.overlay_set(0);
-
   Grid3D<double> curr = current->current;
 
   double dr = geometry->cell_size[0];
   double dz = geometry->cell_size[1];
 
   // E at the center axis (r=0) case
-  if (geometry->walls[0]) // calculate only at the center axis (r=0)
-    for (unsigned int k = z_begin; k < z_end; ++k)
+  if (i == 0 && geometry->walls[0])
+  {
+    for (unsigned int k = max(k_begin, z_begin); k < min(k_end, z_end); ++k)
     {
-      int i = 0;
       double epsilonx2 = 2 * epsilon(i, k);
 
 #ifdef ENABLE_PML
@@ -185,78 +201,144 @@ void MaxwellSolverYee::calc_field_e()
 
       field_e[0].m_a(i, k, koef_e);
       field_e[0].dec(i, k, (curr(0, i, k)
-                            + (field_h_at_et(1, i, k)
-                               - field_h_at_et(1, i, k-1)) / dz) * koef_h);
+                            + (field_h(1, i, k)
+                               - field_h(1, i, k-1)) / dz) * koef_h);
 
       field_e[2].m_a(i, k, koef_e);
       field_e[2].dec(i, k, (curr(2, i, k)
-                            - field_h_at_et(1, i, k) * 4. / dr) * koef_h);
+                            - field_h(1, i, k) * 4. / dr) * koef_h);
     }
 
+    return;
+  }
+
+  if (i < r_begin || i >= r_end)
+    return;
+
   // E_z at the left wall (z=0) case
-  if (geometry->walls[1]) // calculate only at the left wall (z=0)
-    for (unsigned int i = r_begin; i < r_end; ++i)
-    {
-      int k = 0;
-      double epsilonx2 = 2 * epsilon(i, k);
+  if (k_begin == 0 && geometry->walls[1]) // calculate only at the left wall (z=0)
+  {
+    int k = 0;
+    double epsilonx2 = 2 * epsilon(i, k);
 
 #ifdef ENABLE_PML
-      double sigma_t = sigma(i, k) * time->step;
+    double sigma_t = sigma(i, k) * time->step;
 #else
-      double sigma_t = 0;
+    double sigma_t = 0;
 #endif // ENABLE_PML
 
-      double koef_e = (epsilonx2 - sigma_t) / (epsilonx2 + sigma_t);
-      double koef_h =  2 * time->step / (epsilonx2 + sigma_t);
+    double koef_e = (epsilonx2 - sigma_t) / (epsilonx2 + sigma_t);
+    double koef_h =  2 * time->step / (epsilonx2 + sigma_t);
 
-      field_e[2].m_a(i, k, koef_e);
-      field_e[2].dec(i, k, (curr(2, i, k)
-                            - (field_h_at_et(1, i, k) - field_h_at_et(1, i - 1, k)) / dr
-                            - (field_h_at_et(1, i, k) + field_h_at_et(1, i-1, k))
-                            / (2. * dr * (i + geometry->cell_dims[0])))
-                     * koef_h);
-    }
+    field_e[2].m_a(i, k, koef_e);
+    field_e[2].dec(i, k, (curr(2, i, k)
+                          - (field_h(1, i, k) - field_h(1, i - 1, k)) / dr
+                          - (field_h(1, i, k) + field_h(1, i-1, k))
+                          / (2. * dr * (i + geometry->cell_dims[0])))
+                   * koef_h);
+  }
 
-// regular case
-  for (unsigned int i = r_begin; i < r_end; i++)
-    for (unsigned int k = z_begin; k < z_end; k++)
-    {
-      double epsilonx2 = 2 * epsilon(i, k);
+  // regular case
+  Grid<double> &e_r = field_e[0];
+  Grid<double> &e_phi = field_e[1];
+  Grid<double> &e_z = field_e[2];
+
+  Grid<double> &h_r = field_h[0];
+  Grid<double> &h_phi = field_h[1];
+  Grid<double> &h_z = field_h[2];
+
+  Grid<double> &j_r = current->current[0];
+  Grid<double> &j_phi = current->current[1];
+  Grid<double> &j_z = current->current[2];
+
+  // constants of the row, to avoid divisions in the loop
+  double one_over_dr = 1. / dr;
+  double one_over_dz = 1. / dz;
+  double one_over_2r = 1. / (2. * dr * (i + geometry->cell_dims[0]));
+
+  for (unsigned int k = max(k_begin, z_begin); k < min(k_end, z_end); k++)
+  {
+    double epsilonx2 = 2 * epsilon(i, k);
 
 #ifdef ENABLE_PML
-      double sigma_t = sigma(i, k) * time->step;
+    double sigma_t = sigma(i, k) * time->step;
 #else
-      double sigma_t = 0;
+    double sigma_t = 0;
 #endif // ENABLE_PML
 
-      double koef_e = (epsilonx2 - sigma_t) / (epsilonx2 + sigma_t);
-      double koef_h = 2 * time->step / (epsilonx2 + sigma_t);
+    double one_over_denom = 1. / (epsilonx2 + sigma_t);
+    double koef_e = (epsilonx2 - sigma_t) * one_over_denom;
+    double koef_h = 2 * time->step * one_over_denom;
 
-      field_e[0].m_a(i, k, koef_e);
-      field_e[0].dec(i, k, (curr(0, i, k)
-                            + (field_h_at_et(1, i, k)
-                               - field_h_at_et(1, i, k-1)) / dz) * koef_h);
+    e_r(i, k) = e_r(i, k) * koef_e
+      - (j_r(i, k) + (h_phi(i, k) - h_phi(i, k-1)) * one_over_dz) * koef_h;
 
-      field_e[1].m_a(i, k, koef_e);
-      field_e[1].dec(i, k, (curr(1, i, k)
-                            - (field_h_at_et(0, i, k) - field_h_at_et(0, i, k - 1))
-                            / dz + (field_h_at_et(2, i, k)
-                                    - field_h_at_et(2, i - 1, k)) / dr) * koef_h);
+    e_phi(i, k) = e_phi(i, k) * koef_e
+      - (j_phi(i, k) - (h_r(i, k) - h_r(i, k-1)) * one_over_dz
+         + (h_z(i, k) - h_z(i-1, k)) * one_over_dr) * koef_h;
 
-      field_e[2].m_a(i, k, koef_e);
-      field_e[2].dec(i, k, (curr(2, i, k)
-                            - (field_h_at_et(1, i, k) - field_h_at_et(1, i - 1, k)) / dr
-                            - (field_h_at_et(1, i, k)
-                               + field_h_at_et(1, i-1, k))
-                            / (2. * dr * (i + geometry->cell_dims[0]))) * koef_h);
-
-      if ( isnan(field_e[0](i,k)) || isnan(field_e[1](i,k)) || isnan(field_e[2](i,k)) )
-        LOG_S(FATAL) << "fld " << i << " " << k << " "
-                     << field_e[0](i,k) << " " << field_e[1](i,k) << " " << field_e[2](i,k);
-    }
+    e_z(i, k) = e_z(i, k) * koef_e
+      - (j_z(i, k) - (h_phi(i, k) - h_phi(i-1, k)) * one_over_dr
+         - (h_phi(i, k) + h_phi(i-1, k)) * one_over_2r) * koef_h;
+
+    if ( isnan(e_r(i, k)) || isnan(e_phi(i, k)) || isnan(e_z(i, k)) )
+      LOG_S(FATAL) << "fld " << i << " " << k << " "
+                   << e_r(i, k) << " " << e_phi(i, k) << " " << e_z(i, k);
+  }
+}
+
+void MaxwellSolverYee::calc_field_e()
+{
+  //! magnetic field is advanced by half of time step, electric
+  //! field by full time step and magnetic field by next half of
+  //! time step in single wavefront sweep over rows, so every row
+  //! is loaded to cache once per step:
+  //! - row i of H uses only rows i and i+1 of E, which are not
+  //!   updated yet
+  //! - row i of E uses rows i and i-1 of H, which are already
+  //!   advanced by the first half step
+  //! - row i-1 of H uses rows i-1 and i of E, which are already
+  //!   updated, so it is advanced by the next half step
+  //! Electric field in the first row and column depends on magnetic
+  //! field of neighbour domains, so it is calculated by
+  //! calc_field_e_edge after magnetic field overlay. Magnetic field
+  //! in the outer frame of cells is not advanced by the next half
+  //! step here, because it is used by neighbour domains or uses
+  //! electric field of them (see calc_field_h)
+  //!
+  //! TODO: fields are blocked over half-steps of single time step
+  //! only. Blocking of several time steps for domains without
+  //! particles (vacuum and PML) needs halo, exchanged every
+  //! ``k'' steps with ``k'' cells depth, but overlays of domains
+  //! are summed on every half-step and have 2 cells depth now
+  field_h.overlay_set(0);
+
+  int r_size = geometry->cell_amount[0];
+  int z_size = geometry->cell_amount[1];
+
+  for (int i = 0; i < r_size; i++)
+  {
+    half_step_field_h(i, 0, z_size);
+
+    if (i > 0)
+      calc_field_e_row(i, 1, z_size);
+
+    if (i > 1)
+      half_step_field_h(i - 1, 1, z_size - 1);
+  }
+}
+
+void MaxwellSolverYee::calc_field_e_edge()
+{
+  calc_field_e_row(0, 0, geometry->cell_amount[1]);
+
+  for (int i = 1; i < geometry->cell_amount[0]; i++)
+    calc_field_e_row(i, 0, 1);
+
+  field_e.overlay_set(0);
 }
 
-vector3d<double> MaxwellSolverYee::get_field_h(double radius, double longitude)
+vector3d<double> MaxwellSolverYee::get_field_h(Grid3D<double> &field, double radius, double longitude)
 //! function for magnetic field weighting
 {
   vector3d<double> cmp;
@@ -293,16 +375,16 @@ vector3d<double> MaxwellSolverYee::get_field_h(double radius, double longitude)
   r2 = (i_r + 1) * dr;
 
   //weighting Hz[i][k]//
-  cmp[2] += field_h(2, i_r_shift, k_z_shift) * CYL_RNG_VOL(dz1, r1, r2) / vol_1;
+  cmp[2] += field(2, i_r_shift, k_z_shift) * CYL_RNG_VOL(dz1, r1, r2) / vol_1;
 
   //weighting Hz[i+1][k]//
-  cmp[2] += field_h(2, i_r_shift + 1, k_z_shift) * CYL_RNG_VOL(dz1, r2, r3) / vol_2;
+  cmp[2] += field(2, i_r_shift + 1, k_z_shift) * CYL_RNG_VOL(dz1, r2, r3) / vol_2;
 
   //weighting Hz[i][k+1]//
-  cmp[2] += field_h(2, i_r_shift, k_z_shift + 1) * CYL_RNG_VOL(dz2, r1, r2) / vol_1;
+  cmp[2] += field(2, i_r_shift, k_z_shift + 1) * CYL_RNG_VOL(dz2, r1, r2) / vol_1;
 
   //weighting Hz[i+1][k+1]//
-  cmp[2] += field_h(2, i_r_shift + 1, k_z_shift + 1) * CYL_RNG_VOL(dz2, r2, r3) / vol_2;
+  cmp[2] += field(2, i_r_shift + 1, k_z_shift + 1) * CYL_RNG_VOL(dz2, r2, r3) / vol_2;
 
   //// weighting of Hr
   // finding number of cell. example dz=0.5, longitude = 0.7, z_k =0;!!
@@ -323,16 +405,16 @@ vector3d<double> MaxwellSolverYee::get_field_h(double radius, double longitude)
   dz2 = longitude - (k_z + 0.5) * dz;
 
   //weighting Hr[i][k]//
-  cmp[0] += field_h(0, i_r_shift, k_z_shift) * CYL_RNG_VOL(dz1, r1, r2) / vol_1;
+  cmp[0] += field(0, i_r_shift, k_z_shift) * CYL_RNG_VOL(dz1, r1, r2) / vol_1;
 
   //weighting Hr[i+1][k]//
-  cmp[0] += field_h(0, i_r_shift + 1, k_z_shift) * CYL_RNG_VOL(dz1, r2, r3) / vol_2;
+  cmp[0] += field(0, i_r_shift + 1, k_z_shift) * CYL_RNG_VOL(dz1, r2, r3) / vol_2;
 
   //weighting Hr[i][k+1]//
-  cmp[0] += field_h(0, i_r_shift, k_z_shift + 1) * CYL_RNG_VOL(dz2, r1, r2) / vol_1;
+  cmp[0] += field(0, i_r_shift, k_z_shift + 1) * CYL_RNG_VOL(dz2, r1, r2) / vol_1;
 
   //weighting Hr[i+1][k+1]//
-  cmp[0] += field_h(0, i_r_shift + 1, k_z_shift + 1) * CYL_RNG_VOL(dz2, r2, r3) / vol_2;
+  cmp[0] += field(0, i_r_shift + 1, k_z_shift + 1) * CYL_RNG_VOL(dz2, r2, r3) / vol_2;
 
   //// weighting of H_fi
   // finding number of cell. example dz=0.5, longitude = 0.7, z_k =0;
@@ -352,21 +434,21 @@ vector3d<double> MaxwellSolverYee::get_field_h(double radius, double longitude)
   dz2 = longitude - (k_z+0.5) * dz;
 
   //weighting Hphi[i][k]//
-  cmp[1] += field_h(1, i_r_shift, k_z_shift) * CYL_RNG_VOL(dz1, r1, r2) / vol_1;
+  cmp[1] += field(1, i_r_shift, k_z_shift) * CYL_RNG_VOL(dz1, r1, r2) / vol_1;
 
   //weighting Hphi[i+1][k]//
-  cmp[1] += field_h(1, i_r_shift + 1, k_z_shift) * CYL_RNG_VOL(dz1, r2, r3) / vol_2;
+  cmp[1] += field(1, i_r_shift + 1, k_z_shift) * CYL_RNG_VOL(dz1, r2, r3) / vol_2;
 
   //weighting Hphi[i][k+1]//
-  cmp[1] += field_h(1, i_r_shift, k_z_shift + 1) * CYL_RNG_VOL(dz2, r1, r2) / vol_1;
+  cmp[1] += field(1, i_r_shift, k_z_shift + 1) * CYL_RNG_VOL(dz2, r1, r2) / vol_1;
 
   //weighting Hphi[i+1][k+1]//
-  cmp[1] += field_h(1, i_r_shift + 1, k_z_shift + 1) * CYL_RNG_VOL(dz2, r2, r3) / vol_2;
+  cmp[1] += field(1, i_r_shift + 1, k_z_shift + 1) * CYL_RNG_VOL(dz2, r2, r3) / vol_2;
 
   return cmp;
 }
 
-vector3d<double> MaxwellSolverYee::get_field_e(double radius, double longitude)
+vector3d<double> MaxwellSolverYee::get_field_e(Grid3D<double> &field, double radius, double longitude)
 //! function for electric field weighting
 {
   vector3d<double> cmp;
@@ -403,16 +485,16 @@ vector3d<double> MaxwellSolverYee::get_field_e(double radius, double longitude)
   dz2 = longitude - k_z * dz;
   r2 = (i_r + 1) * dr;
   //weighting Er[i][k]//
-  cmp[0] += field_e(0, i_r_shift, k_z_shift) * CYL_RNG_VOL(dz1, r1, r2) / vol_1;
+  cmp[0] += field(0, i_r_shift, k_z_shift) * CYL_RNG_VOL(dz1, r1, r2) / vol_1;
 
   //weighting Er[i+1][k]//
-  cmp[0] += field_e(0, i_r_shift + 1, k_z_shift) * CYL_RNG_VOL(dz1, r2, r3) / vol_2;
+  cmp[0] += field(0, i_r_shift + 1, k_z_shift) * CYL_RNG_VOL(dz1, r2, r3) / vol_2;
 
   //weighting Er[i][k+1]//
-  cmp[0] += field_e(0, i_r_shift, k_z_shift + 1) * CYL_RNG_VOL(dz2, r1, r2) / vol_1;
+  cmp[0] += field(0, i_r_shift, k_z_shift + 1) * CYL_RNG_VOL(dz2, r1, r2) / vol_1;
 
   //weighting Er[i+1][k+1]//
-  cmp[0] += field_e(0, i_r_shift + 1, k_z_shift + 1) * CYL_RNG_VOL(dz2, r2, r3) / vol_2;
+  cmp[0] += field(0, i_r_shift + 1, k_z_shift + 1) * CYL_RNG_VOL(dz2, r2, r3) / vol_2;
 
   // weighting of E_z
   // finding number of cell. example dz=0.5, longitude = 0.7, z_k =0;!!
@@ -429,16 +511,16 @@ vector3d<double> MaxwellSolverYee::get_field_e(double radius, double longitude)
   dz2 = longitude - (k_z + 0.5) * dz;
 
   // weighting Ez[i][k]
-  cmp[2] += field_e(2, i_r_shift, k_z_shift) * CYL_RNG_VOL(dz1, r1, r2) / vol_1;
+  cmp[2] += field(2, i_r_shift, k_z_shift) * CYL_RNG_VOL(dz1, r1, r2) / vol_1;
 
   // weighting Ez[i+1][k]
-  cmp[2] += field_e(2, i_r_shift+1, k_z_shift) * CYL_RNG_VOL(dz1, r2, r3) / vol_2;
+  cmp[2] += field(2, i_r_shift+1, k_z_shift) * CYL_RNG_VOL(dz1, r2, r3) / vol_2;
 
   // weighting Ez[i][k+1]
-  cmp[2] += field_e(2, i_r_shift, k_z_shift+1) * CYL_RNG_VOL(dz2, r1, r2) / vol_1;
+  cmp[2] += field(2, i_r_shift, k_z_shift+1) * CYL_RNG_VOL(dz2, r1, r2) / vol_1;
 
   // weighting Ez[i+1][k+1]
-  cmp[2] += field_e(2, i_r_shift+1, k_z_shift+1) * CYL_RNG_VOL(dz2, r2, r3) / vol_2;
+  cmp[2] += field(2, i_r_shift+1, k_z_shift+1) * CYL_RNG_VOL(dz2, r2, r3) / vol_2;
 
   // weighting of E_fi
   // finding number of cell. example dz=0.5, longitude = 0.7, z_k =1;
@@ -459,16 +541,16 @@ vector3d<double> MaxwellSolverYee::get_field_e(double radius, double longitude)
   dz2 = longitude - k_z * dz;
 
   // weighting Efi[i][k]
-  cmp[1] += field_e(1, i_r_shift, k_z_shift) * CYL_RNG_VOL(dz1, r1, r2) / vol_1;
+  cmp[1] += field(1, i_r_shift, k_z_shift) * CYL_RNG_VOL(dz1, r1, r2) / vol_1;
 
   // weighting Efi[i+1][k]
-  cmp[1] += field_e(1, i_r_shift+1, k_z_shift) * CYL_RNG_VOL(dz1, r2, r3) / vol_2;
+  cmp[1] += field(1, i_r_shift+1, k_z_shift) * CYL_RNG_VOL(dz1, r2, r3) / vol_2;
 
   // weighting Efi[i][k+1]
-  cmp[1] += field_e(1, i_r_shift, k_z_shift+1) * CYL_RNG_VOL(dz2, r1, r2) / vol_1;
+  cmp[1] += field(1, i_r_shift, k_z_shift+1) * CYL_RNG_VOL(dz2, r1, r2) / vol_1;
 
   // weighting Efi[i+1][k+1]
-  cmp[2] += field_e(1, i_r_shift+1, k_z_shift+1) * CYL_RNG_VOL(dz2, r2, r3) / vol_2;
+  cmp[2] += field(1, i_r_shift+1, k_z_shift+1) * CYL_RNG_VOL(dz2, r2, r3) / vol_2;
 
   return cmp;
 }
@@ -22,13 +22,15 @@ OutController::OutController ( HighFive::File* _file,
                                Geometry *_geometry, TimeSim *_time,
                                vector<probe> &_probes, SMB *_smb,
                                picojson::value _metadata,
-                               bool _print_progress_table )
+                               bool _print_progress_table,
+                               bool _restart )
   : geometry(_geometry), time(_time), smb(_smb)
 #else
 OutController::OutController ( Geometry *_geometry, TimeSim *_time,
                                vector<probe> &_probes, SMB *_smb,
                                picojson::value _metadata,
-                               bool _print_progress_table )
+                               bool _print_progress_table,
+                               bool _restart )
   : geometry(_geometry), time(_time), smb(_smb)
 #endif
 {
@@ -37,7 +39,9 @@ OutController::OutController ( Geometry *_geometry, TimeSim *_time,
   hdf5_file = _file;
   OutEngineHDF5 engine (hdf5_file, _probes[0].path, {0,0}, {0,0}, true, false);
 #endif // end of ENABLE_HDF5
-  engine.write_metadata( _metadata );
+  // metadata and datasets already exist in data file at restart
+  if (! _restart)
+    engine.write_metadata( _metadata );
 
   print_progress_table = _print_progress_table;
 
@@ -52,27 +56,13 @@ OutController::OutController ( Geometry *_geometry, TimeSim *_time,
     // initialize engine paths
 #ifdef ENABLE_HDF5
     hdf5_file = _file;
-    vector<size_t> hdf5_prb_size;
-
-    switch (prb->shape)
-    {
-    case 0:
-      hdf5_prb_size = {prb->dims[2] - prb->dims[0], prb->dims[3] - prb->dims[1]};
-      break;
-    case 1:
-      hdf5_prb_size = {geometry->cell_amount[0]};
-      break;
-    case 2:
-      hdf5_prb_size = {geometry->cell_amount[1]};
-      break;
-    case 3:
-      hdf5_prb_size = {1};
-    }
+    vector<size_t> hdf5_prb_size = dataset_size(*prb);
 
     OutEngineHDF5 engine (hdf5_file, prb->path, hdf5_prb_size, {0,0}, true, false);
 #endif // end of ENABLE_HDF5
 
-    engine.create_dataset();
+    if (! _restart)
+      engine.create_dataset();
 
     // push probes to domains
     for (unsigned int r = 0; r < geometry->domains_amount[0]; ++r)
@@ -144,6 +134,27 @@ OutController::OutController ( Geometry *_geometry, TimeSim *_time,
           if (prb->shape == 0 || prb->shape == 2 || prb->shape == 3)
             eff_engine_offset.push_back(eff_prb_size[1] + dmn->geometry.cell_dims[1] - prb->dims[1]);
 
+          // space-reduced probe is written by blocks of ``factor'' cells,
+          // so domains borders should not split the blocks
+          if (prb->factor > 1)
+            for (auto o = eff_engine_offset.begin(); o != eff_engine_offset.end(); ++o)
+            {
+              if ((*o) % prb->factor != 0)
+                LOG_S(FATAL) << "Probe ``" << prb->path << "'' space reduction factor "
+                             << prb->factor << " does not fit domains borders";
+              (*o) /= prb->factor;
+            }
+
+          // spectral probe writes vector of spectrum bins for dot
+          // and matrix [r][bins] for column
+          if (prb->time_reduce == 5)
+          {
+            if (prb->shape == 3)
+              eff_engine_offset = {0};
+            else
+              eff_engine_offset.push_back(0);
+          }
+
           Grid<double> *value;
 
           // map outWriter to the grid of values
@@ -154,11 +165,11 @@ OutController::OutController ( Geometry *_geometry, TimeSim *_time,
           else if (prb->component.compare("E/z") == 0)
             value = &(dmn->maxwell_solver->field_e[2]);
           else if (prb->component.compare("H/r") == 0)
-            value = &(dmn->maxwell_solver->field_h_at_et[0]);
+            value = &(dmn->maxwell_solver->field_h[0]);
           else if (prb->component.compare("H/phi") == 0)
-            value = &(dmn->maxwell_solver->field_h_at_et[1]);
+            value = &(dmn->maxwell_solver->field_h[1]);
           else if (prb->component.compare("H/z") == 0)
-            value = &(dmn->maxwell_solver->field_h_at_et[2]);
+            value = &(dmn->maxwell_solver->field_h[2]);
           else if (prb->component.compare("J/r") == 0)
             value = &(dmn->current->current[0]);
           else if (prb->component.compare("J/phi") == 0)
@@ -213,7 +224,10 @@ OutController::OutController ( Geometry *_geometry, TimeSim *_time,
           OutWriter writer (hdf5_file, prb->path, prb->shape,
                             eff_prb_size, eff_engine_offset,
                             prb->schedule, true, (unsigned short)0,
-                            time, value);
+                            time, value,
+                            prb->time_reduce, prb->sample,
+                            prb->space_reduce, prb->factor,
+                            prb->window);
           writer.hdf5_file = hdf5_file;
 
           dmn->out_writers.push_back(writer);
@@ -222,8 +236,59 @@ OutController::OutController ( Geometry *_geometry, TimeSim *_time,
   }
 }
 
+vector<size_t> OutController::dataset_size(probe &_probe)
+{
+  vector<size_t> size;
+
+  switch (_probe.shape)
+  {
+  case 0:
+    size = {_probe.dims[2] - _probe.dims[0], _probe.dims[3] - _probe.dims[1]};
+    break;
+  case 1:
+    size = {geometry->cell_amount[0]};
+    break;
+  case 2:
+    size = {geometry->cell_amount[1]};
+    break;
+  case 3:
+    size = {1};
+  }
+
+  // space-reduced probe has ``factor'' times less cells by every axis
+  for (auto i = size.begin(); i != size.end(); ++i)
+    (*i) = ((*i) + _probe.factor - 1) / _probe.factor;
+
+  // spectral probe writes spectrum of ``window'' samples per point
+  if (_probe.time_reduce == 5)
+  {
+    size_t bins = _probe.window / 2 + 1;
+    if (_probe.shape == 3)
+      size = {bins};
+    else
+      size.push_back(bins);
+  }
+
+  return size;
+}
+
+SpecieP* OutController::find_specie(Domain *_domain, string _name)
+{
+  for (auto ps = _domain->species_p.begin(); ps != _domain->species_p.end(); ++ps)
+    if (_name.compare((**ps).name) == 0)
+      return *ps;
+
+  return NULL;
+}
+
 void OutController::init_datasets()
 {
+  // list of (specie, component) pairs, required to be
+  // calculated and overlayed at current time step.
+  // Every pair is calculated and overlayed only once per step,
+  // even if it is used by several probes
+  vector< pair<string, string> > diagnostics;
+
   // create empty
   for (auto prb = probes.begin(); prb != probes.end(); ++prb)
   {
@@ -231,22 +296,7 @@ void OutController::init_datasets()
     vector<size_t> offset = {0, 0};
 
 #ifdef ENABLE_HDF5
-    vector<size_t> hdf5_prb_size;
-
-    switch (prb->shape)
-    {
-    case 0:
-      hdf5_prb_size = {prb->dims[2] - prb->dims[0], prb->dims[3] - prb->dims[1]};
-      break;
-    case 1:
-      hdf5_prb_size = {geometry->cell_amount[0]};
-      break;
-    case 2:
-      hdf5_prb_size = {geometry->cell_amount[1]};
-      break;
-    case 3:
-      hdf5_prb_size = {1};
-    }
+    vector<size_t> hdf5_prb_size = dataset_size(*prb);
 
     OutEngineHDF5 engine (hdf5_file, prb->path, hdf5_prb_size, offset, true, false);
 #endif // end of ENABLE_HDF5
@@ -254,6 +304,20 @@ void OutController::init_datasets()
     int current_time_step = ceil(time->current / time->step);
     int is_run = current_time_step % prb->schedule;
 
+    // time-reduced probes accumulate values between dumps
+    bool is_sample = prb->time_reduce != 0 && current_time_step % prb->sample == 0;
+
+    if ((is_run == 0 || is_sample)
+        && (prb->component.compare("density") == 0
+            || prb->component.compare("temperature") == 0))
+    {
+      // register temperature and/or density to be calculated before dump
+      pair<string, string> diag (prb->specie, prb->component);
+
+      if (find(diagnostics.begin(), diagnostics.end(), diag) == diagnostics.end())
+        diagnostics.push_back(diag);
+    }
+
     if (is_run == 0)
     {
       //// print header every 30 values
@@ -287,109 +351,80 @@ void OutController::init_datasets()
 
       engine.extend_dataset(slices);
 
-      ////
-      //// calculate and overlay temperatures and densities before dump
-      ////
-      // calculate temperature and/or density before dump
-      for (unsigned int r = 0; r < geometry->domains_amount[0]; ++r)
-        for (unsigned int z = 0; z < geometry->domains_amount[1]; ++z)
-        {
-          Domain *sim_domain = smb->domains(r, z);
-          SpecieP *speciep;
-          bool specie_exists = false;
+      if (print_progress_table)
+        msg::print_values (prb->path, shape_name, prb->schedule, time);
+    }
+  }
 
-          for (auto ps = sim_domain->species_p.begin(); ps != sim_domain->species_p.end(); ++ps)
-            if (prb->specie.compare((**ps).name) == 0)
-            {
-              speciep = (*ps);
-              specie_exists = true;
-            }
+  if (diagnostics.empty())
+    return;
 
-          if (!specie_exists)
-            continue; // skip if there is no specie for probe
+  ////
+  //// calculate and overlay temperatures and densities before dump
+  ////
+  // calculate temperature and/or density before dump.
+  // Domains are independent here, so calculate them in parallel
+#pragma omp parallel for collapse(2)
+  for (unsigned int r = 0; r < geometry->domains_amount[0]; ++r)
+    for (unsigned int z = 0; z < geometry->domains_amount[1]; ++z)
+    {
+      Domain *sim_domain = smb->domains(r, z);
 
-          if (prb->component.compare("density") == 0)
-            speciep->calc_density();
-          else if (prb->component.compare("temperature") == 0)
-            speciep->calc_temperature();
-        }
+      for (auto d = diagnostics.begin(); d != diagnostics.end(); ++d)
+      {
+        SpecieP *speciep = find_specie(sim_domain, d->first);
 
-      // overlay domains before dump
-      for (unsigned int i=0; i < geometry->domains_amount[0]; i++)
-        for (unsigned int j = 0; j < geometry->domains_amount[1]; j++)
-        {
-          Domain *sim_domain = smb->domains(i, j);
-          SpecieP *speciep;
-          bool specie_exists = false;
+        if (speciep == NULL)
+          continue; // skip if there is no specie for probe
 
-          for (auto ps = sim_domain->species_p.begin(); ps != sim_domain->species_p.end(); ++ps)
-            if (prb->specie.compare((**ps).name) == 0)
-            {
-              speciep = (*ps);
-              specie_exists = true;
-            }
+        if (d->second.compare("density") == 0)
+          speciep->calc_density();
+        else if (d->second.compare("temperature") == 0)
+          speciep->calc_temperature();
+      }
+    }
 
-          if (!specie_exists)
-            continue; // skip if there is no specie for probe
+  // overlay domains before dump
+  for (auto d = diagnostics.begin(); d != diagnostics.end(); ++d)
+    for (unsigned int i=0; i < geometry->domains_amount[0]; i++)
+      for (unsigned int j = 0; j < geometry->domains_amount[1]; j++)
+      {
+        SpecieP *speciep = find_specie(smb->domains(i, j), d->first);
 
-          // update grid
-          if (i < geometry->domains_amount[0] - 1)
-          {
-            Domain *dst_domain = smb->domains(i+1, j);
-            SpecieP *speciep_dst;
-            bool specie_exists = false;
+        if (speciep == NULL)
+          continue; // skip if there is no specie for probe
 
-            for (auto ps = dst_domain->species_p.begin(); ps != dst_domain->species_p.end(); ++ps)
-              if (prb->specie.compare((**ps).name) == 0)
-              {
-                speciep_dst = (*ps);
-                specie_exists = true;
-              }
-            if (!specie_exists)
-              LOG_S(FATAL) << "There is no particles specie ``"
-                           << prb->specie
-                           << "'' in destination domain, while overlaying for probe dump. Exiting";
-
-            if (prb->component.compare("density") == 0)
-              speciep->density_map.overlay_x(speciep_dst->density_map);
-            else if (prb->component.compare("temperature") == 0)
-              speciep->temperature_map.overlay_x(speciep_dst->temperature_map);
-          }
+        // update grid
+        if (i < geometry->domains_amount[0] - 1)
+        {
+          SpecieP *speciep_dst = find_specie(smb->domains(i + 1, j), d->first);
 
-          if (j < geometry->domains_amount[1] - 1)
-          {
-            Domain *dst_domain = smb->domains(i, j + 1);
-            SpecieP *speciep_dst;
-            bool specie_exists = false;
+          if (speciep_dst == NULL)
+            LOG_S(FATAL) << "There is no particles specie ``"
+                         << d->first
+                         << "'' in destination domain, while overlaying for probe dump. Exiting";
 
-            for (auto ps = dst_domain->species_p.begin(); ps != dst_domain->species_p.end(); ++ps)
-              if (prb->specie.compare((**ps).name) == 0)
-              {
-                speciep_dst = (*ps);
-                specie_exists = true;
-              }
+          if (d->second.compare("density") == 0)
+            speciep->density_map.overlay_x(speciep_dst->density_map);
+          else if (d->second.compare("temperature") == 0)
+            speciep->temperature_map.overlay_x(speciep_dst->temperature_map);
+        }
 
-            if (!specie_exists)
-              LOG_S(FATAL) << "There is no particles specie ``"
-                           << prb->specie
-                           << "'' in destination domain, while overlaying for probe dump. Exiting";
-
-            if (prb->component.compare("density") == 0)
-              speciep->density_map.overlay_y(speciep_dst->density_map);
-            else if (prb->component.compare("temperature") == 0)
-              speciep->temperature_map.overlay_y(speciep_dst->temperature_map);
-          }
+        if (j < geometry->domains_amount[1] - 1)
+        {
+          SpecieP *speciep_dst = find_specie(smb->domains(i, j + 1), d->first);
 
-          // if (i < geometry_global->domains_amount[0] - 1 && j < geometry_global->domains_amount[1] - 1)
-          // {
-          //   Domain *dst_domain = smb->domains(i + 1, j + 1);
-          //   sim_domain->current->current.overlay_xy(dst_domain->current->current);
-          // }
+          if (speciep_dst == NULL)
+            LOG_S(FATAL) << "There is no particles specie ``"
+                         << d->first
+                         << "'' in destination domain, while overlaying for probe dump. Exiting";
+
+          if (d->second.compare("density") == 0)
+            speciep->density_map.overlay_y(speciep_dst->density_map);
+          else if (d->second.compare("temperature") == 0)
+            speciep->temperature_map.overlay_y(speciep_dst->temperature_map);
         }
-      if (print_progress_table)
-        msg::print_values (prb->path, shape_name, prb->schedule, time);
-    }
-  }
+      }
 }
 
 void OutController::operator()()
@@ -22,7 +22,10 @@ using namespace std;
 OutWriter::OutWriter ( string _path, unsigned short _shape,
                        vector<short> _position, vector<size_t> _engine_offset,
                        unsigned short _schedule, bool _append, unsigned short _compress,
-                       TimeSim *_time, Grid<double> *_values )
+                       TimeSim *_time, Grid<double> *_values,
+                       unsigned short _time_reduce, unsigned int _sample,
+                       unsigned short _space_reduce, unsigned int _factor,
+                       unsigned int _window )
   : time(_time)
 {
   path = _path;
@@ -30,15 +33,29 @@ OutWriter::OutWriter ( string _path, unsigned short _shape,
   shape = _shape;
   position = _position;
   values = _values;
+
+  time_reduce = _time_reduce;
+  sample = _sample;
+  space_reduce = _space_reduce;
+  factor = _factor;
+
+  samples_amount = 0;
+
+  window = _window;
+  window_head = 0;
 }
 
 #ifdef ENABLE_HDF5
 OutWriter::OutWriter ( HighFive::File* _file, string _path, unsigned short _shape,
                        vector<short> _position, vector<size_t> _engine_offset,
                        unsigned short _schedule, bool _append, unsigned short _compress,
-                       TimeSim *_time, Grid<double> *_values )
+                       TimeSim *_time, Grid<double> *_values,
+                       unsigned short _time_reduce, unsigned int _sample,
+                       unsigned short _space_reduce, unsigned int _factor,
+                       unsigned int _window )
   : OutWriter ( _path, _shape, _position, _engine_offset, _schedule,
-                _append, _compress, _time, _values)
+                _append, _compress, _time, _values,
+                _time_reduce, _sample, _space_reduce, _factor, _window )
 {
   engine = OutEngineHDF5 (_file, _path, {128, 512}, _engine_offset, _append, _compress);
   hdf5_file = _file;
@@ -46,55 +63,292 @@ OutWriter::OutWriter ( HighFive::File* _file, string _path, unsigned short _shap
 }
 #endif // ENABLE_HDF5
 
-void OutWriter::operator()()
+vector<size_t> OutWriter::slice_size()
 {
-  int current_time_step = ceil(time->current / time->step);
-  int is_run = current_time_step % schedule;
+  switch (shape)
+  {
+  case 0: // rectangle shape
+    return {(size_t)(position[2] - position[0]), (size_t)(position[3] - position[1])};
+  case 1: // column shape
+    return {values->x_size, 1};
+  case 2: // row shape
+    return {1, values->y_size};
+  default: // dot shape
+    return {1, 1};
+  }
+}
+
+vector<double> OutWriter::get_slice()
+{
+  vector<double> val;
 
-  if (is_run == 0)
+  switch (shape)
+  {
+  case 0: // rectangle shape
   {
-    size_t slice = (size_t)(ceil(current_time_step / schedule));
-    LOG_S(MAX) << "Launching " << path << "/" << slice;
+    for (short i = position[0]; i < position[2]; ++i)
+      for (short j = position[1]; j < position[3]; ++j)
+        val.push_back( (*values)(i, j) );
+    break;
+  }
+  case 1: // column shape
+  {
+    short col_offset = position[3];
+    for (unsigned int i = 0; i < values->x_size; ++i)
+      val.push_back( (*values)(i, col_offset) );
+    break;
+  }
+  case 2: // row shape
+  {
+    short row_offset = position[2];
+    for (unsigned int i = 0; i < values->y_size; ++i)
+      val.push_back( (*values)(row_offset, i) );
+    break;
+  }
+  case 3: // dot shape
+  {
+    val.push_back( (*values)(position[2], position[3]) );
+    break;
+  }
+  }
 
-    switch (shape)
-    {
-    case 0: // rectangle shape
-    {
-      vector<vector<double>> val (position[2] - position[0],
-                                  vector<double> (position[3] - position[1], 0));
+  return val;
+}
 
-      for (short i = position[0]; i < position[2]; ++i)
-        for (short j = position[1]; j < position[3]; ++j)
-          val[i - position[0]][j - position[1]] = (*values)(i, j);
+vector<double> OutWriter::reduce_space(vector<double> data, vector<size_t> &data_size)
+{
+  if (space_reduce == 0 || factor < 2)
+    return data;
 
-      engine.write_rec(slice, val);
-      break;
-    }
-    case 1: // column shape
-    {
-      vector<double> val;
-      short col_offset = position[3];
-      for (unsigned int i = 0; i < values->x_size; ++i)
-        val.push_back( (*values)(i, col_offset) );
+  // column is reduced only by r, row only by z
+  size_t f_r = data_size[0] > 1 ? factor : 1;
+  size_t f_z = data_size[1] > 1 ? factor : 1;
+  size_t r_size = (data_size[0] + f_r - 1) / f_r;
+  size_t z_size = (data_size[1] + f_z - 1) / f_z;
 
-      engine.write_vec(slice, val);
-      break;
-    }
-    case 2: // row shape
+  vector<double> reduced (r_size * z_size, 0);
+
+  for (size_t i = 0; i < r_size; ++i)
+    for (size_t j = 0; j < z_size; ++j)
+      if (space_reduce == 1)
+        // pick every factor-th cell
+        reduced[i * z_size + j] = data[i * f_r * data_size[1] + j * f_z];
+      else
+      {
+        // average block of factor x factor cells
+        double sum = 0;
+        size_t count = 0;
+        for (size_t k = i * f_r; k < min((i + 1) * f_r, data_size[0]); ++k)
+          for (size_t l = j * f_z; l < min((j + 1) * f_z, data_size[1]); ++l)
+          {
+            sum += data[k * data_size[1] + l];
+            ++count;
+          }
+        reduced[i * z_size + j] = sum / count;
+      }
+
+  data_size = {r_size, z_size};
+
+  return reduced;
+}
+
+void OutWriter::accumulate(vector<double> &data)
+{
+  if (samples_amount == 0)
+  {
+    accumulator = data;
+    if (time_reduce == 4)
+      for (auto a = accumulator.begin(); a != accumulator.end(); ++a)
+        (*a) *= (*a);
+  }
+  else
+    for (size_t i = 0; i < data.size(); ++i)
+      switch (time_reduce)
+      {
+      case 1: // average
+        accumulator[i] += data[i];
+        break;
+      case 2: // min
+        accumulator[i] = min(accumulator[i], data[i]);
+        break;
+      case 3: // max
+        accumulator[i] = max(accumulator[i], data[i]);
+        break;
+      case 4: // rms
+        accumulator[i] += data[i] * data[i];
+        break;
+      }
+
+  ++samples_amount;
+}
+
+void OutWriter::accumulate_window(vector<double> &data)
+{
+  if (window_data.empty())
+    window_data = vector< vector<double> > (data.size(), vector<double> (window, 0));
+
+  for (size_t p = 0; p < data.size(); ++p)
+    window_data[p][window_head] = data[p];
+
+  window_head = (window_head + 1) % window;
+
+  if (samples_amount < window)
+    ++samples_amount;
+}
+
+size_t OutWriter::state_size()
+{
+  size_t size = sizeof(unsigned int) + sizeof(size_t)
+    + algo::serialize::vector_size(accumulator) + sizeof(size_t);
+
+  for (auto p = window_data.begin(); p != window_data.end(); ++p)
+    size += algo::serialize::vector_size(*p);
+
+  return size;
+}
+
+void OutWriter::state_serialize(char *&_buffer)
+{
+  algo::serialize::put(_buffer, samples_amount);
+  algo::serialize::put(_buffer, window_head);
+  algo::serialize::put_vector(_buffer, accumulator);
+
+  algo::serialize::put(_buffer, window_data.size());
+  for (auto p = window_data.begin(); p != window_data.end(); ++p)
+    algo::serialize::put_vector(_buffer, *p);
+}
+
+void OutWriter::state_deserialize(const char *&_buffer)
+{
+  size_t points;
+
+  algo::serialize::get(_buffer, samples_amount);
+  algo::serialize::get(_buffer, window_head);
+  algo::serialize::get_vector(_buffer, accumulator);
+
+  algo::serialize::get(_buffer, points);
+  window_data.resize(points);
+  for (auto p = window_data.begin(); p != window_data.end(); ++p)
+  {
+    algo::serialize::get_vector(_buffer, *p);
+    if ((*p).size() != window)
+      LOG_S(FATAL) << "Saved spectral window of probe ``" << path
+                   << "'' does not fit it's configuration";
+  }
+
+  if ((points > 0 && time_reduce != 5)
+      || (window > 0 && window_head >= window))
+    LOG_S(FATAL) << "Saved time reduction state of probe ``" << path
+                 << "'' does not fit it's configuration";
+}
+
+void OutWriter::write_spectrum(size_t slice, size_t points)
+{
+  vector< vector<double> > spectrum;
+
+  // write zero spectrum, until window is filled,
+  // so every slice of dataset is set
+  if (samples_amount < window)
+    spectrum = vector< vector<double> > (points, vector<double> (window / 2 + 1, 0));
+  else
+    for (auto p = window_data.begin(); p != window_data.end(); ++p)
     {
-      vector<double> val;
-      short row_offset = position[2];
-      for (unsigned int i = 0; i < values->y_size; ++i)
-        val.push_back( (*values)(row_offset, i) );
+      // unroll ring buffer to chronological order
+      vector<double> signal (window);
+      for (size_t i = 0; i < window; ++i)
+        signal[i] = (*p)[(window_head + i) % window];
 
-      engine.write_vec(slice, val);
-      break;
+      spectrum.push_back(math::fft::power_spectrum(signal));
     }
-    case 3: // dot shape
+
+  INSTR_COUNT(BYTES_WRITTEN, -1, spectrum.size() * spectrum[0].size() * sizeof(double));
+
+  if (shape == 3) // dot shape
+    engine.write_vec(slice, spectrum[0]);
+  else // column shape
+    engine.write_rec(slice, spectrum);
+}
+
+void OutWriter::write(size_t slice, vector<double> &data, vector<size_t> &data_size)
+{
+  INSTR_COUNT(BYTES_WRITTEN, -1, data.size() * sizeof(double));
+
+  switch (shape)
+  {
+  case 0: // rectangle shape
+  {
+    vector<vector<double>> val (data_size[0], vector<double> (data_size[1], 0));
+
+    for (size_t i = 0; i < data_size[0]; ++i)
+      for (size_t j = 0; j < data_size[1]; ++j)
+        val[i][j] = data[i * data_size[1] + j];
+
+    engine.write_rec(slice, val);
+    break;
+  }
+  case 1: // column shape
+  case 2: // row shape
+  {
+    engine.write_vec(slice, data);
+    break;
+  }
+  case 3: // dot shape
+  {
+    engine.write_dot(slice, data[0]);
+    break;
+  }
+  }
+}
+
+void OutWriter::operator()()
+{
+  int current_time_step = ceil(time->current / time->step);
+  int is_run = current_time_step % schedule;
+  bool is_sample = time_reduce != 0 && current_time_step % sample == 0;
+
+  if (is_run != 0 && ! is_sample)
+    return;
+
+  vector<size_t> data_size = slice_size();
+  vector<double> data = reduce_space(get_slice(), data_size);
+
+  if (time_reduce == 5)
+  {
+    if (is_sample)
+      accumulate_window(data);
+
+    if (is_run == 0)
     {
-      engine.write_dot(slice, (*values)(position[2], position[3]));
-      break;
-    }
+      size_t slice = (size_t)(ceil(current_time_step / schedule));
+      LOG_S(MAX) << "Launching " << path << "/" << slice;
+      write_spectrum(slice, data.size());
     }
+
+    return;
+  }
+
+  if (time_reduce != 0)
+  {
+    if (is_sample)
+      accumulate(data);
+
+    if (is_run != 0 || samples_amount == 0)
+      return;
+
+    // finalize reduced values for the window and reset accumulator
+    data = accumulator;
+    if (time_reduce == 1)
+      for (auto a = data.begin(); a != data.end(); ++a)
+        (*a) /= samples_amount;
+    else if (time_reduce == 4)
+      for (auto a = data.begin(); a != data.end(); ++a)
+        (*a) = sqrt((*a) / samples_amount);
+
+    samples_amount = 0;
   }
+
+  size_t slice = (size_t)(ceil(current_time_step / schedule));
+  LOG_S(MAX) << "Launching " << path << "/" << slice;
+
+  write(slice, data, data_size);
 }
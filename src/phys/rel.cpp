@@ -33,7 +33,7 @@ namespace phys::rel
     if (beta > 1) // it's VERY BAD! Beta should not be more, than 1
       LOG_S(FATAL) << "(lorenz_factor): Lorentz factor aka gamma is complex. Velocity is: " << algo::common::sq_rt(sq_velocity);
 
-    gamma = 1 / algo::common::sq_rt(1.0 - beta);
+    gamma = algo::simd::rsqrt(1.0 - beta);
 
     if (isinf(gamma) == 1)
       { // avoid infinity values
@@ -44,16 +44,6 @@ namespace phys::rel
       return gamma;
   }
 
-  double lorenz_factor_inv (double sq_velocity)
-  {
-    //! get_gamma_inv takes squared velocity,
-    //! only because of some features of code
-    //! and optimisation issues
-    double gamma = pow(1.0 + sq_velocity / LIGHT_VEL_POW_2, -0.5);
-
-    return gamma;
-  }
-
   double momentum_0 (double mass, vector3d<double> velocity)
   // get 0th momentum in 4-momentum space, aka E/c
   {
@@ -92,7 +82,7 @@ namespace phys::rel
     if (momentum_2 > REL_LIMIT_POW_2 * mass * mass)
     {
       double e_rest = mass * LIGHT_VEL_POW_2;
-      e = algo::common::sq_rt(momentum_2 * LIGHT_VEL_POW_2 + pow(e_rest, 2)) - e_rest;
+      e = algo::common::sq_rt(momentum_2 * LIGHT_VEL_POW_2 + e_rest * e_rest) - e_rest;
     }
     else
       e = 0.5 * momentum_2 / mass;
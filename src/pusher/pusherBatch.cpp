@@ -0,0 +1,119 @@
+/*
+ * This file is part of the PiCoPiC distribution (https://github.com/cosmonaut-ok/PiCoPiC).
+ * Copyright (c) 2020 Alexander Vynnyk.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include "pusher/pusherBatch.hpp"
+
+template <class FieldSolver>
+void PusherBatch<FieldSolver>::push(void (*kernel)(algo::push::Batch &, double))
+{
+  for (auto sp = species_p.begin(); sp != species_p.end(); ++sp)
+  {
+    double charge = (**sp).charge;
+    double mass = (**sp).mass;
+
+    // sub-cycled specie is pushed once per sub-cycle with
+    // larger time step and fields, averaged over the sub-cycle
+    // (field_norm, which converts sums to averages, is folded
+    // into charge_over_2mass_dt, as fields are used only scaled by it)
+    if (! (**sp).is_push_step()) continue;
+
+    bool sub_cycled = (**sp).push_every > 1;
+    double dt = (**sp).push_step();
+    double field_norm = sub_cycled ? 1. / (**sp).field_samples : 1.;
+    Grid3D<double> &field_e = sub_cycled ? (**sp).field_e_sum : field_solver->field_e;
+    Grid3D<double> &field_h = sub_cycled ? (**sp).field_h_sum : field_solver->field_h;
+
+    // we don't care, if it is particle's or macroparticle's
+    // charge over mass ratio
+    double charge_over_2mass_dt = charge * dt * field_norm / (2 * mass);
+
+    // velocities are checked only, if they are converted to momentum
+    bool check_velocity = ! momentum_representation;
+    int invalid = 0;
+
+    size_t particles_amount = (**sp).particles.size();
+
+    // batches are processed by chunks in parallel tasks
+#pragma omp taskloop default(shared) grainsize(PARTICLES_CHUNK_SIZE / PUSH_BATCH_SIZE) reduction(|: invalid)
+    for (size_t first = 0; first < particles_amount; first += PUSH_BATCH_SIZE)
+    {
+      algo::push::Batch batch;
+      Particle **particles = &(**sp).particles[first];
+
+      batch.size = 0;
+      invalid |= ! gather(batch, particles,
+                          std::min((size_t)PUSH_BATCH_SIZE, particles_amount - first),
+                          field_e, field_h, check_velocity);
+
+      if constexpr (! momentum_representation)
+        algo::push::velocity_to_momentum(batch);
+
+      kernel(batch, charge_over_2mass_dt);
+
+      if constexpr (! momentum_representation)
+        algo::push::momentum_to_velocity(batch);
+
+      scatter(batch, particles);
+    }
+
+    if (invalid)
+      report_invalid(*sp, check_velocity);
+  }
+}
+
+template <class FieldSolver>
+bool PusherBatch<FieldSolver>::gather(algo::push::Batch &batch, Particle **particles, size_t size,
+                                      Grid3D<double> &field_e, Grid3D<double> &field_h,
+                                      bool check_velocity)
+{
+  bool valid = true;
+
+  for (size_t n = 0; n < size; ++n)
+  {
+    Particle &p = *particles[n];
+    double pos_r = P_POS_R(p);
+    double pos_z = P_POS_Z(p);
+
+    valid &= valid_particle(p, check_velocity);
+
+    vector3d<double> e = field_solver->FieldSolver::get_field_e(field_e, pos_r, pos_z);
+    vector3d<double> b = field_solver->FieldSolver::get_field_h(field_h, pos_r, pos_z);
+
+    batch.add(P_VEL_R(p), P_VEL_PHI(p), P_VEL_Z(p),
+              e[0], e[1], e[2], b[0], b[1], b[2]);
+  }
+
+  return valid;
+}
+
+template <class FieldSolver>
+void PusherBatch<FieldSolver>::scatter(algo::push::Batch &batch, Particle **particles)
+{
+  for (size_t n = 0; n < batch.size; ++n)
+  {
+    Particle &p = *particles[n];
+
+    P_VEL_R(p) = batch.u[0][n];
+    P_VEL_PHI(p) = batch.u[1][n];
+    P_VEL_Z(p) = batch.u[2][n];
+  }
+}
+
+// instantiate for available field solvers
+template class PusherBatch<MaxwellSolverYee>;
@@ -20,7 +20,8 @@
 
 using namespace constant;
 
-void PusherBoris::operator()()
+template <class FieldSolver, int variant>
+void PusherBoris<FieldSolver, variant>::operator()()
 {
   // !
   // ! boris pusher
@@ -30,16 +31,32 @@ void PusherBoris::operator()()
     double charge = (**sp).charge;
     double mass = (**sp).mass;
 
-    for (auto p = (**sp).particles.begin(); p != (**sp).particles.end(); ++p)
+    // sub-cycled specie is pushed once per sub-cycle with
+    // larger time step and fields, averaged over the sub-cycle
+    // (field_norm, which converts sums to averages, is folded
+    // into charge_over_2mass_dt, as fields are used only scaled by it)
+    if (! (**sp).is_push_step()) continue;
+
+    bool sub_cycled = (**sp).push_every > 1;
+    double dt = (**sp).push_step();
+    double field_norm = sub_cycled ? 1. / (**sp).field_samples : 1.;
+    Grid3D<double> &field_e = sub_cycled ? (**sp).field_e_sum : field_solver->field_e;
+    Grid3D<double> &field_h = sub_cycled ? (**sp).field_h_sum : field_solver->field_h;
+
+    // velocities are checked only, if they are converted to momentum
+    bool check_velocity = ! momentum_representation && variant != BORIS_CLASSIC;
+    int invalid = 0;
+
+#pragma omp taskloop default(shared) grainsize(PARTICLES_CHUNK_SIZE) reduction(|: invalid)
+    for (auto p = (**sp).particles.begin(); p < (**sp).particles.end(); ++p)
     {
+      invalid |= ! valid_particle(**p, check_velocity);
+
       // define vars directly in loop, because of multithreading
-      double charge_over_2mass_dt, const2, sq_velocity;
-#ifdef SWITCH_PUSHER_BORIS_ADAPTIVE
-      bool use_rel; // use relativistic calculations
-#endif // SWITCH_PUSHER
-#if defined(SWITCH_PUSHER_BORIS_ADAPTIVE) || defined(SWITCH_PUSHER_BORIS_RELATIVISTIC) // do not use gamma in non-relativistic boris pusher
-      double gamma = 1;
-#endif // SWITCH_PUSHER
+      double charge_over_2mass_dt, const2;
+      // relativistic factors. Are calculated for every particle
+      // and selected (not branched) in adaptive variant
+      double gamma = 1, gamma_inv = 1;
 
       vector3d<double> velocity(P_VEL_R((**p)), P_VEL_PHI((**p)), P_VEL_Z((**p)));
       vector3d<double> vtmp;
@@ -47,42 +64,27 @@ void PusherBoris::operator()()
       double pos_r = P_POS_R((**p));
       double pos_z = P_POS_Z((**p));
 
-      // check if radius and longitude are correct
-      if (isnan(pos_r) ||
-          isinf(pos_r) != 0 ||
-          isnan(pos_z) ||
-          isinf(pos_z) != 0)
-        LOG_S(FATAL) << "(boris_pusher): radius[" << pos_r
-                     << "] or longitude[" << pos_z
-                     << "] is not valid number. Can not continue.";
-
-      vector3d<double> e = maxwell_solver->get_field_e(pos_r, pos_z);
-      vector3d<double> b = maxwell_solver->get_field_h(pos_r, pos_z);
+      vector3d<double> e = field_solver->FieldSolver::get_field_e(field_e, pos_r, pos_z);
+      vector3d<double> b = field_solver->FieldSolver::get_field_h(field_h, pos_r, pos_z);
 
-      charge_over_2mass_dt = charge * time->step / (2 * mass); // we just shortened particle weight and use only q/m relation
+      charge_over_2mass_dt = charge * dt * field_norm / (2 * mass); // we just shortened particle weight and use only q/m relation
 
       e *= charge_over_2mass_dt;
       b *= charge_over_2mass_dt * MAGN_CONST;
 
-      // ! 0. check, if we should use classical calculations.
-      // ! Required to increase modeling speed
-#ifdef SWITCH_PUSHER_BORIS_ADAPTIVE
-      if (pow(velocity[0], 2) + pow(velocity[1], 2) + pow(velocity[2], 2) > REL_LIMIT_POW_2)
-        use_rel = true;
-#endif // SWITCH_PUSHER
+      // ! 0. check, if we should use classical calculations
+      // ! (adaptive variant, velocity representation only)
+      bool use_rel = momentum_representation || variant == BORIS_RELATIVISTIC
+        || (variant == BORIS_ADAPTIVE && velocity.length2() > REL_LIMIT_POW_2);
+
       // ! 1. Multiplication by relativistic factor (only for relativistic case)
       // ! \f$ u_{n-\frac{1}{2}} = \gamma_{n-\frac{1}{2}} * v_{n-\frac{1}{2}} \f$
-#ifdef SWITCH_PUSHER_BORIS_ADAPTIVE
-      if (use_rel)
-#endif // SWITCH_PUSHER
-#if defined(SWITCH_PUSHER_BORIS_RELATIVISTIC) || defined(SWITCH_PUSHER_BORIS_ADAPTIVE)
+      // ! (momentum is already stored in momentum representation)
+      if constexpr (! momentum_representation && variant != BORIS_CLASSIC)
       {
-        sq_velocity = velocity.length2();
-
-        gamma = phys::rel::lorenz_factor(sq_velocity);
-        velocity *= gamma;
+        gamma = phys::rel::lorenz_factor_unchecked(velocity.length2());
+        velocity *= use_rel ? gamma : 1.;
       }
-#endif // SWITCH_PUSHER
 
       // ! 2. Half acceleration in the electric field
       // ! \f$ u'_n = u_{n-\frac{1}{2}} + \frac{q dt}{2 m E(n)} \f$
@@ -92,16 +94,11 @@ void PusherBoris::operator()()
       // ! 3. Rotation in the magnetic field
       // ! \f$ u" = u' + \frac{2}{1 + B'^2}  [(u' + [u' \times B'(n)] ) \times B'(n)] \f$,
       // ! \f$ B'(n) = \frac{B(n) q dt}{2 m * \gamma_n} \f$
-#ifdef SWITCH_PUSHER_BORIS_ADAPTIVE
-      if (use_rel)
-#endif // SWITCH_PUSHER
-#if defined(SWITCH_PUSHER_BORIS_RELATIVISTIC) || defined(SWITCH_PUSHER_BORIS_ADAPTIVE)
+      if constexpr (momentum_representation || variant != BORIS_CLASSIC)
       {
-        sq_velocity = velocity.length2();
-        gamma = phys::rel::lorenz_factor_inv(sq_velocity);
-        b *= gamma;
+        gamma_inv = phys::rel::lorenz_factor_inv(velocity.length2());
+        b *= use_rel ? gamma_inv : 1.;
       }
-#endif // SWITCH_PUSHER
       // ! \f$ const2 = \frac{2}{1 + b_1^2 + b_2^2 + b_3^2} \f$
       const2 = 2. / (1. + b.length2());
 
@@ -127,20 +124,24 @@ void PusherBoris::operator()()
       velocity += e;
 
       // ! 5. Division by relativistic factor
-#ifdef SWITCH_PUSHER_BORIS_ADAPTIVE
-      if (use_rel)
-#endif // SWITCH_PUSHER
-#if defined(SWITCH_PUSHER_BORIS_RELATIVISTIC) || defined(SWITCH_PUSHER_BORIS_ADAPTIVE)
+      // ! (momentum is stored in momentum representation)
+      if constexpr (! momentum_representation && variant != BORIS_CLASSIC)
       {
-        sq_velocity = velocity.length2();
-        gamma = phys::rel::lorenz_factor_inv(sq_velocity);
-        velocity *= gamma;
+        gamma_inv = phys::rel::lorenz_factor_inv(velocity.length2());
+        velocity *= use_rel ? gamma_inv : 1.;
       }
-#endif // SWITCH_PUSHER
 
       P_VEL_R((**p)) = velocity[0];
       P_VEL_PHI((**p)) = velocity[1];
       P_VEL_Z((**p)) = velocity[2];
     }
+
+    if (invalid)
+      report_invalid(*sp, check_velocity);
   }
 }
+
+// instantiate all of the variants for available field solvers
+template class PusherBoris<MaxwellSolverYee, BORIS_CLASSIC>;
+template class PusherBoris<MaxwellSolverYee, BORIS_ADAPTIVE>;
+template class PusherBoris<MaxwellSolverYee, BORIS_RELATIVISTIC>;
@@ -17,6 +17,8 @@
 
 #include "specieP.hpp"
 #include "geometry.hpp"
+#include "maxwellSolver.hpp"
+#include "algo/resampler.hpp"
 
 using namespace constant;
 
@@ -60,6 +62,9 @@ SpecieP::SpecieP (unsigned int p_id,
 
   temperature = p_temperature;
 
+  push_every = 1;
+  field_samples = 0;
+
   density_map = Grid<double> (geometry->cell_amount[0], geometry->cell_amount[1], 2);
   temperature_map = Grid<double> (geometry->cell_amount[0], geometry->cell_amount[1], 2);
 
@@ -72,6 +77,8 @@ SpecieP::SpecieP (unsigned int p_id,
 #ifdef SWITCH_TEMP_CALC_COUNTING
   count = Grid<double> (geometry->cell_amount[0], geometry->cell_amount[1], 2);
 #endif // SWITCH_TEMP_CALC_COUNTING
+
+  invalidate_diagnostics();
 }
 
 SpecieP::~SpecieP()
@@ -93,6 +100,50 @@ void SpecieP::fullyfill_spatial_distribution()
                                    geometry->cell_dims[3]);
 }
 
+void SpecieP::load_plasma(unsigned int left_cell_number,
+                          unsigned int right_cell_number)
+// ! fill z-range of cells with plasma macroparticles (e.g. leading
+// ! edge of moving window) with spatial and velocity distributions
+// ! of specie. Amount of macroparticles is proportional to range length
+{
+  // cell at z=z wall is not filled in full distribution,
+  // because of particles formfactor
+  double z_cells = geometry->cell_amount[1];
+  if (geometry->walls[3]) z_cells -= 1;
+
+  unsigned int full_macro_amount = macro_amount;
+  macro_amount = (unsigned int)(full_macro_amount * (right_cell_number - left_cell_number) / z_cells);
+
+  if (macro_amount == 0)
+  {
+    macro_amount = full_macro_amount;
+    return;
+  }
+
+  // distribute to empty specie, so placement, weighting
+  // and velocity distribution touch only new macroparticles
+  vector<Particle *> present;
+  present.swap(particles);
+
+  // range is filled completely, even if it is near z=z wall
+  bool wall_zz = geometry->walls[3];
+  geometry->walls[3] = false;
+
+  rectangular_spatial_distribution(geometry->cell_dims[0], geometry->cell_dims[2],
+                                   left_cell_number, right_cell_number);
+  velocity_distribution();
+  bind_cell_numbers();
+  dump_position_to_old();
+
+  geometry->walls[3] = wall_zz;
+  macro_amount = full_macro_amount;
+
+  present.insert(present.end(), particles.begin(), particles.end());
+  particles.swap(present);
+
+  invalidate_diagnostics();
+}
+
 void SpecieP::linear_spatial_distribution(unsigned int int_cell_number,
                                           unsigned int ext_cell_number)
 // ! spatial distribution for linear (for cartese coordinates)
@@ -380,9 +431,8 @@ void SpecieP::thermal_velocity_distribution ()
     double rnd_1 = math::random::uniform2();
     double rnd_2 = math::random::uniform2();
 
-    P_VEL_R((**p)) = rnd_0 * therm_vel_cmp;
-    P_VEL_PHI((**p)) = rnd_1 * therm_vel_cmp;
-    P_VEL_Z((**p)) = rnd_2 * therm_vel_cmp;
+    set_particle_velocity((**p), rnd_0 * therm_vel_cmp,
+                          rnd_1 * therm_vel_cmp, rnd_2 * therm_vel_cmp);
 
     ++macro_count;
   }
@@ -412,9 +462,8 @@ void SpecieP::rectangular_velocity_distribution ()
     rnd_1 = math::random::uniform2();
     rnd_2 = math::random::uniform2();
 
-    P_VEL_R((**p)) = rnd_0 * therm_vel_cmp;
-    P_VEL_PHI((**p)) = rnd_1 * therm_vel_cmp;
-    P_VEL_Z((**p)) = rnd_2 * therm_vel_cmp;
+    set_particle_velocity((**p), rnd_0 * therm_vel_cmp,
+                          rnd_1 * therm_vel_cmp, rnd_2 * therm_vel_cmp);
   }
 }
 
@@ -437,9 +486,7 @@ void SpecieP::eigen_velocity_distribution ()
 
   for (auto p = particles.begin(); p != particles.end(); ++p)
   {
-    P_VEL_R((**p)) = therm_vel_cmp;
-    P_VEL_PHI((**p)) = therm_vel_cmp;
-    P_VEL_Z((**p)) = therm_vel_cmp;
+    set_particle_velocity((**p), therm_vel_cmp, therm_vel_cmp, therm_vel_cmp);
   }
 }
 
@@ -462,6 +509,9 @@ void SpecieP::eigen_directed_velocity_distribution (unsigned int dir)
   else
     therm_vel_cmp = algo::common::sq_rt(temperature * two_over_mass);
 
+  // only one component is set, other ones are assumed to be zero
+  therm_vel_cmp *= VEL_TO_STORED(therm_vel_cmp * therm_vel_cmp);
+
   switch (dir)
   {
   case 0:
@@ -486,15 +536,76 @@ void SpecieP::inject () {}
 
 void SpecieP::mover_cylindrical()
 {
-  for (auto p = particles.begin(); p != particles.end(); ++p)
+  // particles positions are changed, so density and temperature are outdated
+  invalidate_diagnostics();
+
+  // sub-cycled specie is moved once per sub-cycle
+  if (! is_push_step()) return;
+
+  double dt = push_step();
+
+  // particles are independent, so they are processed by chunks in
+  // parallel tasks here and below. Is nested into domain's task
+#pragma omp taskloop default(shared) grainsize(PARTICLES_CHUNK_SIZE)
+  for (auto p = particles.begin(); p < particles.end(); ++p)
   {
-    P_POS_R((**p)) = P_POS_R((**p)) + P_VEL_R((**p)) * time->step;
+    double gamma_inv = P_GAMMA_INV((**p));
+
+    P_POS_R((**p)) = P_POS_R((**p)) + P_VEL_R((**p)) * gamma_inv * dt;
     //! we use "fake" rotation component to correct position from xy to rz pane
-    P_POS_PHI((**p)) = P_POS_PHI((**p)) + P_VEL_PHI((**p)) * time->step;
-    P_POS_Z((**p)) = P_POS_Z((**p)) + P_VEL_Z((**p)) * time->step;
+    P_POS_PHI((**p)) = P_POS_PHI((**p)) + P_VEL_PHI((**p)) * gamma_inv * dt;
+    P_POS_Z((**p)) = P_POS_Z((**p)) + P_VEL_Z((**p)) * gamma_inv * dt;
   }
 }
 
+void SpecieP::set_push_every (unsigned int steps)
+{
+  push_every = steps;
+  field_samples = 0;
+
+  // fields are accumulated only for sub-cycled species
+  if (push_every > 1)
+  {
+    field_e_sum = Grid3D<double> (geometry->cell_amount[0], geometry->cell_amount[1], 2);
+    field_h_sum = Grid3D<double> (geometry->cell_amount[0], geometry->cell_amount[1], 2);
+    reset_fields();
+  }
+}
+
+bool SpecieP::is_push_step ()
+{
+  if (push_every == 1)
+    return true;
+
+  // push at the end of sub-cycle, when all it's fields are accumulated
+  long int current_step = lround(time->current / time->step);
+
+  return (current_step + 1) % push_every == 0;
+}
+
+double SpecieP::push_step ()
+{
+  return time->step * push_every;
+}
+
+void SpecieP::accumulate_fields ()
+{
+  if (push_every == 1)
+    return;
+
+  // overlay is also accumulated, because it is used in interpolation
+  field_e_sum.add(maxwell_solver->field_e);
+  field_h_sum.add(maxwell_solver->field_h);
+  ++field_samples;
+}
+
+void SpecieP::reset_fields ()
+{
+  field_e_sum.zero();
+  field_h_sum.zero();
+  field_samples = 0;
+}
+
 void SpecieP::reflect ()
 {
   double dr = geometry->cell_size[0];
@@ -512,7 +623,8 @@ void SpecieP::reflect ()
   double r_shift = geometry->cell_dims[0] * dr;
   double z_shift = geometry->cell_dims[1] * dz;
 
-  for (auto p = particles.begin(); p != particles.end(); ++p)
+#pragma omp taskloop default(shared) grainsize(PARTICLES_CHUNK_SIZE)
+  for (auto p = particles.begin(); p < particles.end(); ++p)
   {
     // set temporary position as it located in domain 0,0
     double pos_r = P_POS_R((**p)) - r_shift;
@@ -615,7 +727,10 @@ void SpecieP::back_position_to_rz()
 {
   // ! implementation of backing coodrinates to rz pane
   // ! taken from https: // www.particleincell.com / 2015 / rz-pic /
-  for (auto p = particles.begin(); p != particles.end(); ++p)
+  if (! is_push_step()) return;
+
+#pragma omp taskloop default(shared) grainsize(PARTICLES_CHUNK_SIZE)
+  for (auto p = particles.begin(); p < particles.end(); ++p)
   {
     double pos_r = P_POS_R((**p));
     double pos_phi = P_POS_PHI((**p));
@@ -630,7 +745,10 @@ void SpecieP::back_velocity_to_rz()
 {
   // ! implementation of backing coodrinates to rz pane
   // ! taken from https: // www.particleincell.com / 2015 / rz-pic /
-  for (auto p = particles.begin(); p != particles.end(); ++p)
+  if (! is_push_step()) return;
+
+#pragma omp taskloop default(shared) grainsize(PARTICLES_CHUNK_SIZE)
+  for (auto p = particles.begin(); p < particles.end(); ++p)
   {
     double sin = P_SIN((**p));
     double cos = P_COS((**p));
@@ -646,7 +764,8 @@ void SpecieP::back_velocity_to_rz()
 
 void SpecieP::dump_position_to_old()
 {
-  for (auto p = particles.begin(); p != particles.end(); ++p)
+#pragma omp taskloop default(shared) grainsize(PARTICLES_CHUNK_SIZE)
+  for (auto p = particles.begin(); p < particles.end(); ++p)
   {
     P_POS_OLD_R((**p)) = P_POS_R((**p));
     P_POS_OLD_PHI((**p)) = P_POS_PHI((**p));
@@ -656,7 +775,8 @@ void SpecieP::dump_position_to_old()
 
 void SpecieP::bind_cell_numbers()
 {
-  for (auto p = particles.begin(); p != particles.end(); ++p)
+#pragma omp taskloop default(shared) grainsize(PARTICLES_CHUNK_SIZE)
+  for (auto p = particles.begin(); p < particles.end(); ++p)
   {
     // renumerate cells
     int r_cell = CELL_NUMBER(P_POS_R((**p)), geometry->cell_size[0]);
@@ -668,11 +788,75 @@ void SpecieP::bind_cell_numbers()
 }
 
 
+void SpecieP::resample(unsigned int min_per_cell, unsigned int max_per_cell)
+{
+  //! merge particles in cells, which contain more, than
+  //! max_per_cell particles (down to max_per_cell / 2) and
+  //! split particles in cells, which contain less, than
+  //! min_per_cell particles. Zero disables the limit.
+  //! Cell numbers should be bound before resampling
+  size_t r_cells = geometry->cell_amount[0];
+  size_t z_cells = geometry->cell_amount[1];
+  double dz = geometry->cell_size[1];
+
+  vector< vector<Particle*> > cells (r_cells * z_cells);
+  vector<Particle*> outer; // particles, not bound to the domain cells
+
+  for (auto p = particles.begin(); p != particles.end(); ++p)
+  {
+    long int r_cell = (long int)P_CELL_R((**p)) - (long int)geometry->cell_dims[0];
+    long int z_cell = (long int)P_CELL_Z((**p)) - (long int)geometry->cell_dims[1];
+
+    if (r_cell >= 0 && r_cell < (long int)r_cells
+        && z_cell >= 0 && z_cell < (long int)z_cells)
+      cells[r_cell * z_cells + z_cell].push_back(*p);
+    else
+      outer.push_back(*p);
+  }
+
+#pragma omp parallel for schedule(dynamic, 16)
+  for (size_t c = 0; c < cells.size(); ++c)
+  {
+    vector<Particle*> &cell = cells[c];
+
+    if (max_per_cell > 0 && cell.size() > max_per_cell)
+      algo::resampler::merge_cell(cell, max_per_cell / 2);
+    else if (! cell.empty() && cell.size() < min_per_cell)
+    {
+      double z_left = (c % z_cells + geometry->cell_dims[1]) * dz;
+      algo::resampler::split_cell(cell, min_per_cell, z_left, z_left + dz);
+    }
+  }
+
+  // particles are stored cell by cell after resampling
+  size_t size = outer.size();
+  for (auto c = cells.begin(); c != cells.end(); ++c)
+    size += c->size();
+
+  particles.clear();
+  particles.reserve(size);
+
+  for (auto c = cells.begin(); c != cells.end(); ++c)
+    particles.insert(particles.end(), c->begin(), c->end());
+  particles.insert(particles.end(), outer.begin(), outer.end());
+
+  invalidate_diagnostics();
+}
+
+void SpecieP::invalidate_diagnostics()
+{
+  density_map_valid = false;
+  temperature_map_valid = false;
+}
+
 void SpecieP::calc_density()
 { // FIXME: it weights density in both cases
+  // density is already calculated for current particles positions
+  if (density_map_valid)
+    return;
+
   // clear grid values
-  density_map = 0;
-  density_map.overlay_set(0);
+  density_map.zero();
 
 #ifdef SWITCH_DENSITY_CALC_COUNTING
   for (auto i = particles.begin(); i != particles.end(); i++)
@@ -687,27 +871,27 @@ void SpecieP::calc_density()
                                  P_POS_Z((**i)),
                                  P_WEIGHT((**i)));
 #endif // end of SWITCH_DENSITY_CALC_...
+
+  density_map_valid = true;
 }
 
 void SpecieP::calc_temperature()
 {
+  // temperature is already calculated for current particles positions
+  if (temperature_map_valid)
+    return;
+
   // clear grid values
-  temperature_map = 0;
-  temperature_map.overlay_set(0);
+  temperature_map.zero();
 
   // clear momentum grid
-  p_abs = 0;
-  p_abs.overlay_set(0);
-  p_r = 0;
-  p_r.overlay_set(0);
-  p_phi = 0;
-  p_phi.overlay_set(0);
-  p_z = 0;
-  p_z.overlay_set(0);
+  p_abs.zero();
+  p_r.zero();
+  p_phi.zero();
+  p_z.zero();
 
 #ifdef SWITCH_TEMP_CALC_COUNTING
-  count = 0;
-  count.overlay_set(0);
+  count.zero();
 
   for (auto i = particles.begin(); i != particles.end(); i++)
   {
@@ -717,13 +901,12 @@ void SpecieP::calc_temperature()
     unsigned int r_i_shift = r_i - geometry->cell_dims[0];
     unsigned int z_k_shift = z_k - geometry->cell_dims[1];
 
-    double vel_r_single = P_VEL_R((**i));
-    double vel_phi_single = P_VEL_PHI((**i));
-    double vel_z_single = P_VEL_Z((**i));
+    double vel_r_single, vel_phi_single, vel_z_single;
+    particle_velocity((**i), vel_r_single, vel_phi_single, vel_z_single);
 
-    double vel_abs_single = algo::common::sq_rt(pow(vel_r_single, 2)
-                                                + pow(vel_phi_single, 2)
-                                                + pow(vel_z_single, 2));
+    double vel_abs_single = algo::common::sq_rt(vel_r_single * vel_r_single
+                                                + vel_phi_single * vel_phi_single
+                                                + vel_z_single * vel_z_single);
 
     if (vel_abs_single < REL_LIMIT)
     {
@@ -741,75 +924,115 @@ void SpecieP::calc_temperature()
     count.inc(r_i_shift, z_k_shift, 1);
   }
 #elif defined(SWITCH_TEMP_CALC_WEIGHTING)
-  // calculate density initially
-  calc_density();
-
-  for (auto i = particles.begin(); i != particles.end(); i++)
+  // density and momentum moments are weighted in the single particles
+  // sweep to interleaved array of moments: [density, p_r, p_phi, p_z, p_abs]
+  // per grid node. Density is weighted only if it is not calculated
+  // for this step yet
+  bool weight_density = ! density_map_valid;
+
+  unsigned int x_real_size = density_map.x_real_size;
+  unsigned int y_real_size = density_map.y_real_size;
+  unsigned int o_s = density_map.o_s;
+  size_t moments_size = (size_t)x_real_size * y_real_size * TEMP_CALC_MOMENTS_AMOUNT;
+  size_t particles_amount = particles.size();
+
+  double *moments = new double[moments_size]();
+
+  // moments are accumulated serially: callers already run domains
+  // in parallel, and per-thread copies of the whole moments array
+  // do not fit thread stack for large domains.
+  // Absolute velocities and lorenz factors are calculated
+  // with batch math for blocks of particles
+  for (size_t block = 0; block < particles_amount; block += TEMP_CALC_BLOCK_SIZE)
   {
-    double vel_r_single = P_VEL_R((**i));
-    double vel_phi_single = P_VEL_PHI((**i));
-    double vel_z_single = P_VEL_Z((**i));
+    size_t block_size = std::min((size_t)TEMP_CALC_BLOCK_SIZE, particles_amount - block);
+    double vel_abs[TEMP_CALC_BLOCK_SIZE];
+    double gamma[TEMP_CALC_BLOCK_SIZE];
 
-    double vel_abs_single = algo::common::sq_rt (
-      pow(vel_r_single, 2)
-      + pow(vel_phi_single, 2)
-      + pow(vel_z_single, 2)
-      );
+    for (size_t n = 0; n < block_size; ++n)
+    {
+      Particle *i = particles[block + n];
 
-    double m_weighted = mass * P_WEIGHT((**i));
+      double vel_r, vel_phi, vel_z;
+      particle_velocity((*i), vel_r, vel_phi, vel_z);
 
-    double p_r_single = m_weighted * vel_r_single;
-    double p_phi_single = m_weighted * vel_phi_single;
-    double p_z_single = m_weighted * vel_z_single;
-    double p_abs_single = m_weighted * vel_abs_single;
+      vel_abs[n] = vel_r * vel_r + vel_phi * vel_phi + vel_z * vel_z;
 
-    if (vel_abs_single < REL_LIMIT)
-    {
-      double gamma = phys::rel::lorenz_factor(pow(vel_abs_single, 2));
-      p_r_single *= gamma;
-      p_phi_single *= gamma;
-      p_z_single *= gamma;
-      p_abs_single *= gamma;
+      // 1 / gamma^2
+      gamma[n] = 1. - vel_abs[n] / LIGHT_VEL_POW_2;
     }
 
-    weight_cylindrical<double>(geometry, &p_r,
-                               P_POS_R((**i)),
-                               P_POS_Z((**i)),
-                               p_r_single);
-
-    weight_cylindrical<double>(geometry, &p_phi,
-                               P_POS_R((**i)),
-                               P_POS_Z((**i)),
-                               p_phi_single);
-
-    weight_cylindrical<double>(geometry, &p_z,
-                               P_POS_R((**i)),
-                               P_POS_Z((**i)),
-                               p_z_single);
-
-    weight_cylindrical<double>(geometry, &p_abs,
-                               P_POS_R((**i)),
-                               P_POS_Z((**i)),
-                               p_abs_single);
+    algo::simd::sqrt(vel_abs, vel_abs, block_size);
+    algo::simd::rsqrt(gamma, gamma, block_size);
+
+    for (size_t n = 0; n < block_size; ++n)
+    {
+      Particle *i = particles[block + n];
+
+      double vel_r_single, vel_phi_single, vel_z_single;
+      particle_velocity((*i), vel_r_single, vel_phi_single, vel_z_single);
+      double vel_abs_single = vel_abs[n];
+
+      double m_weighted = mass * P_WEIGHT((*i));
+
+      double m_gamma_weighted = m_weighted;
+      if (vel_abs_single < REL_LIMIT)
+        m_gamma_weighted *= gamma[n];
+
+      double values[TEMP_CALC_MOMENTS_AMOUNT] = {
+        weight_density ? P_WEIGHT((*i)) : 0,
+        m_gamma_weighted * vel_r_single,
+        m_gamma_weighted * vel_phi_single,
+        m_gamma_weighted * vel_z_single,
+        m_gamma_weighted * vel_abs_single
+      };
+
+      weight_cylindrical_moments<double, TEMP_CALC_MOMENTS_AMOUNT>(
+        geometry, moments, y_real_size, o_s,
+        P_POS_R((*i)), P_POS_Z((*i)), values);
+    }
   }
 
+  // unpack moments to grids (including overlay area)
+  double **density_grid = density_map.get_grid();
+  double **p_r_grid = p_r.get_grid();
+  double **p_phi_grid = p_phi.get_grid();
+  double **p_z_grid = p_z.get_grid();
+  double **p_abs_grid = p_abs.get_grid();
+
+  for (unsigned int r = 0; r < x_real_size; ++r)
+    for (unsigned int z = 0; z < y_real_size; ++z)
+    {
+      double *m = &moments[((size_t)r * y_real_size + z) * TEMP_CALC_MOMENTS_AMOUNT];
+
+      if (weight_density)
+        density_grid[r][z] = m[0];
+      p_r_grid[r][z] = m[1];
+      p_phi_grid[r][z] = m[2];
+      p_z_grid[r][z] = m[3];
+      p_abs_grid[r][z] = m[4];
+    }
+
+  delete [] moments;
+
+  density_map_valid = true;
 #endif // end of SWITCH_TEMP_CALC_...
 
   for (int r = 0; r < geometry->cell_amount[0]; r++)
     for (int z = 0; z < geometry->cell_amount[1]; z++)
     {
       double p_vec_sum_2 =
-        pow(p_r(r, z), 2)
-        + pow(p_phi(r, z), 2)
-        + pow(p_z(r, z), 2);
+        p_r(r, z) * p_r(r, z)
+        + p_phi(r, z) * p_phi(r, z)
+        + p_z(r, z) * p_z(r, z);
 
-      double p_sc_sum_2 = pow(p_abs(r, z), 2) - p_vec_sum_2;
+      double p_sc_sum_2 = p_abs(r, z) * p_abs(r, z) - p_vec_sum_2;
 
       // normalize to count/density and convert Joules to eV
 #ifdef SWITCH_TEMP_CALC_COUNTING
-      p_sc_sum_2 /= pow(count(r, z), 2);
+      p_sc_sum_2 /= count(r, z) * count(r, z);
 #elif defined(SWITCH_TEMP_CALC_WEIGHTING)
-      p_sc_sum_2 /= pow(density_map(r, z), 2);
+      p_sc_sum_2 /= density_map(r, z) * density_map(r, z);
 #endif // end of SWITCH_TEMP_CALC_...
 
       double energy = phys::rel::energy_m(mass, p_sc_sum_2);
@@ -819,4 +1042,6 @@ void SpecieP::calc_temperature()
 
       temperature_map.set(r, z, energy);
     }
+
+  temperature_map_valid = true;
 }
@@ -0,0 +1,92 @@
+/*
+ * This file is part of the PiCoPiC distribution (https://github.com/cosmonaut-ok/PiCoPiC).
+ * Copyright (c) 2020 Alexander Vynnyk.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "syntheticDomain.hpp"
+
+#include "cfg.hpp"
+#include "SMB.hpp"
+
+#ifndef BENCHMARK_CFG
+#define BENCHMARK_CFG "../../PiCoPiC.json"
+#endif
+
+namespace {
+
+  // SMB of 2x4 domains. Every iteration all of the particles
+  // are shifted longitudinally by ``shift'' cells (periodically),
+  // so particles near domains borders migrate to neighbour domains
+  void BM_runaway_collector(benchmark::State& state, double shift)
+  {
+    size_t r_cells = state.range(0);
+    size_t z_cells = 2 * r_cells;
+
+    Cfg cfg (BENCHMARK_CFG);
+    cfg.particle_beams.clear();
+    for (auto k = cfg.particle_species.begin(); k != cfg.particle_species.end(); ++k)
+    {
+      k->macro_amount = state.range(1) * r_cells * z_cells;
+      k->left_density = BENCHMARK_DENSITY;
+      k->right_density = BENCHMARK_DENSITY;
+    }
+
+    Geometry geometry ( { r_cells * BENCHMARK_CELL_SIZE, z_cells * BENCHMARK_CELL_SIZE },
+                        { 0, 0, r_cells, z_cells },
+                        { true, true, true, true } );
+    geometry.domains_amount = {2, 4};
+
+    TimeSim time;
+    time.start = 0;
+    time.end = BENCHMARK_TIME_STEP * 1e6;
+    time.step = BENCHMARK_TIME_STEP;
+    time.current = BENCHMARK_TIME_STEP;
+    time.print_header_counter = 0;
+
+    SMB smb (&cfg, &geometry, &time, 0, 1);
+    smb.distribute();
+
+    double dz = shift * BENCHMARK_CELL_SIZE;
+    size_t particles_amount = 0;
+
+    for (auto _ : state)
+    {
+      state.PauseTiming();
+      particles_amount = 0;
+      for (unsigned int i = 0; i < smb.r_domains; ++i)
+        for (unsigned int j = 0; j < smb.z_domains; ++j)
+          for (auto ps = smb.domains(i, j)->species_p.begin();
+               ps != smb.domains(i, j)->species_p.end(); ++ps)
+          {
+            for (auto p = (**ps).particles.begin(); p != (**ps).particles.end(); ++p)
+            {
+              P_POS_Z((**p)) += dz;
+              if (P_POS_Z((**p)) >= geometry.size[1])
+                P_POS_Z((**p)) -= geometry.size[1];
+            }
+            (**ps).bind_cell_numbers();
+            particles_amount += (**ps).particles.size();
+          }
+      state.ResumeTiming();
+
+      smb.particles_runaway_collector();
+    }
+
+    state.SetItemsProcessed(state.iterations() * particles_amount);
+  }
+
+  BENCHMARK_CAPTURE(BM_runaway_collector, quarter_cell, 0.25)->BENCHMARK_ARGS;
+  BENCHMARK_CAPTURE(BM_runaway_collector, two_cells, 2.)->BENCHMARK_ARGS;
+}
@@ -0,0 +1,41 @@
+/*
+ * This file is part of the PiCoPiC distribution (https://github.com/cosmonaut-ok/PiCoPiC).
+ * Copyright (c) 2020 Alexander Vynnyk.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "syntheticDomain.hpp"
+
+#include "collisions/collisionsSK98.hpp"
+#include "collisions/collisionsTA77S.hpp"
+#include "collisions/collisionsP12.hpp"
+
+namespace {
+
+  template <class C>
+  void BM_collisions(benchmark::State& state)
+  {
+    SyntheticDomain domain (state.range(0), state.range(1));
+    C collisions (&domain.geometry, &domain.time, domain.species_p);
+
+    for (auto _ : state)
+      collisions();
+
+    state.SetItemsProcessed(state.iterations() * domain.particles_amount());
+  }
+
+  BENCHMARK_TEMPLATE(BM_collisions, CollisionsSK98)->BENCHMARK_ARGS;
+  BENCHMARK_TEMPLATE(BM_collisions, CollisionsTA77S)->BENCHMARK_ARGS;
+  BENCHMARK_TEMPLATE(BM_collisions, CollisionsP12)->BENCHMARK_ARGS;
+}
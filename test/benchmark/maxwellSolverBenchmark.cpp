@@ -0,0 +1,82 @@
+/*
+ * This file is part of the PiCoPiC distribution (https://github.com/cosmonaut-ok/PiCoPiC).
+ * Copyright (c) 2020 Alexander Vynnyk.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "syntheticDomain.hpp"
+
+namespace {
+
+  void BM_calc_field_e(benchmark::State& state)
+  {
+    // field solver does not depend on particles amount
+    SyntheticDomain domain (state.range(0), 1);
+
+    for (auto _ : state)
+    {
+      domain.maxwell_solver->calc_field_e();
+      domain.maxwell_solver->calc_field_e_edge();
+    }
+
+    state.SetItemsProcessed(state.iterations()
+                            * domain.geometry.cell_amount[0]
+                            * domain.geometry.cell_amount[1]);
+  }
+
+  void BM_calc_field_h(benchmark::State& state)
+  {
+    // field solver does not depend on particles amount
+    SyntheticDomain domain (state.range(0), 1);
+
+    for (auto _ : state)
+      domain.maxwell_solver->calc_field_h();
+
+    state.SetItemsProcessed(state.iterations()
+                            * domain.geometry.cell_amount[0]
+                            * domain.geometry.cell_amount[1]);
+  }
+
+  // fields are interpolated to every particle position
+  void BM_get_field_e(benchmark::State& state)
+  {
+    SyntheticDomain domain (state.range(0), state.range(1));
+
+    for (auto _ : state)
+      for (auto ps = domain.species_p.begin(); ps != domain.species_p.end(); ++ps)
+        for (auto p = (**ps).particles.begin(); p != (**ps).particles.end(); ++p)
+          benchmark::DoNotOptimize(
+            domain.maxwell_solver->get_field_e(P_POS_R((**p)), P_POS_Z((**p))));
+
+    state.SetItemsProcessed(state.iterations() * domain.particles_amount());
+  }
+
+  void BM_get_field_h(benchmark::State& state)
+  {
+    SyntheticDomain domain (state.range(0), state.range(1));
+
+    for (auto _ : state)
+      for (auto ps = domain.species_p.begin(); ps != domain.species_p.end(); ++ps)
+        for (auto p = (**ps).particles.begin(); p != (**ps).particles.end(); ++p)
+          benchmark::DoNotOptimize(
+            domain.maxwell_solver->get_field_h(P_POS_R((**p)), P_POS_Z((**p))));
+
+    state.SetItemsProcessed(state.iterations() * domain.particles_amount());
+  }
+
+  BENCHMARK(BM_calc_field_e)->Arg(32)->Arg(64)->Arg(128)->Arg(256)->Unit(benchmark::kMicrosecond);
+  BENCHMARK(BM_calc_field_h)->Arg(32)->Arg(64)->Arg(128)->Arg(256)->Unit(benchmark::kMicrosecond);
+  BENCHMARK(BM_get_field_e)->BENCHMARK_ARGS;
+  BENCHMARK(BM_get_field_h)->BENCHMARK_ARGS;
+}
@@ -0,0 +1,64 @@
+/*
+ * This file is part of the PiCoPiC distribution (https://github.com/cosmonaut-ok/PiCoPiC).
+ * Copyright (c) 2020 Alexander Vynnyk.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "syntheticDomain.hpp"
+
+#include "outWriter.hpp"
+
+namespace {
+
+  // copy of the field slice to time-reduced (average) accumulator.
+  // Schedule is never reached, so nothing is written to data file
+  void BM_out_writer(benchmark::State& state, unsigned short shape,
+                     unsigned short space_reduce, unsigned int factor)
+  {
+    SyntheticDomain domain (state.range(0), 1);
+    short r_size = domain.geometry.cell_amount[0];
+    short z_size = domain.geometry.cell_amount[1];
+    vector<short> position;
+    size_t slice_size;
+
+    switch (shape)
+    {
+    case 0: // rectangle
+      position = {0, 0, r_size, z_size};
+      slice_size = r_size * z_size;
+      break;
+    case 1: // column
+      position = {0, 0, 0, (short)(z_size / 2)};
+      slice_size = r_size;
+      break;
+    default: // row
+      position = {0, 0, (short)(r_size / 2), 0};
+      slice_size = z_size;
+    }
+
+    OutWriter writer ("E_r", shape, position, {0, 0}, 65535, true, 0,
+                      &domain.time, &(domain.maxwell_solver->field_e[0]),
+                      1, 1, space_reduce, factor);
+
+    for (auto _ : state)
+      writer();
+
+    state.SetBytesProcessed(state.iterations() * slice_size * sizeof(double));
+  }
+
+  BENCHMARK_CAPTURE(BM_out_writer, rec, 0, 0, 1)->Arg(32)->Arg(64)->Arg(128)->Arg(256);
+  BENCHMARK_CAPTURE(BM_out_writer, rec_block_average, 0, 2, 4)->Arg(32)->Arg(64)->Arg(128)->Arg(256);
+  BENCHMARK_CAPTURE(BM_out_writer, col, 1, 0, 1)->Arg(32)->Arg(64)->Arg(128)->Arg(256);
+  BENCHMARK_CAPTURE(BM_out_writer, row, 2, 0, 1)->Arg(32)->Arg(64)->Arg(128)->Arg(256);
+}
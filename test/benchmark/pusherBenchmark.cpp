@@ -0,0 +1,63 @@
+/*
+ * This file is part of the PiCoPiC distribution (https://github.com/cosmonaut-ok/PiCoPiC).
+ * Copyright (c) 2020 Alexander Vynnyk.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "syntheticDomain.hpp"
+
+#include "pusher/pusherBoris.hpp"
+#include "pusher/pusherVay.hpp"
+#include "pusher/pusherHC.hpp"
+
+namespace {
+
+  template <class P>
+  void BM_pusher(benchmark::State& state)
+  {
+    SyntheticDomain domain (state.range(0), state.range(1));
+    P pusher (domain.maxwell_solver, domain.species_p, &domain.time);
+
+    for (auto _ : state)
+      pusher();
+
+    state.SetItemsProcessed(state.iterations() * domain.particles_amount());
+  }
+
+  BENCHMARK_TEMPLATE(BM_pusher, PusherBoris<MaxwellSolverYee, BORIS_CLASSIC>)->BENCHMARK_ARGS;
+  BENCHMARK_TEMPLATE(BM_pusher, PusherBoris<MaxwellSolverYee, BORIS_ADAPTIVE>)->BENCHMARK_ARGS;
+  BENCHMARK_TEMPLATE(BM_pusher, PusherBoris<MaxwellSolverYee, BORIS_RELATIVISTIC>)->BENCHMARK_ARGS;
+  BENCHMARK_TEMPLATE(BM_pusher, PusherVay<MaxwellSolverYee>)->BENCHMARK_ARGS;
+  BENCHMARK_TEMPLATE(BM_pusher, PusherHC<MaxwellSolverYee>)->BENCHMARK_ARGS;
+
+  void BM_mover(benchmark::State& state)
+  {
+    SyntheticDomain domain (state.range(0), state.range(1));
+
+    for (auto _ : state)
+      for (auto ps = domain.species_p.begin(); ps != domain.species_p.end(); ++ps)
+      {
+        (**ps).dump_position_to_old();
+        (**ps).mover_cylindrical();
+        (**ps).back_position_to_rz();
+        (**ps).reflect();
+        (**ps).back_velocity_to_rz();
+        (**ps).bind_cell_numbers();
+      }
+
+    state.SetItemsProcessed(state.iterations() * domain.particles_amount());
+  }
+
+  BENCHMARK(BM_mover)->BENCHMARK_ARGS;
+}
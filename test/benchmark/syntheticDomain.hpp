@@ -0,0 +1,112 @@
+/*
+ * This file is part of the PiCoPiC distribution (https://github.com/cosmonaut-ok/PiCoPiC).
+ * Copyright (c) 2020 Alexander Vynnyk.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _BENCHMARK_SYNTHETIC_DOMAIN_HPP_
+#define _BENCHMARK_SYNTHETIC_DOMAIN_HPP_
+
+#include <vector>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "defines.hpp"
+#include "geometry.hpp"
+#include "timeSim.hpp"
+#include "specieP.hpp"
+#include "current/currentVB.hpp"
+#include "maxwellSolver/maxwellSolverYee.hpp"
+
+//! domain sizes (radial cells; longitudinal is twice more)
+//! and particles per cell, used by all of the benchmarks
+#define BENCHMARK_ARGS \
+  ArgsProduct({{32, 64, 128}, {8, 32}})->Unit(benchmark::kMillisecond)
+
+#define BENCHMARK_CELL_SIZE 1e-4
+#define BENCHMARK_TIME_STEP 1e-13
+#define BENCHMARK_DENSITY 1e17
+
+//! Standalone simulation domain with electrons and ions,
+//! uniformly distributed in space with thermal velocities,
+//! nonzero fields and particles, moved for single step
+//! (so they have both, old and new positions for current deposition)
+class SyntheticDomain
+{
+public:
+  Geometry geometry;
+  TimeSim time;
+  std::vector<SpecieP *> species_p;
+  Current *current;
+  MaxwellSolverYee *maxwell_solver;
+
+  SyntheticDomain(size_t r_cells, size_t ppc)
+    : geometry ( { r_cells * BENCHMARK_CELL_SIZE, 2 * r_cells * BENCHMARK_CELL_SIZE },
+                 { 0, 0, r_cells, 2 * r_cells },
+                 { true, true, true, true } )
+  {
+    time.start = 0;
+    time.end = BENCHMARK_TIME_STEP * 1e6;
+    time.step = BENCHMARK_TIME_STEP;
+    time.current = BENCHMARK_TIME_STEP;
+    time.print_header_counter = 0;
+
+    unsigned int macro_amount = ppc * geometry.cell_amount[0] * geometry.cell_amount[1];
+
+    species_p.push_back(new SpecieP(0, "electrons", -1, 1, macro_amount,
+                                    BENCHMARK_DENSITY, BENCHMARK_DENSITY, 1,
+                                    &geometry, &time));
+    species_p.push_back(new SpecieP(1, "ions", 1, 1836, macro_amount,
+                                    BENCHMARK_DENSITY, BENCHMARK_DENSITY, 0.1,
+                                    &geometry, &time));
+
+    current = new CurrentVB(&geometry, &time, species_p);
+    maxwell_solver = new MaxwellSolverYee(&geometry, &time, species_p, current);
+
+    // weak, but nonzero fields
+    maxwell_solver->field_e = 1e3;
+    maxwell_solver->field_h = 1e1;
+
+    for (auto ps = species_p.begin(); ps != species_p.end(); ++ps)
+    {
+      (**ps).maxwell_solver = maxwell_solver;
+      (**ps).fullyfill_spatial_distribution();
+      (**ps).bind_cell_numbers();
+      (**ps).velocity_distribution();
+      (**ps).dump_position_to_old();
+      (**ps).mover_cylindrical();
+      (**ps).back_position_to_rz();
+      (**ps).bind_cell_numbers();
+    }
+  };
+
+  ~SyntheticDomain()
+  {
+    delete maxwell_solver;
+    delete current;
+    for (auto ps = species_p.begin(); ps != species_p.end(); ++ps)
+      delete *ps;
+  };
+
+  size_t particles_amount()
+  {
+    size_t amount = 0;
+    for (auto ps = species_p.begin(); ps != species_p.end(); ++ps)
+      amount += (**ps).particles.size();
+    return amount;
+  };
+};
+
+#endif // _BENCHMARK_SYNTHETIC_DOMAIN_HPP_
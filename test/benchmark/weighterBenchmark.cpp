@@ -0,0 +1,44 @@
+/*
+ * This file is part of the PiCoPiC distribution (https://github.com/cosmonaut-ok/PiCoPiC).
+ * Copyright (c) 2020 Alexander Vynnyk.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "syntheticDomain.hpp"
+
+#include "algo/weighter.hpp"
+
+namespace {
+
+  void BM_weight_cylindrical(benchmark::State& state)
+  {
+    SyntheticDomain domain (state.range(0), state.range(1));
+    Grid<double> grid (domain.geometry.cell_amount[0], domain.geometry.cell_amount[1], 2);
+
+    for (auto _ : state)
+    {
+      grid = 0;
+      for (auto ps = domain.species_p.begin(); ps != domain.species_p.end(); ++ps)
+        for (auto p = (**ps).particles.begin(); p != (**ps).particles.end(); ++p)
+          weight_cylindrical<double>(&domain.geometry, &grid,
+                                     P_POS_R((**p)), P_POS_Z((**p)),
+                                     P_WEIGHT((**p)));
+      benchmark::DoNotOptimize(grid(0, 0));
+    }
+
+    state.SetItemsProcessed(state.iterations() * domain.particles_amount());
+  }
+
+  BENCHMARK(BM_weight_cylindrical)->BENCHMARK_ARGS;
+}
@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+#include <complex>
+#include <random>
+#include <vector>
+#include "math/fft.hpp"
+
+namespace {
+#define FFT_TEST_SIZE 256
+
+  TEST(fft, is_power_of_2)
+  {
+    EXPECT_TRUE(math::fft::is_power_of_2(1));
+    EXPECT_TRUE(math::fft::is_power_of_2(2));
+    EXPECT_TRUE(math::fft::is_power_of_2(1024));
+    EXPECT_FALSE(math::fft::is_power_of_2(0));
+    EXPECT_FALSE(math::fft::is_power_of_2(3));
+    EXPECT_FALSE(math::fft::is_power_of_2(100));
+  }
+
+  TEST(fft, reject_non_power_of_2)
+  {
+    std::vector< std::complex<double> > data (100, 1.);
+
+    EXPECT_DEATH(math::fft::fft(data), "");
+  }
+
+  //! sum of |x|^2 is equal to sum of |X_k|^2 / N
+  TEST(fft, parseval)
+  {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> uni(-1, 1);
+
+    std::vector< std::complex<double> > data (FFT_TEST_SIZE);
+    for (auto d = data.begin(); d != data.end(); ++d)
+      (*d) = std::complex<double> (uni(gen), uni(gen));
+
+    double energy_t = 0;
+    for (auto d = data.begin(); d != data.end(); ++d)
+      energy_t += std::norm(*d);
+
+    math::fft::fft(data);
+
+    double energy_f = 0;
+    for (auto d = data.begin(); d != data.end(); ++d)
+      energy_f += std::norm(*d);
+
+    EXPECT_NEAR(energy_f / FFT_TEST_SIZE, energy_t, 1e-10 * energy_t);
+  }
+
+  TEST(fft, sine_peak)
+  {
+    unsigned int bin = 16;
+    std::vector<double> signal (FFT_TEST_SIZE);
+
+    for (size_t i = 0; i < signal.size(); ++i)
+      signal[i] = sin(2. * constant::PI * bin * i / FFT_TEST_SIZE);
+
+    std::vector<double> spectrum = math::fft::power_spectrum(signal);
+
+    ASSERT_EQ(spectrum.size(), FFT_TEST_SIZE / 2 + 1);
+
+    size_t peak = 0;
+    for (size_t k = 0; k < spectrum.size(); ++k)
+      if (spectrum[k] > spectrum[peak])
+        peak = k;
+
+    EXPECT_EQ(peak, bin);
+    // Hann window leaks to neighbour bins only
+    EXPECT_LT(spectrum[bin + 3], 1e-6 * spectrum[bin]);
+    EXPECT_LT(spectrum[bin - 3], 1e-6 * spectrum[bin]);
+  }
+}
@@ -1,6 +1,7 @@
 #define LOGURU_WITH_STREAMS 1
 
 #include <gtest/gtest.h>
+#include <vector>
 #include "algo/grid.hpp"
   
 namespace {
@@ -214,6 +215,37 @@ namespace {
       }
   }
 
+  TEST(grid, overlay_xy_different_sizes)
+  {
+    // diagonal neighbour domains could have different sizes
+    Grid<double> grid (6, 10, 2);
+    Grid<double> grid2 (12, 4, 2);
+    grid = 1;
+    grid.overlay_set(1);
+    grid2 = 2;
+    grid2.overlay_set(2);
+
+    // mark corners of overlay regions
+    grid.get_grid()[9][13] = 5;
+    grid2.get_grid()[0][0] = 7;
+
+    grid.overlay_xy(grid2);
+
+    double **g_grd = grid.get_grid();
+    double **g_grd2 = grid2.get_grid();
+
+    for (unsigned int i = 0; i < 2; ++i)
+      for (unsigned int j = 0; j < 2; ++j)
+      {
+        ASSERT_EQ(g_grd[6+i][10+j], g_grd2[i][j]);
+        ASSERT_EQ(g_grd[8+i][12+j], g_grd2[2+i][2+j]);
+      }
+
+    ASSERT_EQ(g_grd[6][10], 8);
+    ASSERT_EQ(g_grd2[3][3], 7);
+    ASSERT_EQ(g_grd[7][11], 3);
+  }
+
   TEST(grid, copy)
   {
     Grid<double> grid (10, 10, 3);
@@ -225,6 +257,104 @@ namespace {
     ASSERT_EQ(grid2(3, 4), VALUE);
   }
 
+  TEST(grid, zero)
+  {
+    Grid<double> grid (10, 12, 2);
+    grid = VALUE;
+    grid.overlay_set(VALUE * 2);
+
+    double **g_grd = grid.get_grid();
+
+    // overlay on all of the sides
+    for (unsigned int i = 0; i < 14; ++i)
+      for (unsigned int j = 0; j < 16; ++j)
+        if (i < 2 || j < 2 || i >= 12 || j >= 14)
+          ASSERT_EQ(g_grd[i][j], VALUE * 2);
+        else
+          ASSERT_EQ(g_grd[i][j], VALUE);
+
+    grid.zero();
+
+    for (unsigned int i = 0; i < 14; ++i)
+      for (unsigned int j = 0; j < 16; ++j)
+        ASSERT_EQ(g_grd[i][j], 0);
+  }
+
+  TEST(grid, zero_range)
+  {
+    Grid<double> grid (10, 12, 2);
+    grid = VALUE;
+    grid.overlay_set(VALUE);
+
+    // including overlay elements
+    grid.zero(-2, 3, 5, 13);
+
+    for (int i = -2; i < 12; ++i)
+      for (int j = -2; j < 14; ++j)
+        if (i <= 3 && j >= 5)
+          ASSERT_EQ(grid(i, j), 0);
+        else
+          ASSERT_EQ(grid(i, j), VALUE);
+  }
+
+  TEST(grid, overlay_x_range)
+  {
+    Grid<double> grid (10, 10, 2);
+    Grid<double> grid2 (10, 10, 2);
+    Grid<double> reference (10, 10, 2);
+    Grid<double> reference2 (10, 10, 2);
+
+    for (int i = -2; i < 12; ++i)
+      for (int j = -2; j < 12; ++j)
+      {
+        grid(i, j) = reference(i, j) = i + j;
+        grid2(i, j) = reference2(i, j) = i * j;
+      }
+
+    // range is clamped by overlay
+    grid.overlay_x(grid2, -2, 4);
+    grid.overlay_x(grid2, 5, 20);
+    reference.overlay_x(reference2);
+
+    for (int i = -2; i < 12; ++i)
+      for (int j = -2; j < 12; ++j)
+      {
+        ASSERT_EQ(grid(i, j), reference(i, j));
+        ASSERT_EQ(grid2(i, j), reference2(i, j));
+      }
+
+    // columns out of range are not overlaid
+    grid.overlay_x(grid2, 3, 3);
+    ASSERT_EQ(grid(8, 3), reference(8, 3) + reference2(-2, 3));
+    ASSERT_EQ(grid(8, 4), reference(8, 4));
+  }
+
+  TEST(grid, overlay_y_range)
+  {
+    Grid<double> grid (10, 10, 2);
+    Grid<double> grid2 (10, 10, 2);
+    Grid<double> reference (10, 10, 2);
+    Grid<double> reference2 (10, 10, 2);
+
+    for (int i = -2; i < 12; ++i)
+      for (int j = -2; j < 12; ++j)
+      {
+        grid(i, j) = reference(i, j) = i + j;
+        grid2(i, j) = reference2(i, j) = i * j;
+      }
+
+    grid.overlay_y(grid2, 0, 6);
+    grid.overlay_y(grid2, 7, 9);
+    reference.overlay_y(reference2);
+
+    for (int i = -2; i < 12; ++i)
+      for (int j = -2; j < 12; ++j)
+      {
+        ASSERT_EQ(grid(i, j), reference(i, j));
+        ASSERT_EQ(grid2(i, j), reference2(i, j));
+      }
+  }
+
   TEST(grid, _operator_parenthesis)
   {
     Grid<double> grid (10, 10, 3);
@@ -282,4 +412,81 @@ namespace {
       for (unsigned int j = 0; j < 10; ++j)
         ASSERT_DOUBLE_EQ(grid(i, j), 6.916666666666668);
   }
+
+  //! fill all of the elements, including overlay, with unique values
+  void fill_unique(Grid<double> &grid, double base)
+  {
+    double **g_grd = grid.get_grid();
+
+    for (unsigned int i = 0; i < grid.x_real_size; ++i)
+      for (unsigned int j = 0; j < grid.y_real_size; ++j)
+        g_grd[i][j] = base + 100 * i + j;
+  }
+
+  //! shift grid more, than ``y_reserve'' times (so rows are copied
+  //! back to the begining of allocation) and compare all of the elements,
+  //! including overlay, with reference, shifted element-by-element.
+  //! Odd shifts get column of next grid, even ones - cleared column
+  TEST(grid, shift_y)
+  {
+    unsigned int reserve = 3;
+    unsigned int shifts = 3 * reserve + 2;
+
+    Grid<double> grid (4, 6, 2);
+    Grid<double> next (4, 6, 2);
+    fill_unique(grid, 0.5);
+    fill_unique(next, 1000.5);
+
+    grid.reserve_shift_y(reserve);
+
+    unsigned int x_real = grid.x_real_size;
+    unsigned int y_real = grid.y_real_size;
+    std::vector< std::vector<double> > ref (x_real, std::vector<double> (y_real));
+
+    double **g_grd = grid.get_grid();
+    for (unsigned int i = 0; i < x_real; ++i)
+      for (unsigned int j = 0; j < y_real; ++j)
+        ref[i][j] = g_grd[i][j];
+
+    for (unsigned int s = 0; s < shifts; ++s)
+    {
+      double **n_grd = next.get_grid();
+
+      if (s % 2 == 1)
+      {
+        grid.copy_next_y(next);
+        for (unsigned int i = 0; i < x_real; ++i)
+          ref[i][y_real - grid.o_s] = n_grd[i][next.o_s];
+      }
+      else
+      {
+        grid.clear_next_y();
+        for (unsigned int i = 0; i < x_real; ++i)
+          ref[i][y_real - grid.o_s] = 0;
+      }
+
+      grid.shift_y();
+
+      for (unsigned int i = 0; i < x_real; ++i)
+      {
+        for (unsigned int j = 0; j < y_real - 1; ++j)
+          ref[i][j] = ref[i][j + 1];
+        ref[i][y_real - 1] = 0;
+      }
+
+      g_grd = grid.get_grid();
+      for (unsigned int i = 0; i < x_real; ++i)
+        for (unsigned int j = 0; j < y_real; ++j)
+          ASSERT_DOUBLE_EQ(g_grd[i][j], ref[i][j]) << "shift " << s << ", [" << i << "][" << j << "]";
+
+      // last overlay column is zeroed
+      for (unsigned int i = 0; i < x_real; ++i)
+        ASSERT_DOUBLE_EQ(g_grd[i][y_real - 1], 0);
+
+      // shifted in column is the last column of grid
+      for (unsigned int i = 0; i < grid.x_size; ++i)
+        ASSERT_DOUBLE_EQ(grid(i, grid.y_size - 1),
+                         s % 2 == 1 ? next(i, 0) : 0);
+    }
+  }
 }
@@ -0,0 +1,105 @@
+#define LOGURU_WITH_STREAMS 1
+
+#include <gtest/gtest.h>
+#include "specieP.hpp"
+
+namespace {
+#define GYRO_STEPS 20000
+#define GYRO_STEPS_PER_PERIOD 200
+#define CELL_SIZE 5.86e-4
+#define TIME_STEP 1e-12
+
+  //! state of particle in full double precision
+  struct reference_particle
+  {
+    double pos_r, pos_z;
+    double vel_r, vel_phi, vel_z;
+  };
+
+  //! non-relativistic boris rotation in magnetic field,
+  //! directed along phi (so particle gyrates in r-z plane),
+  //! followed by position update. Operations are the same for
+  //! reference and stored particle, as in pushers: load to double,
+  //! calculate, store back
+  template <class P>
+  void gyrate(P &p, double b_phi)
+  {
+    double v_r = p.vel_r;
+    double v_z = p.vel_z;
+
+    // u' = u + u x t; u+ = u + u' x s
+    double s = 2. * b_phi / (1. + b_phi * b_phi);
+    double u_r = v_r - v_z * b_phi;
+    double u_z = v_z + v_r * b_phi;
+
+    p.vel_r = v_r - u_z * s;
+    p.vel_z = v_z + u_r * s;
+
+    p.pos_r += p.vel_r * TIME_STEP;
+    p.pos_z += p.vel_z * TIME_STEP;
+  }
+
+  template <class P>
+  double energy(P &p)
+  {
+    double v_r = p.vel_r;
+    double v_phi = p.vel_phi;
+    double v_z = p.vel_z;
+
+    return v_r * v_r + v_phi * v_phi + v_z * v_z;
+  }
+
+  TEST(mixed_precision, coordinate_resolution)
+  {
+    // small displacements far from origin should not be lost
+    particle_coord pos = 0.14;
+    double pos_ref = 0.14;
+
+    for (unsigned int i = 0; i < 10000; ++i)
+    {
+      pos += 3.3e-9;
+      pos_ref += 3.3e-9;
+    }
+
+    ASSERT_NEAR((double)pos, pos_ref, 1e-9);
+
+    pos = -0.01;
+    ASSERT_NEAR((double)pos, -0.01, 1e-12);
+  }
+
+  TEST(mixed_precision, energy_conservation)
+  {
+    Particle p;
+    reference_particle p_ref;
+
+    p.pos_r = p_ref.pos_r = 0.02;
+    p.pos_z = p_ref.pos_z = 0.1;
+    p.vel_r = p_ref.vel_r = 1.3e6;
+    p.vel_phi = p_ref.vel_phi = 2.1e5;
+    p.vel_z = p_ref.vel_z = -7.7e5;
+
+    // phi-component of normalized magnetic field to get
+    // full gyration period in GYRO_STEPS_PER_PERIOD steps
+    double b_phi = tan(constant::PI / GYRO_STEPS_PER_PERIOD);
+
+    double energy_0 = energy(p_ref);
+
+    for (unsigned int i = 0; i < GYRO_STEPS; ++i)
+    {
+      gyrate(p, b_phi);
+      gyrate(p_ref, b_phi);
+    }
+
+    double drift = fabs(energy(p) / energy_0 - 1);
+    double drift_ref = fabs(energy(p_ref) / energy_0 - 1);
+
+    // boris rotation conserves energy in double up to rounding,
+    // single precision velocities give random walk of rounding errors
+    ASSERT_LT(drift_ref, 1e-12);
+    ASSERT_LT(drift, 1e-5);
+
+    // trajectory is not shifted for significant part of cell
+    ASSERT_NEAR((double)p.pos_r, p_ref.pos_r, 1e-3 * CELL_SIZE);
+    ASSERT_NEAR((double)p.pos_z, p_ref.pos_z, 1e-3 * CELL_SIZE);
+  }
+}
@@ -0,0 +1,237 @@
+#include <gtest/gtest.h>
+#include <random>
+#include "algo/push.hpp"
+#include "math/vector3d.hpp"
+#include "phys/rel.hpp"
+
+namespace {
+#define PUSH_TEST_PARTICLES 1000 // not multiple of batch size
+#define PUSH_TEST_FACTOR 1e-2 // charge_over_2mass_dt
+
+  typedef void (*push_kernel)(algo::push::Batch &, double);
+  typedef vector3d<double> (*reference_pusher)(vector3d<double>, vector3d<double>,
+                                               vector3d<double>, double);
+
+  void fill_random(algo::push::Batch &batch, std::mt19937 &gen, bool magnetic)
+  {
+    std::uniform_real_distribution<double> vel(-1e8, 1e8);
+    std::uniform_real_distribution<double> field(-1e5, 1e5);
+
+    batch.size = 0;
+
+    while (! batch.full())
+      batch.add(vel(gen), vel(gen), vel(gen),
+                field(gen), field(gen), field(gen),
+                magnetic ? field(gen) : 0, magnetic ? field(gen) : 0, magnetic ? field(gen) : 0);
+  }
+
+  //! Vay pusher, particle-by-particle, as it was before batches
+  //! (velocity representation). Used as reference for batch kernel
+  vector3d<double> vay_reference(vector3d<double> velocity, vector3d<double> e,
+                                 vector3d<double> b, double charge_over_2mass_dt)
+  {
+    vector3d<double> uplocity; // u prime
+    vector3d<double> psm; // pxsm, pysm, pzsm
+    double gamma, sq_vel, s, us2, alpha, B2;
+
+    sq_vel = velocity.length2();
+    gamma = phys::rel::lorenz_factor_unchecked(sq_vel);
+    velocity *= gamma;
+
+    // Part I: Computation of uprime
+    uplocity = velocity;
+    e *= 2. * charge_over_2mass_dt;
+    uplocity += e;
+
+    b *= charge_over_2mass_dt * constant::MAGN_CONST;
+
+    sq_vel = velocity.length2();
+    gamma = phys::rel::lorenz_factor_inv(sq_vel);
+
+    uplocity[0] += gamma * ( velocity[1] * b[2] - velocity[2] * b[1] );
+    uplocity[1] += gamma * ( velocity[2] * b[0] - velocity[0] * b[2] );
+    uplocity[2] += gamma * ( velocity[0] * b[1] - velocity[1] * b[0] );
+
+    alpha = 1. + uplocity.length2();
+    B2 = b.length2();
+
+    // Part II: Computation of Gamma^{i+1}
+    s = alpha - B2;
+    us2 = uplocity.dot(b);
+    us2 *= us2;
+
+    alpha = algo::simd::rsqrt( 0.5 * ( s + algo::simd::sqrt( s * s + 4. * ( B2 + us2 ) ) ) );
+
+    b *= alpha;
+
+    s = 1. / ( 1. + b.length2() );
+    alpha = uplocity.dot(b);
+
+    psm[0] = s * ( uplocity[0] + alpha*b[0] + b[2]*uplocity[1] - b[1]*uplocity[2] );
+    psm[1] = s * ( uplocity[1] + alpha*b[1] + b[0]*uplocity[2] - b[2]*uplocity[0] );
+    psm[2] = s * ( uplocity[2] + alpha*b[2] + b[1]*uplocity[0] - b[0]*uplocity[1] );
+
+    sq_vel = psm.length2();
+    gamma = phys::rel::lorenz_factor_inv(sq_vel);
+    psm *= gamma;
+
+    return psm;
+  }
+
+  //! Higuera-Cary pusher, particle-by-particle, as it was before
+  //! batches (velocity representation). Used as reference for batch kernel
+  vector3d<double> higuera_cary_reference(vector3d<double> velocity, vector3d<double> e,
+                                          vector3d<double> b, double charge_over_2mass_dt)
+  {
+    vector3d<double> psm, um, up, b2, b_cross;
+    double gamma, sq_vel, B2;
+
+    sq_vel = velocity.length2();
+    gamma = phys::rel::lorenz_factor_unchecked(sq_vel);
+    velocity *= gamma;
+
+    e *= charge_over_2mass_dt;
+    psm = e;
+
+    um = velocity;
+    um += psm;
+    double gfm2 = (1. + um.length2());
+
+    b *= charge_over_2mass_dt * constant::MAGN_CONST;
+    B2 = b.length2();
+
+    double s = gfm2 - B2;
+    double bu = b.dot(um);
+    gamma = algo::simd::rsqrt ( 0.5*( s +
+                                      algo::simd::sqrt ( s * s
+                                                         + 4.0 * ( B2 + bu * bu ) ) ) );
+
+    b *= gamma;
+    b2 = b;
+    b2 *= b;
+
+    b_cross[0] = b[0]*b[1];
+    b_cross[1] = b[1]*b[2];
+    b_cross[2] = b[2]*b[0];
+    double inv_det_B = 1.0/( 1.0+b2[0]+b2[1]+b2[0] );
+
+    up[0] = ( ( 1.0+b2[0]-b2[1]-b2[2] ) * um[0] + 2. * ( b_cross[0]+b[2] )
+              * um[1] + 2. * ( b_cross[2] - b[2] ) * um[2] ) * inv_det_B;
+    up[1] = ( 2. * ( b_cross[0]-b[2] ) * um[0] + ( 1. - b2[0]+b2[1]-b2[2] )
+              * um[1] + 2. * ( b_cross[1] + b[0] ) * um[2] ) * inv_det_B;
+    up[2] = ( 2. * ( b_cross[2] + b[1] ) * um[0] + 2. * ( b_cross[1] - b[0] )
+              * um[1] + ( 1. - b2[0]-b2[1]+b2[2] )* um[2] ) * inv_det_B;
+
+    psm += up;
+
+    sq_vel = psm.length2();
+    gamma = phys::rel::lorenz_factor_inv(sq_vel);
+    psm *= gamma;
+
+    return psm;
+  }
+
+  //! batch kernel (with velocity conversions) gives the same
+  //! velocities, as particle-by-particle reference pusher,
+  //! in electric and magnetic fields
+  void equals_reference(push_kernel kernel, reference_pusher reference)
+  {
+    std::mt19937 gen(42);
+
+    algo::push::Batch *batch = new algo::push::Batch;
+
+    for (unsigned int n = 0; n < PUSH_TEST_PARTICLES; n += PUSH_BATCH_SIZE)
+    {
+      fill_random(*batch, gen, true);
+      batch->size = std::min((size_t)PUSH_BATCH_SIZE, (size_t)(PUSH_TEST_PARTICLES - n));
+
+      algo::push::Batch *initial = new algo::push::Batch(*batch);
+
+      algo::push::velocity_to_momentum(*batch);
+      kernel(*batch, PUSH_TEST_FACTOR);
+      algo::push::momentum_to_velocity(*batch);
+
+      for (size_t p = 0; p < batch->size; ++p)
+      {
+        vector3d<double> velocity (initial->u[0][p], initial->u[1][p], initial->u[2][p]);
+        vector3d<double> e (initial->e[0][p], initial->e[1][p], initial->e[2][p]);
+        vector3d<double> b (initial->b[0][p], initial->b[1][p], initial->b[2][p]);
+
+        vector3d<double> expected = reference(velocity, e, b, PUSH_TEST_FACTOR);
+
+        for (unsigned int c = 0; c < 3; ++c)
+        {
+          ASSERT_NEAR(batch->u[c][p], expected[c], 1e-14 * constant::LIGHT_VEL);
+          ASSERT_LT(fabs(batch->u[c][p]), constant::LIGHT_VEL);
+        }
+      }
+
+      delete initial;
+    }
+
+    delete batch;
+  }
+
+  //! without magnetic field both pushers accelerate
+  //! momentum by electric field for whole time step
+  void electric_acceleration(push_kernel kernel)
+  {
+    std::mt19937 gen(42);
+
+    algo::push::Batch *batch = new algo::push::Batch;
+
+    fill_random(*batch, gen, false);
+    algo::push::Batch *initial = new algo::push::Batch(*batch);
+
+    kernel(*batch, PUSH_TEST_FACTOR);
+
+    for (size_t p = 0; p < batch->size; ++p)
+      for (unsigned int c = 0; c < 3; ++c)
+        ASSERT_NEAR(batch->u[c][p],
+                    initial->u[c][p] + 2 * PUSH_TEST_FACTOR * initial->e[c][p],
+                    1e-12 * constant::LIGHT_VEL);
+
+    delete initial;
+    delete batch;
+  }
+
+  TEST(push, momentum_conversion)
+  {
+    std::mt19937 gen(42);
+
+    algo::push::Batch *batch = new algo::push::Batch;
+
+    fill_random(*batch, gen, false);
+    algo::push::Batch *initial = new algo::push::Batch(*batch);
+
+    algo::push::velocity_to_momentum(*batch);
+    algo::push::momentum_to_velocity(*batch);
+
+    for (size_t p = 0; p < batch->size; ++p)
+      for (unsigned int c = 0; c < 3; ++c)
+        ASSERT_NEAR(batch->u[c][p], initial->u[c][p], 1e-14 * constant::LIGHT_VEL);
+
+    delete initial;
+    delete batch;
+  }
+
+  TEST(push, vay_equals_reference)
+  {
+    equals_reference(algo::push::vay, vay_reference);
+  }
+
+  TEST(push, higuera_cary_equals_reference)
+  {
+    equals_reference(algo::push::higuera_cary, higuera_cary_reference);
+  }
+
+  TEST(push, vay_electric_acceleration)
+  {
+    electric_acceleration(algo::push::vay);
+  }
+
+  TEST(push, higuera_cary_electric_acceleration)
+  {
+    electric_acceleration(algo::push::higuera_cary);
+  }
+}
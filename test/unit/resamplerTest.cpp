@@ -0,0 +1,190 @@
+#define LOGURU_WITH_STREAMS 1
+
+#include <gtest/gtest.h>
+#include <limits>
+#include "specieP.hpp"
+#include "algo/resampler.hpp"
+
+namespace {
+#define CELL_SIZE 5.86e-4
+#define CELL_PARTICLES 200
+
+  //! total weight, momentum and kinetic energy
+  //! of particles (relativistic, per unit mass)
+  struct moments
+  {
+    double weight;
+    double pos_r, pos_z;
+    double u_r, u_phi, u_z;
+    double u_abs; // magnitude of momenta, stored with particle_real precision
+    double kinetic;
+  };
+
+  moments calc_moments(std::vector<Particle*> &cell)
+  {
+    moments m = {0, 0, 0, 0, 0, 0, 0, 0};
+
+    for (auto p : cell)
+    {
+      double w = p->weight;
+      double v_r, v_phi, v_z;
+      particle_velocity(*p, v_r, v_phi, v_z);
+      double v_sq = v_r * v_r + v_phi * v_phi + v_z * v_z;
+      double gamma = 1. / sqrt(1. - v_sq / constant::LIGHT_VEL_POW_2);
+
+      m.weight += w;
+      m.pos_r += w * (double)p->pos_r;
+      m.pos_z += w * (double)p->pos_z;
+      m.u_r += w * gamma * v_r;
+      m.u_phi += w * gamma * v_phi;
+      m.u_z += w * gamma * v_z;
+      m.u_abs += w * gamma * sqrt(v_sq);
+      m.kinetic += w * (gamma - 1) * constant::LIGHT_VEL_POW_2;
+    }
+
+    return m;
+  }
+
+  //! fill cell [0, CELL_SIZE) x [0, CELL_SIZE) with particles
+  //! of random weights, thermal spread and directed velocity
+  void fill_cell(std::vector<Particle*> &cell, double directed_velocity)
+  {
+    srand(1);
+
+    for (unsigned int n = 0; n < CELL_PARTICLES; ++n)
+    {
+      Particle *p = new Particle();
+      p->pos_r = CELL_SIZE * (0.05 + 0.9 * rand() / RAND_MAX);
+      p->pos_z = CELL_SIZE * (0.05 + 0.9 * rand() / RAND_MAX);
+      double vel_r = 1e6 * (2. * rand() / RAND_MAX - 1);
+      double vel_phi = 1e6 * (2. * rand() / RAND_MAX - 1);
+      double vel_z = directed_velocity + 1e6 * (2. * rand() / RAND_MAX - 1);
+      set_particle_velocity(*p, vel_r, vel_phi, vel_z);
+      p->weight = 1e7 * (1. + rand() / RAND_MAX);
+      cell.push_back(p);
+    }
+  }
+
+  //! relative resolution of stored particles positions
+  //! in the cell (tiled coordinate has fixed absolute resolution)
+  double coord_precision()
+  {
+#ifdef ENABLE_MIXED_PRECISION
+    return TILED_COORD_TILE * std::numeric_limits<float>::epsilon() / CELL_SIZE;
+#else
+    return std::numeric_limits<particle_coord>::epsilon();
+#endif // ENABLE_MIXED_PRECISION
+  }
+
+  //! relative precision of stored particles velocities
+  double real_precision()
+  {
+    return std::numeric_limits<particle_real>::epsilon();
+  }
+
+  void assert_conserved(moments &before, moments &after)
+  {
+    double u_scale = fabs(before.u_r) + fabs(before.u_phi) + fabs(before.u_z);
+    double pos_tolerance = std::max(1e-12, 4 * coord_precision());
+    double u_tolerance = std::max(1e-12 * u_scale,
+                                  4 * real_precision() * before.u_abs);
+
+    ASSERT_NEAR(after.weight / before.weight, 1, 1e-12);
+    ASSERT_NEAR(after.pos_r / before.pos_r, 1, pos_tolerance);
+    ASSERT_NEAR(after.pos_z / before.pos_z, 1, pos_tolerance);
+    ASSERT_NEAR(after.u_r, before.u_r, u_tolerance);
+    ASSERT_NEAR(after.u_phi, before.u_phi, u_tolerance);
+    ASSERT_NEAR(after.u_z, before.u_z, u_tolerance);
+    ASSERT_NEAR(after.kinetic / before.kinetic, 1,
+                std::max(1e-9, 4 * real_precision()));
+  }
+
+  void clear_cell(std::vector<Particle*> &cell)
+  {
+    for (auto p : cell)
+      delete p;
+    cell.clear();
+  }
+
+  TEST(resampler, merge_conservation)
+  {
+    // non-relativistic and relativistic (beam-like) particles
+    double velocities[2] = {3e5, 2.8e8};
+
+    for (unsigned int v = 0; v < 2; ++v)
+    {
+      std::vector<Particle*> cell;
+      fill_cell(cell, velocities[v]);
+
+      moments before = calc_moments(cell);
+      algo::resampler::merge_cell(cell, 32);
+      moments after = calc_moments(cell);
+
+      ASSERT_LE(cell.size(), 40);
+      ASSERT_GE(cell.size(), 16);
+      assert_conserved(before, after);
+
+      for (auto p : cell)
+      {
+        ASSERT_GE((double)p->pos_r, 0);
+        ASSERT_LT((double)p->pos_r, CELL_SIZE);
+        ASSERT_GE((double)p->pos_z, 0);
+        ASSERT_LT((double)p->pos_z, CELL_SIZE);
+      }
+
+      clear_cell(cell);
+    }
+  }
+
+  TEST(resampler, merge_cold_group)
+  {
+    // all particles have the same velocity: merged ones keep it
+    std::vector<Particle*> cell;
+    fill_cell(cell, 0);
+
+    for (auto p : cell)
+      set_particle_velocity(*p, 1e5, 0, 2e6);
+
+    algo::resampler::merge_cell(cell, 8);
+
+    double vel_tolerance = std::max(1e-3, 4 * real_precision() * 2e6);
+
+    for (auto p : cell)
+    {
+      double vel_r, vel_phi, vel_z;
+      particle_velocity(*p, vel_r, vel_phi, vel_z);
+
+      ASSERT_NEAR(vel_r, 1e5, vel_tolerance);
+      ASSERT_NEAR(vel_phi, 0, vel_tolerance);
+      ASSERT_NEAR(vel_z, 2e6, vel_tolerance);
+    }
+
+    clear_cell(cell);
+  }
+
+  TEST(resampler, split_conservation)
+  {
+    std::vector<Particle*> cell;
+    fill_cell(cell, 1e6);
+
+    // keep few particles only
+    for (size_t n = 3; n < cell.size(); ++n)
+      delete cell[n];
+    cell.resize(3);
+
+    moments before = calc_moments(cell);
+    algo::resampler::split_cell(cell, 8, 0, CELL_SIZE);
+    moments after = calc_moments(cell);
+
+    ASSERT_EQ(cell.size(), 8);
+    assert_conserved(before, after);
+
+    for (auto p : cell)
+    {
+      ASSERT_GE((double)p->pos_z, 0);
+      ASSERT_LT((double)p->pos_z, CELL_SIZE);
+    }
+
+    clear_cell(cell);
+  }
+}
@@ -0,0 +1,140 @@
+#define LOGURU_WITH_STREAMS 1
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "specieP.hpp"
+#include "algo/grid.hpp"
+#include "algo/serialize.hpp"
+
+namespace {
+#define GRID_R 8
+#define GRID_Z 12
+#define GRID_OVERLAY 2
+#define GRIDS_AMOUNT 9 // 3 components of E, H and current
+#define PARTICLES_AMOUNT 100
+
+  void fill_grid(Grid<double> &grid, unsigned int seed)
+  {
+    double **g = grid.get_grid();
+    for (unsigned int i = 0; i < grid.x_real_size; ++i)
+      for (unsigned int j = 0; j < grid.y_real_size; ++j)
+        g[i][j] = seed * 1e3 + i * grid.y_real_size + j + 0.25;
+  }
+
+  void fill_particles(std::vector<Particle*> &particles)
+  {
+    srand(1);
+
+    for (unsigned int n = 0; n < PARTICLES_AMOUNT; ++n)
+    {
+      Particle *p = new Particle();
+      p->pos_r = 1e-3 * rand() / RAND_MAX;
+      p->pos_phi = 1e-3 * rand() / RAND_MAX;
+      p->pos_z = 2e-3 * rand() / RAND_MAX;
+      p->pos_old_r = 1e-3 * rand() / RAND_MAX;
+      p->pos_old_z = 2e-3 * rand() / RAND_MAX;
+      set_particle_velocity(*p, 1e6 * rand() / RAND_MAX,
+                            1e6 * rand() / RAND_MAX,
+                            1e6 * rand() / RAND_MAX);
+      p->weight = 1e7 * (1. + rand() / RAND_MAX);
+      p->sin = (double)rand() / RAND_MAX;
+      p->cell_r = n % GRID_R;
+      p->cell_z = n % GRID_Z;
+      p->mark = n;
+      p->specie_id = 1;
+      particles.push_back(p);
+    }
+  }
+
+  //! domain-like state: fields/currents and particles
+  //! are saved to buffer and restored to clean domain, as
+  //! checkpoint does. Restored state should be bitwise equal
+  TEST(serialize, round_trip)
+  {
+    std::vector< Grid<double> > grids, restored_grids;
+    for (unsigned int g = 0; g < GRIDS_AMOUNT; ++g)
+    {
+      grids.push_back(Grid<double> (GRID_R, GRID_Z, GRID_OVERLAY));
+      restored_grids.push_back(Grid<double> (GRID_R, GRID_Z, GRID_OVERLAY));
+    }
+
+    // grids, moved by window, are stored as visible (shifted) rows
+    for (unsigned int g = 0; g < GRIDS_AMOUNT; ++g)
+    {
+      grids[g].reserve_shift_y(2);
+      grids[g] = 0;
+      grids[g].shift_y();
+      fill_grid(grids[g], g);
+      restored_grids[g] = -1;
+    }
+
+    std::vector<Particle*> particles, restored_particles;
+    fill_particles(particles);
+    // some particles, distributed before restore
+    restored_particles.push_back(new Particle());
+
+    size_t size = sizeof(size_t) + algo::serialize::particles_size(particles);
+    for (unsigned int g = 0; g < GRIDS_AMOUNT; ++g)
+      size += algo::serialize::grid_size(grids[g]);
+
+    std::vector<char> buffer (size);
+
+    char *w_ptr = buffer.data();
+    for (unsigned int g = 0; g < GRIDS_AMOUNT; ++g)
+      algo::serialize::put_grid(w_ptr, grids[g]);
+    algo::serialize::put(w_ptr, particles.size());
+    algo::serialize::put_particles(w_ptr, particles);
+    ASSERT_EQ(w_ptr, buffer.data() + size);
+
+    const char *r_ptr = buffer.data();
+    size_t particles_amount;
+    for (unsigned int g = 0; g < GRIDS_AMOUNT; ++g)
+      algo::serialize::get_grid(r_ptr, restored_grids[g]);
+    algo::serialize::get(r_ptr, particles_amount);
+    algo::serialize::get_particles(r_ptr, restored_particles, particles_amount);
+    ASSERT_EQ(r_ptr, buffer.data() + size);
+
+    for (unsigned int g = 0; g < GRIDS_AMOUNT; ++g)
+    {
+      double **before = grids[g].get_grid();
+      double **after = restored_grids[g].get_grid();
+
+      for (unsigned int i = 0; i < grids[g].x_real_size; ++i)
+        for (unsigned int j = 0; j < grids[g].y_real_size; ++j)
+          ASSERT_EQ(after[i][j], before[i][j]) << "grid " << g << " at " << i << "," << j;
+    }
+
+    ASSERT_EQ(restored_particles.size(), particles.size());
+    for (size_t n = 0; n < particles.size(); ++n)
+    {
+      ASSERT_NE(restored_particles[n], particles[n]);
+      ASSERT_EQ(memcmp(restored_particles[n], particles[n], sizeof(Particle)), 0)
+        << "particle " << n;
+    }
+
+    for (auto p : particles)
+      delete p;
+    for (auto p : restored_particles)
+      delete p;
+  }
+
+  TEST(serialize, vector)
+  {
+    std::vector<double> values = {1.5, -2.25, 3e10};
+    std::vector<double> empty, restored = {7};
+
+    std::vector<char> buffer (algo::serialize::vector_size(values)
+                              + algo::serialize::vector_size(empty));
+
+    char *w_ptr = buffer.data();
+    algo::serialize::put_vector(w_ptr, values);
+    algo::serialize::put_vector(w_ptr, empty);
+
+    const char *r_ptr = buffer.data();
+    algo::serialize::get_vector(r_ptr, restored);
+    ASSERT_EQ(restored, values);
+    algo::serialize::get_vector(r_ptr, restored);
+    ASSERT_TRUE(restored.empty());
+    ASSERT_EQ(r_ptr, buffer.data() + buffer.size());
+  }
+}
@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include "algo/simd.hpp"
+
+namespace {
+#define SIMD_TEST_SIZE 100003 // not multiple of vector width
+#define SIMD_TEST_ULP 2.3e-16 // 1 ulp of double near 1 (relative)
+
+  //! logarithmically distributed arguments in [10^lo, 10^hi]
+  std::vector<double> log_range (double lo, double hi)
+  {
+    std::vector<double> x(SIMD_TEST_SIZE);
+
+    for (size_t i = 0; i < x.size(); ++i)
+      x[i] = pow(10., lo + (hi - lo) * i / (x.size() - 1));
+
+    return x;
+  }
+
+  std::vector<double> lin_range (double lo, double hi)
+  {
+    std::vector<double> x(SIMD_TEST_SIZE);
+
+    for (size_t i = 0; i < x.size(); ++i)
+      x[i] = lo + (hi - lo) * i / (x.size() - 1);
+
+    return x;
+  }
+
+  //! maximal relative error of value against reference
+  double rel_error (double value, double reference)
+  {
+    if (reference == 0)
+      return fabs(value);
+
+    return fabs(value / reference - 1);
+  }
+
+  TEST(simd, sqrt)
+  {
+    std::vector<double> x = log_range(-300, 300);
+    std::vector<double> y(x.size());
+
+    algo::simd::sqrt(x.data(), y.data(), x.size());
+
+    for (size_t i = 0; i < x.size(); ++i)
+    {
+      ASSERT_DOUBLE_EQ(y[i], sqrt(x[i]));
+      ASSERT_DOUBLE_EQ(algo::simd::sqrt(x[i]), sqrt(x[i]));
+    }
+  }
+
+  TEST(simd, rsqrt)
+  {
+    std::vector<double> x = log_range(-300, 300);
+    std::vector<double> y(x.size());
+
+    algo::simd::rsqrt(x.data(), y.data(), x.size());
+
+    for (size_t i = 0; i < x.size(); ++i)
+    {
+      double ref = 1. / sqrt(x[i]);
+      ASSERT_LT(rel_error(y[i], ref), 4 * SIMD_TEST_ULP) << "x = " << x[i];
+      ASSERT_LT(rel_error(algo::simd::rsqrt(x[i]), ref), 2 * SIMD_TEST_ULP);
+    }
+  }
+
+  TEST(simd, log)
+  {
+    std::vector<double> x = log_range(-300, 300);
+    std::vector<double> x_near_1 = lin_range(0.5, 2);
+    x.insert(x.end(), x_near_1.begin(), x_near_1.end());
+    x.push_back(1.);
+
+    std::vector<double> y(x.size());
+
+    algo::simd::log(x.data(), y.data(), x.size());
+
+    for (size_t i = 0; i < x.size(); ++i)
+    {
+      double ref = log(x[i]);
+      ASSERT_LT(rel_error(y[i], ref), 2 * SIMD_TEST_ULP) << "x = " << x[i];
+      ASSERT_LT(rel_error(algo::simd::log(x[i]), ref), 2 * SIMD_TEST_ULP);
+    }
+  }
+
+  TEST(simd, exp)
+  {
+    std::vector<double> x = lin_range(-708, 708.9);
+    std::vector<double> x_small = lin_range(-1, 1);
+    x.insert(x.end(), x_small.begin(), x_small.end());
+    x.push_back(0.);
+
+    std::vector<double> y(x.size());
+
+    algo::simd::exp(x.data(), y.data(), x.size());
+
+    for (size_t i = 0; i < x.size(); ++i)
+    {
+      double ref = exp(x[i]);
+      ASSERT_LT(rel_error(y[i], ref), 2 * SIMD_TEST_ULP) << "x = " << x[i];
+      ASSERT_LT(rel_error(algo::simd::exp(x[i]), ref), 2 * SIMD_TEST_ULP);
+    }
+
+    // out of range arguments are clamped, no infinities
+    ASSERT_FALSE(std::isinf(algo::simd::exp(1e4)));
+    ASSERT_GT(algo::simd::exp(-1e4), 0);
+  }
+
+  TEST(simd, in_place)
+  {
+    std::vector<double> x = lin_range(1, 100);
+    std::vector<double> y = x;
+
+    algo::simd::log(y.data(), y.data(), y.size());
+    algo::simd::exp(y.data(), y.data(), y.size());
+
+    for (size_t i = 0; i < x.size(); ++i)
+      ASSERT_LT(rel_error(y[i], x[i]), 1e-14);
+  }
+}
@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+#include "algo/tileMap.hpp"
+
+namespace {
+  TEST(tileMap, constructor)
+  {
+    TileMap tiles (30, 10, 2);
+
+    ASSERT_EQ(tiles.x_tiles, 3);
+    ASSERT_EQ(tiles.y_tiles, 1);
+    ASSERT_FALSE(tiles.touched());
+
+    for (unsigned int tx = 0; tx < tiles.x_tiles; ++tx)
+      for (unsigned int ty = 0; ty < tiles.y_tiles; ++ty)
+        ASSERT_FALSE(tiles.touched(tx, ty));
+  }
+
+  TEST(tileMap, ranges)
+  {
+    TileMap tiles (30, 10, 2);
+
+    // tiles are aligned to real (including overlay) elements
+    ASSERT_EQ(tiles.x_begin(0), -2);
+    ASSERT_EQ(tiles.x_end(0), 13);
+    ASSERT_EQ(tiles.x_begin(1), 14);
+    ASSERT_EQ(tiles.x_end(1), 29);
+    ASSERT_EQ(tiles.x_begin(2), 30);
+    ASSERT_EQ(tiles.x_end(2), 31);
+
+    ASSERT_EQ(tiles.y_begin(0), -2);
+    ASSERT_EQ(tiles.y_end(0), 11);
+  }
+
+  TEST(tileMap, touch)
+  {
+    TileMap tiles (40, 40, 2);
+
+    // crossing tiles border
+    tiles.touch(13, 14, 3, 4);
+
+    ASSERT_TRUE(tiles.touched());
+    ASSERT_TRUE(tiles.touched(0, 0));
+    ASSERT_TRUE(tiles.touched(1, 0));
+    ASSERT_FALSE(tiles.touched(0, 1));
+    ASSERT_FALSE(tiles.touched(2, 2));
+
+    // overlay elements
+    tiles.touch(-2, -1, 40, 41);
+    ASSERT_TRUE(tiles.touched(0, 2));
+
+    ASSERT_TRUE(tiles.touched(-2, 2, 20, 41));
+    ASSERT_FALSE(tiles.touched(30, 41, 0, 41));
+  }
+
+  TEST(tileMap, clear)
+  {
+    TileMap tiles (40, 40, 2);
+
+    tiles.touch_all();
+    ASSERT_TRUE(tiles.touched());
+    ASSERT_TRUE(tiles.touched(2, 2));
+
+    tiles.clear();
+    ASSERT_FALSE(tiles.touched());
+    for (unsigned int tx = 0; tx < tiles.x_tiles; ++tx)
+      for (unsigned int ty = 0; ty < tiles.y_tiles; ++ty)
+        ASSERT_FALSE(tiles.touched(tx, ty));
+  }
+}
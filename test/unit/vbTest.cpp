@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+#include "algo/vb.hpp"
+
+namespace {
+#define VB_TEST_CELLS 24
+#define VB_TEST_DR 1e-3
+#define VB_TEST_DZ 2e-3
+#define VB_TEST_DT 1e-12
+#define VB_TEST_PARTICLES 5000
+
+  struct move
+  {
+    double r_new, z_new, r_old, z_old, charge;
+    int i_n, k_n, i_o, k_o;
+  };
+
+  //! j_z and j_r grids
+  struct grids
+  {
+    std::vector<double> j_z;
+    std::vector<double> j_r;
+
+    grids () : j_z(VB_TEST_CELLS * VB_TEST_CELLS, 0),
+               j_r(VB_TEST_CELLS * VB_TEST_CELLS, 0) {};
+
+    void inc (int i, int k, const double *j)
+    {
+      j_z[i * VB_TEST_CELLS + k] += j[0];
+      j_z[(i + 1) * VB_TEST_CELLS + k] += j[1];
+      j_r[i * VB_TEST_CELLS + k] += j[2];
+      j_r[i * VB_TEST_CELLS + k + 1] += j[3];
+    }
+  };
+
+  //! random moves for not more, than one cell on every axis
+  std::vector<move> random_moves (double r_min)
+  {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> pos(0, 1);
+    std::uniform_real_distribution<double> shift(-0.9, 0.9);
+    std::vector<move> moves;
+
+    while (moves.size() < VB_TEST_PARTICLES)
+    {
+      move m;
+      m.r_old = r_min + (VB_TEST_CELLS - 4 - r_min / VB_TEST_DR) * VB_TEST_DR * pos(gen);
+      m.z_old = (1 + (VB_TEST_CELLS - 3) * pos(gen)) * VB_TEST_DZ;
+      m.r_new = m.r_old + shift(gen) * VB_TEST_DR;
+      m.z_new = m.z_old + shift(gen) * VB_TEST_DZ;
+      m.charge = 1e-15 * (1 + pos(gen));
+
+      if (m.r_new < r_min) continue;
+
+      m.i_n = (int)floor(m.r_new / VB_TEST_DR);
+      m.k_n = (int)floor(m.z_new / VB_TEST_DZ);
+      m.i_o = (int)floor(m.r_old / VB_TEST_DR);
+      m.k_o = (int)floor(m.z_old / VB_TEST_DZ);
+
+      moves.push_back(m);
+    }
+
+    return moves;
+  }
+
+  //! weight single particle segment by segment with scalar calls
+  void reference_weighting (const move &m, grids &g)
+  {
+    algo::vb::Segments *s = new algo::vb::Segments;
+
+    algo::vb::split(m.r_new, m.z_new, m.r_old, m.z_old,
+                    m.i_n, m.k_n, m.i_o, m.k_o,
+                    VB_TEST_DR, VB_TEST_DZ, m.charge, *s);
+
+    for (size_t n = 0; n < s->size; ++n)
+    {
+      double j[4];
+      algo::vb::segment_currents(s->r_new[n], s->z_new[n], s->r_old[n], s->z_old[n],
+                                 s->i[n], s->k[n], s->charge[n],
+                                 VB_TEST_DR, VB_TEST_DZ, VB_TEST_DT,
+                                 j[0], j[1], j[2], j[3]);
+      g.inc(s->i[n], s->k[n], j);
+    }
+
+    delete s;
+  }
+
+  //! weight all particles with batches
+  void batch_weighting (const std::vector<move> &moves, grids &g)
+  {
+    algo::vb::Segments *s = new algo::vb::Segments;
+    algo::vb::Currents *c = new algo::vb::Currents;
+
+    auto flush = [&] () {
+      algo::vb::currents(*s, VB_TEST_DR, VB_TEST_DZ, VB_TEST_DT, *c);
+
+      for (size_t n = 0; n < s->size; ++n)
+      {
+        double j[4] = {c->j_z_0[n], c->j_z_1[n], c->j_r_0[n], c->j_r_1[n]};
+        g.inc(s->i[n], s->k[n], j);
+      }
+
+      s->size = 0;
+    };
+
+    for (auto m = moves.begin(); m != moves.end(); ++m)
+    {
+      algo::vb::split(m->r_new, m->z_new, m->r_old, m->z_old,
+                      m->i_n, m->k_n, m->i_o, m->k_o,
+                      VB_TEST_DR, VB_TEST_DZ, m->charge, *s);
+
+      if (s->full())
+        flush();
+    }
+    flush();
+
+    delete s;
+    delete c;
+  }
+
+  TEST(vb, batch_equals_reference)
+  {
+    // including particles near and inside axis cell
+    std::vector<move> moves = random_moves(0.1 * VB_TEST_DR);
+    grids reference, batch;
+
+    for (auto m = moves.begin(); m != moves.end(); ++m)
+      reference_weighting(*m, reference);
+
+    batch_weighting(moves, batch);
+
+    for (size_t n = 0; n < reference.j_z.size(); ++n)
+    {
+      ASSERT_EQ(batch.j_z[n], reference.j_z[n]);
+      ASSERT_EQ(batch.j_r[n], reference.j_r[n]);
+    }
+  }
+
+  TEST(vb, charge_conservation)
+  {
+    // VB scheme provides, that charge, moved through the cells
+    // boundaries, is sum of r-weighted j_z of all of the nodes:
+    // sum(i * j_z[i][k]) = q * delta_z / (2 pi dr^2 dz dt)
+    std::vector<move> moves = random_moves(1.5 * VB_TEST_DR);
+
+    for (auto m = moves.begin(); m != moves.end(); ++m)
+    {
+      grids g;
+      reference_weighting(*m, g);
+
+      double moment = 0;
+      for (int i = 0; i < VB_TEST_CELLS; ++i)
+        for (int k = 0; k < VB_TEST_CELLS; ++k)
+          moment += i * g.j_z[i * VB_TEST_CELLS + k];
+
+      double expected = m->charge * (m->z_new - m->z_old)
+        / (2. * constant::PI * VB_TEST_DR * VB_TEST_DR * VB_TEST_DZ * VB_TEST_DT);
+
+      ASSERT_NEAR(moment, expected, 1e-13 * fabs(expected));
+    }
+  }
+}
@@ -0,0 +1,86 @@
+#define LOGURU_WITH_STREAMS 1
+
+#include <gtest/gtest.h>
+#include "algo/weighter.hpp"
+
+namespace {
+#define R_CELLS 16
+#define Z_CELLS 32
+#define MOMENTS 3
+
+  Geometry geometry_for_weighting()
+  {
+    Geometry geometry ({0.1, 0.2}, {0, 0, R_CELLS, Z_CELLS},
+                       {0, 0, 0, 0}, {0, 0},
+                       {true, true, true, true});
+    return geometry;
+  }
+
+  TEST(weighter, charge_conservation)
+  {
+    Geometry geometry = geometry_for_weighting();
+    Grid<double> grid (R_CELLS, Z_CELLS, 2);
+    grid = 0;
+    grid.overlay_set(0);
+
+    // particles near axis, in the first cell and far from axis
+    double pos_r[3] = {0.002, 0.009, 0.05};
+    double pos_z[3] = {0.013, 0.1, 0.17};
+
+    for (unsigned int p = 0; p < 3; ++p)
+    {
+      unsigned int r_i_shift, z_k_shift;
+      double factors[4];
+
+      weight_cylindrical_factors<double>(&geometry, pos_r[p], pos_z[p],
+                                         r_i_shift, z_k_shift, factors);
+
+      // sum of weighted values multiplied to cells volumes
+      // should be equal to weighted value
+      double dr = geometry.cell_size[0];
+      double dz = geometry.cell_size[1];
+      double v_1 = r_i_shift == 0 ? CYL_VOL(dz, dr) : CELL_VOLUME(r_i_shift, dr, dz);
+      double v_2 = CELL_VOLUME(r_i_shift + 1, dr, dz);
+      double sum = (factors[0] + factors[2]) * v_1 + (factors[1] + factors[3]) * v_2;
+
+      ASSERT_NEAR(sum, 1., 1e-12);
+    }
+  }
+
+  TEST(weighter, moments)
+  {
+    Geometry geometry = geometry_for_weighting();
+    Grid<double> grids[MOMENTS];
+
+    for (unsigned int m = 0; m < MOMENTS; ++m)
+    {
+      grids[m] = Grid<double> (R_CELLS, Z_CELLS, 2);
+      grids[m] = 0;
+      grids[m].overlay_set(0);
+    }
+
+    unsigned int x_real_size = grids[0].x_real_size;
+    unsigned int y_real_size = grids[0].y_real_size;
+    vector<double> moments (x_real_size * y_real_size * MOMENTS, 0);
+
+    for (unsigned int p = 0; p < 100; ++p)
+    {
+      double pos_r = 0.0999 * p / 100.;
+      double pos_z = 0.1999 * (100 - p) / 100.;
+      double values[MOMENTS] = {1e10, -3.5 * p, 42.};
+
+      for (unsigned int m = 0; m < MOMENTS; ++m)
+        weight_cylindrical<double>(&geometry, &grids[m], pos_r, pos_z, values[m]);
+
+      weight_cylindrical_moments<double, MOMENTS>(&geometry, moments.data(),
+                                                  y_real_size, 2,
+                                                  pos_r, pos_z, values);
+    }
+
+    for (unsigned int m = 0; m < MOMENTS; ++m)
+      for (unsigned int i = 0; i < x_real_size; ++i)
+        for (unsigned int j = 0; j < y_real_size; ++j)
+          ASSERT_DOUBLE_EQ(grids[m].get_grid()[i][j],
+                           moments[(i * y_real_size + j) * MOMENTS + m]);
+  }
+}
@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+#include "algo/zigzag.hpp"
+
+namespace {
+#define ZIGZAG_TEST_DR 1e-3
+#define ZIGZAG_TEST_DZ 2e-3
+#define ZIGZAG_TEST_DT 1e-12
+#define ZIGZAG_TEST_CELLS 32
+#define ZIGZAG_TEST_PARTICLES 1000 // not multiple of batch size
+
+  TEST(zigzag, relay_point)
+  {
+    double dx = 0.5;
+
+    // the same cell: middle point
+    ASSERT_DOUBLE_EQ(algo::zigzag::relay_point(2, 2, 1.1, 1.3, dx), 1.2);
+    // neighbour cells: common border, independently of direction
+    ASSERT_DOUBLE_EQ(algo::zigzag::relay_point(2, 3, 1.4, 1.6, dx), 1.5);
+    ASSERT_DOUBLE_EQ(algo::zigzag::relay_point(2, 3, 1.2, 1.6, dx), 1.5);
+    ASSERT_DOUBLE_EQ(algo::zigzag::relay_point(3, 2, 1.9, 1.45, dx), 1.5);
+  }
+
+  TEST(zigzag, batch_equals_single)
+  {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> pos(0, 1);
+    std::uniform_real_distribution<double> shift(-0.9, 0.9);
+
+    std::vector<double> inv_volume;
+    for (int i = 0; i < ZIGZAG_TEST_CELLS; ++i)
+      inv_volume.push_back(1 / (CELL_VOLUME(i, ZIGZAG_TEST_DR, ZIGZAG_TEST_DZ)));
+
+    algo::zigzag::Batch *batch = new algo::zigzag::Batch;
+    algo::zigzag::Batch *single = new algo::zigzag::Batch;
+
+    for (unsigned int n = 0; n < ZIGZAG_TEST_PARTICLES; ++n)
+    {
+      double r_old = (1 + (ZIGZAG_TEST_CELLS - 3) * pos(gen)) * ZIGZAG_TEST_DR;
+      double z_old = (1 + (ZIGZAG_TEST_CELLS - 3) * pos(gen)) * ZIGZAG_TEST_DZ;
+      double r_new = r_old + shift(gen) * ZIGZAG_TEST_DR;
+      double z_new = z_old + shift(gen) * ZIGZAG_TEST_DZ;
+
+      batch->add(r_old, z_old, r_new, z_new,
+                 CELL_NUMBER(r_new, ZIGZAG_TEST_DR), CELL_NUMBER(z_new, ZIGZAG_TEST_DZ),
+                 1e-15, 1e5 * shift(gen));
+
+      if (! batch->full() && n != ZIGZAG_TEST_PARTICLES - 1)
+        continue;
+
+      algo::zigzag::currents(*batch, ZIGZAG_TEST_DR, ZIGZAG_TEST_DZ, ZIGZAG_TEST_DT,
+                             inv_volume.data(), 0);
+
+      // every particle separately
+      for (size_t p = 0; p < batch->size; ++p)
+      {
+        single->size = 0;
+        single->add(batch->r_old[p], batch->z_old[p], batch->r_new[p], batch->z_new[p],
+                    batch->i_n[p], batch->k_n[p], batch->charge[p], batch->vel_phi[p]);
+
+        algo::zigzag::currents(*single, ZIGZAG_TEST_DR, ZIGZAG_TEST_DZ, ZIGZAG_TEST_DT,
+                               inv_volume.data(), 0);
+
+        ASSERT_EQ(single->i_o[0], CELL_NUMBER(batch->r_old[p], ZIGZAG_TEST_DR));
+        ASSERT_EQ(single->k_o[0], CELL_NUMBER(batch->z_old[p], ZIGZAG_TEST_DZ));
+        ASSERT_EQ(batch->i_o[p], single->i_o[0]);
+        ASSERT_EQ(batch->k_o[p], single->k_o[0]);
+
+        for (unsigned int c = 0; c < 4; ++c)
+        {
+          ASSERT_DOUBLE_EQ(batch->j_r[c][p], single->j_r[c][0]);
+          ASSERT_DOUBLE_EQ(batch->j_phi[c][p], single->j_phi[c][0]);
+          ASSERT_DOUBLE_EQ(batch->j_z[c][p], single->j_z[c][0]);
+        }
+      }
+
+      batch->size = 0;
+    }
+
+    delete batch;
+    delete single;
+  }
+
+  //! sub-cycled particle is moved once per ``push_every'' steps,
+  //! so radial and longitudinal currents are weighted only at push
+  //! step, but azimuthal current is weighted at every step. So
+  //! time-averaged azimuthal current is the same, as for particle,
+  //! pushed every step, and time-averaged j_r and j_z are reduced
+  TEST(zigzag, sub_cycled_currents)
+  {
+    unsigned int push_every = 4;
+
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> pos(0, 1);
+    std::uniform_real_distribution<double> shift(-0.9, 0.9);
+
+    std::vector<double> inv_volume;
+    for (int i = 0; i < ZIGZAG_TEST_CELLS; ++i)
+      inv_volume.push_back(1 / (CELL_VOLUME(i, ZIGZAG_TEST_DR, ZIGZAG_TEST_DZ)));
+
+    algo::zigzag::Batch *batch = new algo::zigzag::Batch;
+
+    while (! batch->full())
+    {
+      double r_old = (1 + (ZIGZAG_TEST_CELLS - 3) * pos(gen)) * ZIGZAG_TEST_DR;
+      double z_old = (1 + (ZIGZAG_TEST_CELLS - 3) * pos(gen)) * ZIGZAG_TEST_DZ;
+      double r_new = r_old + shift(gen) * ZIGZAG_TEST_DR;
+      double z_new = z_old + shift(gen) * ZIGZAG_TEST_DZ;
+
+      batch->add(r_old, z_old, r_new, z_new,
+                 CELL_NUMBER(r_new, ZIGZAG_TEST_DR), CELL_NUMBER(z_new, ZIGZAG_TEST_DZ),
+                 1e-15, 1e5 * shift(gen));
+    }
+
+    // currents of particle, pushed every step
+    algo::zigzag::Batch *every = new algo::zigzag::Batch(*batch);
+    algo::zigzag::currents(*every, ZIGZAG_TEST_DR, ZIGZAG_TEST_DZ, ZIGZAG_TEST_DT,
+                           inv_volume.data(), 0);
+
+    std::vector<double> j_r (4 * ZIGZAG_BATCH_SIZE, 0);
+    std::vector<double> j_phi (4 * ZIGZAG_BATCH_SIZE, 0);
+    std::vector<double> j_z (4 * ZIGZAG_BATCH_SIZE, 0);
+
+    // particles are not moved between push steps
+    for (unsigned int step = 0; step < push_every; ++step)
+    {
+      bool push_step = step == 0;
+
+      algo::zigzag::currents(*batch, ZIGZAG_TEST_DR, ZIGZAG_TEST_DZ, ZIGZAG_TEST_DT,
+                             inv_volume.data(), 0, push_step);
+
+      for (size_t p = 0; p < batch->size; ++p)
+        for (unsigned int c = 0; c < 4; ++c)
+        {
+          if (! push_step)
+          {
+            ASSERT_EQ(batch->j_r[c][p], 0);
+            ASSERT_EQ(batch->j_z[c][p], 0);
+          }
+
+          j_r[c * ZIGZAG_BATCH_SIZE + p] += batch->j_r[c][p];
+          j_phi[c * ZIGZAG_BATCH_SIZE + p] += batch->j_phi[c][p];
+          j_z[c * ZIGZAG_BATCH_SIZE + p] += batch->j_z[c][p];
+        }
+    }
+
+    for (size_t p = 0; p < batch->size; ++p)
+      for (unsigned int c = 0; c < 4; ++c)
+      {
+        ASSERT_DOUBLE_EQ(j_phi[c * ZIGZAG_BATCH_SIZE + p] / push_every, every->j_phi[c][p]);
+        ASSERT_DOUBLE_EQ(j_r[c * ZIGZAG_BATCH_SIZE + p] / push_every,
+                         every->j_r[c][p] / push_every);
+        ASSERT_DOUBLE_EQ(j_z[c * ZIGZAG_BATCH_SIZE + p] / push_every,
+                         every->j_z[c][p] / push_every);
+      }
+
+    delete every;
+    delete batch;
+  }
+}